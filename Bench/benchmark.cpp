@@ -0,0 +1,152 @@
+// Load cost of luaopen_luibexwin on fresh states: wall time, Lua heap growth
+// and the overhead of calling a binding. Budgets given on the command line
+// turn a regression into a non zero exit code. Built as luibexwin_loadbench
+// on other platforms, where only the Lua side of the module is real.
+//   luibexwin_bench [--runs N] [--calls N] [--max-open-us N] [--max-heap N] [--max-call-ns N]
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include <lua.hpp>
+
+extern "C" int luaopen_luibexwin(lua_State* L);
+
+struct HeapCounter
+{
+    size_t bytes = 0;
+    size_t allocations = 0;
+};
+static void* countingAlloc(void* ud, void* ptr, size_t osize, size_t nsize)
+{
+    HeapCounter* heap = (HeapCounter*)ud;
+    // osize is a type tag when ptr is NULL.
+    size_t old = ptr ? osize : 0;
+    if (nsize == 0)
+    {
+        heap->bytes -= old;
+        free(ptr);
+        return nullptr;
+    }
+    void* p = realloc(ptr, nsize);
+    if (!p)
+        return nullptr;
+    heap->bytes += nsize - old;
+    ++heap->allocations;
+    return p;
+}
+static double nowMicros()
+{
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+static double median(std::vector<double> v)
+{
+    std::sort(v.begin(), v.end());
+    return v[v.size() / 2];
+}
+static int emptyFunction(lua_State* L)
+{
+    lua_pushinteger(L, luaL_checkinteger(L, 1));
+    return 1;
+}
+static void check(lua_State* L, int status)
+{
+    if (status != LUA_OK)
+    {
+        fprintf(stderr, "lua error: %s\n", lua_tostring(L, -1));
+        exit(2);
+    }
+}
+// Nanoseconds per iteration of the loop function returned by setup.
+static double timeLoop(lua_State* L, const char* setup, int calls)
+{
+    check(L, luaL_loadstring(L, setup));
+    check(L, lua_pcall(L, 0, 1, 0));
+    lua_pushinteger(L, calls);
+    double start = nowMicros();
+    check(L, lua_pcall(L, 1, 0, 0));
+    return (nowMicros() - start) * 1000.0 / calls;
+}
+
+int main(int argc, char** argv)
+{
+    int runs = 50, calls = 2000000;
+    double maxOpenUs = 0, maxHeap = 0, maxCallNs = 0;
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        double v = atof(argv[i + 1]);
+        if (!strcmp(argv[i], "--runs"))
+            runs = std::max(1, (int)v);
+        else if (!strcmp(argv[i], "--calls"))
+            calls = std::max(1, (int)v);
+        else if (!strcmp(argv[i], "--max-open-us"))
+            maxOpenUs = v;
+        else if (!strcmp(argv[i], "--max-heap"))
+            maxHeap = v;
+        else if (!strcmp(argv[i], "--max-call-ns"))
+            maxCallNs = v;
+    }
+
+    std::vector<double> openUs, fullUs;
+    size_t openHeap = 0, openAllocs = 0, fullHeap = 0;
+    for (int r = 0; r < runs; ++r)
+    {
+        HeapCounter heap;
+        lua_State* L = lua_newstate(countingAlloc, &heap);
+        luaL_openlibs(L);
+        size_t base = heap.bytes, baseAllocs = heap.allocations;
+
+        double start = nowMicros();
+        luaL_requiref(L, "luibexwin", luaopen_luibexwin, 0);
+        openUs.push_back(nowMicros() - start);
+        openHeap = heap.bytes - base;
+        openAllocs = heap.allocations - baseAllocs;
+
+        // Touch every submodule, the cost a script pays when it uses all of them.
+        start = nowMicros();
+        check(L, luaL_dostring(L,
+            "local m = require'luibexwin'\n"
+            "for _, n in ipairs{'window','message','render','pixel','memory','process',"
+            "'input','shell','system','async','profiler','constants'} do local _ = m[n] end"));
+        fullUs.push_back(nowMicros() - start + openUs.back());
+        fullHeap = heap.bytes - base;
+        lua_close(L);
+    }
+
+    HeapCounter heap;
+    lua_State* L = lua_newstate(countingAlloc, &heap);
+    luaL_openlibs(L);
+    luaL_requiref(L, "luibexwin", luaopen_luibexwin, 1);
+    lua_pop(L, 1);
+    lua_register(L, "EmptyFunction", emptyFunction);
+    double baseNs = timeLoop(L, "local f = EmptyFunction return function(n) for i = 1, n do f(i) end end", calls);
+    double localNs = timeLoop(L, "local f = luibexwin.system.LOWORD return function(n) for i = 1, n do f(i) end end", calls);
+    double fieldNs = timeLoop(L, "local m = luibexwin return function(n) for i = 1, n do m.system.LOWORD(i) end end", calls);
+    lua_close(L);
+
+    double open = median(openUs), callNs = localNs - baseNs;
+    printf("luaopen_luibexwin     %10.2f us (median of %d)\n", open, runs);
+    printf("heap after luaopen    %10zu bytes in %zu allocations\n", openHeap, openAllocs);
+    printf("all submodules loaded %10.2f us, %zu bytes\n", median(fullUs), fullHeap);
+    printf("binding call          %10.2f ns, %.2f ns over an empty C function\n", localNs, callNs);
+    printf("binding via module    %10.2f ns\n", fieldNs);
+
+    bool failed = false;
+    if (maxOpenUs > 0 && open > maxOpenUs)
+    {
+        fprintf(stderr, "luaopen took %.2f us, budget %.2f us\n", open, maxOpenUs);
+        failed = true;
+    }
+    if (maxHeap > 0 && openHeap > maxHeap)
+    {
+        fprintf(stderr, "luaopen allocated %zu bytes, budget %.0f bytes\n", openHeap, maxHeap);
+        failed = true;
+    }
+    if (maxCallNs > 0 && callNs > maxCallNs)
+    {
+        fprintf(stderr, "binding call overhead %.2f ns, budget %.2f ns\n", callNs, maxCallNs);
+        failed = true;
+    }
+    return failed ? 1 : 0;
+}
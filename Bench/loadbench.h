@@ -0,0 +1,22 @@
+#pragma once
+// Forced header of luibexwin_loadbench, the Lua side of luaopen_luibexwin
+// (module table, constant tables, InjectGlobals) built without Win32.
+// Constants get placeholder values, the load cost only depends on their
+// names and how many there are.
+#include <array>
+#include <algorithm>
+#include <string>
+#include <string_view>
+#include <cstdint>
+#include <lua.hpp>
+#include <windows.h>
+#include "globalhelpers.h"
+#undef REGIMACRO
+#undef REGUMACRO
+#undef REGISTERINH
+#define REGIMACRO(N) { #N, (lua_Integer)__COUNTER__, nullptr },
+#define REGUMACRO(T, v) { #v, 0, [](lua_State* L) { lua_pushlightuserdata(L, nullptr); } },
+#define REGISTERINH(name) Lua_Function(name);
+#include "constants.h"
+#include "module.h"
+#include "windowsfuncs.h"
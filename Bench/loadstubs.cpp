@@ -0,0 +1,10 @@
+// The bindings of windowsfuncs.h for luibexwin_loadbench. Each one returns
+// nothing, enough to build the submodules and time a call through them. They
+// are weak so the real ones of module.cpp and constants.cpp are kept.
+#include <string>
+#include <lua.hpp>
+#include <windows.h>
+#include "globalhelpers.h"
+#undef REGISTERINH
+#define REGISTERINH(name) __attribute__((weak)) Lua_Function(name) { return 0; }
+#include "windowsfuncs.h"
@@ -0,0 +1,43 @@
+// Throughput of the native kernels behind RasterBenchmark,
+// PixelSearchBenchmark and ImageCodecBenchmark, without Lua or Win32 so any
+// CI can run it. A budget
+// given on the command line turns a result below it into a non zero exit code.
+//   luibexwin_portable_bench [--width N] [--height N] [--iterations N] [--threads N] [--min-mps X]
+
+int main(int argc, char** argv)
+{
+    int width = 1024, height = 1024, iterations = 10;
+    int threads = (int)std::max(1u, std::thread::hardware_concurrency());
+    double minMps = 0;
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        double v = atof(argv[i + 1]);
+        if (!strcmp(argv[i], "--width"))
+            width = std::max(32, (int)v);
+        else if (!strcmp(argv[i], "--height"))
+            height = std::max(32, (int)v);
+        else if (!strcmp(argv[i], "--iterations"))
+            iterations = std::max(1, (int)v);
+        else if (!strcmp(argv[i], "--threads"))
+            threads = std::max(1, (int)v);
+        else if (!strcmp(argv[i], "--min-mps"))
+            minMps = v;
+    }
+
+    bool failed = false;
+    auto report = [&](const char* group, const std::string& name, double mps) {
+        printf("%-8s %-24s %12.1f MP/s\n", group, name.c_str(), mps);
+        if (!(mps >= minMps))
+        {
+            fprintf(stderr, "%s %s ran at %.1f MP/s, budget %.1f MP/s\n", group, name.c_str(), mps, minMps);
+            failed = true;
+        }
+    };
+    for (const RasterTiming& t : rasterBenchmark(width, height, iterations))
+        report(rasterLevelName(t.level), t.kernel, t.megapixelsPerSecond);
+    for (const PixelSearchTiming& t : pixelSearchBenchmark(width, height, threads, iterations))
+        report("search", t.name + " x" + std::to_string(t.threads), t.megapixelsPerSecond);
+    for (const ImageCodecTiming& t : imageCodecBenchmark(width, height, iterations))
+        report("codec", t.name, t.megapixelsPerSecond);
+    return failed ? 1 : 0;
+}
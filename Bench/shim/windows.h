@@ -0,0 +1,15 @@
+#pragma once
+// Just enough of <windows.h> for globalhelpers.h and Src/constantlists.cpp
+// on other platforms, see Bench/loadbench.h.
+#define WINVER 0x0A00
+#define __declspec(x)
+typedef struct tagRECT
+{
+    long left, top, right, bottom;
+} RECT, *LPRECT;
+typedef struct _SECURITY_ATTRIBUTES
+{
+    unsigned long nLength;
+    void* lpSecurityDescriptor;
+    int bInheritHandle;
+} SECURITY_ATTRIBUTES;
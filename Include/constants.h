@@ -0,0 +1,218 @@
+#pragma once
+// Integer and handle constants compiled into static tables. Nothing is pushed
+// when the module opens, a global is created the first time a script reads
+// it. Each table is indexed by a perfect hash built at compile time, and
+// families such as WM_* get a value to name map for tracing.
+struct LuaConstant
+{
+    const char* name;
+    lua_Integer value;
+    void (*push)(lua_State* L);
+};
+struct LuaConstantName
+{
+    lua_Integer value;
+    const char* name;
+};
+// entries are sorted by name without duplicates, a name hashing to bucket b
+// lives in entries[slots[luaConstantSlot(hash, seeds[b], count)]].
+struct LuaConstantTable
+{
+    const LuaConstant* entries;
+    size_t count;
+    const uint32_t* seeds;
+    size_t buckets;
+    const uint16_t* slots;
+};
+// names are sorted by value, an alias keeps the name listed first.
+struct LuaConstantFamily
+{
+    const char* prefix;
+    const LuaConstantName* names;
+    size_t count;
+};
+
+constexpr uint64_t luaConstantHash(std::string_view name)
+{
+    uint64_t h = 14695981039346656037ull;
+    for (char c : name)
+    {
+        h ^= (uint8_t)c;
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+constexpr size_t luaConstantSlot(uint64_t hash, uint32_t seed, size_t count)
+{
+    // Second hash from a splitmix64 finalizer, a new one per seed. Stepping
+    // f1 + seed * f2 instead never separates two names whose f1 and f2 agree
+    // modulo count, and the seed search would not end.
+    uint64_t z = hash + (seed + 1ull) * 0x9E3779B97F4A7C15ull;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    z ^= z >> 31;
+    return (size_t)(z % count);
+}
+// The only entry a name with that hash can be, callers compare the names.
+constexpr const LuaConstant& luaConstantCandidate(const LuaConstantTable& table, uint64_t hash)
+{
+    uint32_t seed = table.seeds[hash % table.buckets];
+    return table.entries[table.slots[luaConstantSlot(hash, seed, table.count)]];
+}
+constexpr bool luaConstantLess(const LuaConstant& a, const LuaConstant& b)
+{
+    return std::string_view(a.name) < std::string_view(b.name);
+}
+template<size_t M>
+constexpr size_t uniqueLuaConstantCount(const std::array<LuaConstant, M>& list)
+{
+    std::array<LuaConstant, M> sorted = list;
+    std::sort(sorted.begin(), sorted.end(), luaConstantLess);
+    size_t count = 0;
+    for (size_t i = 0; i < M; ++i)
+        if (i == 0 || luaConstantLess(sorted[i - 1], sorted[i]))
+            ++count;
+    return count;
+}
+
+template<size_t N>
+struct LuaConstantData
+{
+    static constexpr size_t BUCKETS = (N + 3) / 4;
+    std::array<LuaConstant, N> entries{};
+    std::array<uint32_t, BUCKETS> seeds{};
+    std::array<uint16_t, N> slots{};
+    constexpr LuaConstantTable table() const
+    {
+        return { entries.data(), N, seeds.data(), BUCKETS, slots.data() };
+    }
+};
+// Hash and displace: buckets are placed largest first, each one trying seeds
+// until all of its names land on free slots.
+template<size_t N, size_t M>
+constexpr LuaConstantData<N> buildLuaConstants(const std::array<LuaConstant, M>& list)
+{
+    static_assert(N < 65536, "constant table too large");
+    LuaConstantData<N> data;
+    std::array<LuaConstant, M> sorted = list;
+    std::sort(sorted.begin(), sorted.end(), luaConstantLess);
+    size_t count = 0;
+    for (size_t i = 0; i < M; ++i)
+        if (i == 0 || luaConstantLess(sorted[i - 1], sorted[i]))
+            data.entries[count++] = sorted[i];
+
+    constexpr size_t B = LuaConstantData<N>::BUCKETS;
+    std::array<uint64_t, N> hashes{};
+    std::array<size_t, B> sizes{};
+    for (size_t i = 0; i < N; ++i)
+    {
+        hashes[i] = luaConstantHash(data.entries[i].name);
+        ++sizes[hashes[i] % B];
+    }
+    std::array<size_t, B> order{};
+    for (size_t b = 0; b < B; ++b)
+        order[b] = b;
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) { return sizes[a] > sizes[b]; });
+    std::array<bool, N> used{};
+    std::array<size_t, N> members{};
+    std::array<size_t, N> taken{};
+    for (size_t b : order)
+    {
+        size_t n = 0;
+        for (size_t i = 0; i < N; ++i)
+            if (hashes[i] % B == b)
+                members[n++] = i;
+        if (n == 0)
+            continue;
+        for (uint32_t seed = 0;; ++seed)
+        {
+            bool fits = true;
+            for (size_t j = 0; j < n && fits; ++j)
+            {
+                taken[j] = luaConstantSlot(hashes[members[j]], seed, N);
+                fits = !used[taken[j]];
+                for (size_t k = 0; k < j && fits; ++k)
+                    fits = taken[k] != taken[j];
+            }
+            if (!fits)
+                continue;
+            for (size_t j = 0; j < n; ++j)
+            {
+                used[taken[j]] = true;
+                data.slots[taken[j]] = (uint16_t)members[j];
+            }
+            data.seeds[b] = seed;
+            break;
+        }
+    }
+    return data;
+}
+
+constexpr bool luaConstantInFamily(const LuaConstant& c, std::string_view prefix)
+{
+    return !c.push && std::string_view(c.name).starts_with(prefix);
+}
+template<size_t M>
+constexpr std::array<size_t, M> luaConstantFamilyOrder(const std::array<LuaConstant, M>& list)
+{
+    std::array<size_t, M> order{};
+    for (size_t i = 0; i < M; ++i)
+        order[i] = i;
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        return list[a].value != list[b].value ? list[a].value < list[b].value : a < b;
+    });
+    return order;
+}
+template<size_t M>
+constexpr size_t luaConstantFamilyCount(const std::array<LuaConstant, M>& list, std::string_view prefix)
+{
+    std::array<size_t, M> order = luaConstantFamilyOrder(list);
+    size_t count = 0;
+    bool any = false;
+    lua_Integer last = 0;
+    for (size_t i : order)
+        if (luaConstantInFamily(list[i], prefix) && (!any || list[i].value != last))
+        {
+            ++count;
+            any = true;
+            last = list[i].value;
+        }
+    return count;
+}
+template<size_t N, size_t M>
+constexpr std::array<LuaConstantName, N> buildLuaConstantNames(const std::array<LuaConstant, M>& list, std::string_view prefix)
+{
+    std::array<LuaConstantName, N> names{};
+    std::array<size_t, M> order = luaConstantFamilyOrder(list);
+    size_t count = 0;
+    for (size_t i : order)
+        if (luaConstantInFamily(list[i], prefix) && (count == 0 || list[i].value != names[count - 1].value))
+            names[count++] = { list[i].value, list[i].name };
+    return names;
+}
+
+extern const LuaConstantTable brush_constants;
+extern const LuaConstantTable commcontrol_constants;
+extern const LuaConstantTable cursor_constants;
+extern const LuaConstantTable errors_constants;
+extern const LuaConstantTable explorerutills_constants;
+extern const LuaConstantTable filesystem_constants;
+extern const LuaConstantTable commonwinutils_constants;
+extern const LuaConstantTable icon_constants;
+extern const LuaConstantTable vkeys_constants;
+extern const LuaConstantTable render_constants;
+extern const LuaConstantTable sound_constants;
+extern const LuaConstantTable style_constants;
+extern const LuaConstantTable wm_constants;
+extern const LuaConstantTable winmemory_constants;
+
+extern const LuaConstantFamily wm_family;
+extern const LuaConstantFamily vk_family;
+extern const LuaConstantFamily cs_family;
+extern const LuaConstantFamily src_family;
+
+const LuaConstant* findLuaConstant(std::string_view name);
+void pushLuaConstant(lua_State* L, const LuaConstant& c);
+// Name of value in the family with that prefix, families without a reverse
+// map are searched linearly. NULL when nothing matches.
+const char* luaConstantName(std::string_view prefix, lua_Integer value);
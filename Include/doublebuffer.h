@@ -0,0 +1,6 @@
+#pragma once
+// Windows opted in with EnableDoubleBuffer paint into a persistent back
+// buffer. BeginPaint/EndPaint go through these hooks for every window.
+HDC doubleBufferBeginPaint(HWND hwnd, LPPAINTSTRUCT ps);
+BOOL doubleBufferEndPaint(HWND hwnd, LPPAINTSTRUCT ps);
+void doubleBufferInvalidate(HWND hwnd, const RECT* rect);
@@ -0,0 +1,16 @@
+#pragma once
+// Shared GDI objects keyed by their creation parameters. Each acquire adds a
+// reference, objects without references stay around until evicted (LRU).
+enum GdiCacheType
+{
+    GDICACHE_BRUSH,
+    GDICACHE_PEN,
+    GDICACHE_FONT,
+    GDICACHE_TYPES
+};
+HBRUSH gdiCacheSolidBrush(COLORREF color);
+// Drops one reference, false when the handle is not owned by the cache.
+bool gdiCacheRelease(HGDIOBJ handle);
+bool gdiCacheOwns(HGDIOBJ handle);
+// Removes handle from the cache without deleting it, false when not cached.
+bool gdiCacheForget(HGDIOBJ handle);
@@ -8,16 +8,29 @@
 })(L, idx)                                                        
 #define pushWindowStruct(L,clazz, val) lua_pushlightuserdata(L, val)
 #define INIT_LUAOPEN() extern "C" __declspec(dllexport) int luaopen_luibexwin(lua_State* L){
-#define END_LUAOPEN() return 0;}
+#define END_LUAOPEN() return 1;}
 #define REGSTRUCT(T) registerNewStruct(L, ##T##);
 #define REGVALUEMACRO(name,type) (lua_push##type(L, ##name##), lua_setglobal(L, #name));
-#define REGIMACRO(N) REGVALUEMACRO(##N##, integer)
 #define REGSMACRO(S) REGVALUEMACRO(##S##, string)
-#define REGUMACRO(T, v) (pushWindowStruct(L,##T##,##v##), lua_setglobal(L, #v));
-#define INIT_WPR() luaL_Reg winapi_reg[] = {
+// Constant lists, see constants.h. Handle values are not constant
+// expressions so they are pushed by a function instead.
+#define INIT_CONSTANTS(name) static constexpr auto name##_list = std::to_array<LuaConstant>({
+#define REGIMACRO(N) { #N, (lua_Integer)(N), nullptr },
+#define REGUMACRO(T, v) { #v, 0, [](lua_State* L) { pushWindowStruct(L, T, v); } },
+#define END_CONSTANTS(name) }); \
+    static constexpr auto name##_data = buildLuaConstants<uniqueLuaConstantCount(name##_list)>(name##_list); \
+    extern const LuaConstantTable name = name##_data.table();
+// Value to name map for the constants of list starting with prefix.
+#define CONSTANT_FAMILY(list, family, prefix) \
+    static constexpr auto family##_names = buildLuaConstantNames<luaConstantFamilyCount(list##_list, prefix)>(list##_list, prefix); \
+    extern const LuaConstantFamily family = { prefix, family##_names.data(), family##_names.size() };
+// Function lists of the submodules returned by require"luibexwin", see module.cpp.
+#define INIT_SUBMODULE(name) static const luaL_Reg name##_reg[] = {
 #define ADD2WPR(name) {#name, ll_##name},
-#define END_WPR() {NULL,NULL}};REGISTER_WPR()
-#define REGISTER_WPR() (lua_pushglobaltable(L),luaL_setfuncs(L, winapi_reg, 0));
+#define END_SUBMODULE() {NULL,NULL}};
+#define INIT_MODULES() extern const LuaSubmodule luibexwin_submodules[] = {
+#define ADD2MODULES(name) {#name, name##_reg},
+#define END_MODULES() {NULL,NULL}};
 #define REGISTERINH(name) Lua_Function(##name##);
 #define luaL_checkuserdata(L, idx) \
     (luaL_checktype(L, idx, LUA_TUSERDATA), lua_touserdata(L, idx))
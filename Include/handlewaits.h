@@ -0,0 +1,83 @@
+#pragma once
+// Handles watched by one-shot waits of a backend, so their number is not
+// bound by MAXIMUM_WAIT_OBJECTS and nothing polls. A fired wait only pushes
+// its entry on a lock-free stack and, when no wake is pending, has the
+// backend wake the owning thread; draining and everything else happens on
+// that thread, during its alertable waits. The core here only depends on the
+// standard library, the thread pool backend is in threadpoolwaits.cpp.
+struct HandleWaits;
+struct HandleWait
+{
+    HandleWaits* owner = nullptr;
+    // Duplicate owned by the entry, closing the caller's handle is harmless.
+    HANDLE handle = NULL;
+    // The backend's registration.
+    HANDLE wait = NULL;
+    DWORD timeout = INFINITE;
+    uintptr_t cookie = 0;
+    // Written by handleWaitFired before the push.
+    bool timedOut = false;
+    bool queued = false;
+    bool closed = false;
+    HandleWait* next = nullptr;
+};
+// Shared by the HandleWaits and its queued wake, which may only run after it
+// was closed and then finds owner cleared.
+struct HandleWake
+{
+    std::mutex lock;
+    HandleWaits* owner = nullptr;
+};
+struct HandleWaitBackend
+{
+    virtual ~HandleWaitBackend() = default;
+    // Records the calling thread as the owner of w.
+    virtual bool openOwner(HandleWaits* w) = 0;
+    virtual void closeOwner(HandleWaits* w) = 0;
+    virtual bool duplicate(HandleWait* e, HANDLE h) = 0;
+    virtual void closeDuplicate(HandleWait* e) = 0;
+    // One-shot wait calling handleWaitFired(e, timedOut) on any thread.
+    virtual bool arm(HandleWait* e) = 0;
+    // Blocks until a running handleWaitFired for e returned.
+    virtual void disarm(HandleWait* e) = 0;
+    // Has runHandleWake(wake) called on the owner during one of its
+    // alertable waits.
+    virtual void queueWake(HandleWaits* w, std::shared_ptr<HandleWake> wake) = 0;
+};
+// Waits of the Win32 thread pool, woken through APCs.
+HandleWaitBackend* threadPoolWaitBackend();
+struct HandleWaits
+{
+    std::atomic<HandleWait*> fired = nullptr;
+    std::atomic<bool> wakeQueued = false;
+    // Set while open.
+    HandleWaitBackend* backend = nullptr;
+    HANDLE thread = NULL;
+    // Runs in the wake, on the owning thread. May be NULL when the owner
+    // drains before each of its waits anyway.
+    void (*onWake)(void* param) = nullptr;
+    void* wakeParam = nullptr;
+    std::shared_ptr<HandleWake> wake;
+    // Closed while queued, freed by the next drain.
+    std::vector<std::unique_ptr<HandleWait>> retired;
+};
+// The calling thread becomes the owner. Sets the last error on failure.
+bool openHandleWaits(HandleWaits* w, HandleWaitBackend* backend, void (*onWake)(void*), void* wakeParam);
+// Every entry must be closed first. Does not wait: a wake still queued is
+// cancelled and runs as a no-op, on any thread the owner may be closed from.
+void closeHandleWaits(HandleWaits* w);
+// Duplicates h and arms a wait for it, NULL with the last error set when h
+// cannot be waited on.
+std::unique_ptr<HandleWait> openHandleWait(HandleWaits* w, HANDLE h, DWORD timeout, uintptr_t cookie);
+// Arms a drained entry again.
+bool armHandleWait(HandleWait* e);
+// Unregisters and closes the duplicate. Blocks until a running callback
+// returned, which only takes as long as its push and queueWake.
+void closeHandleWait(HandleWaits* w, std::unique_ptr<HandleWait> e);
+// Appends what fired since the last drain, oldest first. Those entries are
+// disarmed until armHandleWait.
+void drainHandleWaits(HandleWaits* w, std::vector<HandleWait*>& out);
+bool handleWaitsPending(const HandleWaits* w);
+// Backend side: a wait fired or timed out, and a queued wake runs.
+void handleWaitFired(HandleWait* e, bool timedOut);
+void runHandleWake(const std::shared_ptr<HandleWake>& wake);
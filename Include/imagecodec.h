@@ -0,0 +1,86 @@
+#pragma once
+// Streaming BMP, QOI and uncompressed TGA decoders plus BMP and QOI
+// encoders. Only depends on the standard library, rows are delivered as
+// 0xAARRGGBB with straight alpha.
+enum ImageFormat
+{
+    IMAGE_UNKNOWN,
+    IMAGE_BMP,
+    IMAGE_QOI,
+    IMAGE_TGA
+};
+// Buffered input from memory or a FILE*.
+struct ImageReader
+{
+    ImageReader(const void* data, size_t size);
+    explicit ImageReader(FILE* file);
+    bool read(void* dst, size_t n);
+    bool skip(size_t n);
+    // Makes up to n bytes available without consuming them, returns how many are.
+    size_t peek(const uint8_t** data, size_t n);
+    int byte()
+    {
+        if (pos < end || refill())
+            return *pos++;
+        return -1;
+    }
+    // Bytes consumed so far.
+    size_t offset() const { return consumed - (size_t)(end - pos); }
+private:
+    bool refill(size_t want = 1);
+    FILE* file = nullptr;
+    std::vector<uint8_t> buffer;
+    const uint8_t* pos = nullptr;
+    const uint8_t* end = nullptr;
+    size_t consumed = 0;
+};
+// Buffered output into memory or a FILE*.
+struct ImageWriter
+{
+    ImageWriter() = default;
+    explicit ImageWriter(FILE* file) : file(file) {}
+    void write(const void* src, size_t n);
+    void byte(uint8_t b)
+    {
+        buffer.push_back(b);
+        if (file && buffer.size() >= (1 << 16))
+            flush();
+    }
+    bool flush();
+    // Everything written when there is no file.
+    std::vector<uint8_t> buffer;
+private:
+    FILE* file = nullptr;
+    bool failed = false;
+};
+
+struct ImageInfo
+{
+    ImageFormat format;
+    int width;
+    int height;
+};
+// begin sees the header before any row, row receives each of the height rows
+// once with its top-down y, in file order. Returning false from either stops
+// the decode.
+struct ImageSink
+{
+    std::function<bool(const ImageInfo& info)> begin;
+    std::function<bool(int y, const uint32_t* row)> row;
+};
+#define IMAGE_MAX_PIXELS ((int64_t)1 << 28)
+// TGA has no signature, it is assumed when the header is plausible.
+ImageFormat imageDetectFormat(const uint8_t* head, size_t size);
+// Returns NULL on success or a message describing why the decode stopped.
+const char* imageDecode(ImageReader& in, ImageSink& sink);
+const char* imageEncode(ImageWriter& out, const PixelView& v, ImageFormat format);
+ImageFormat imageFormatFromName(const char* name);
+const char* imageFormatName(ImageFormat format);
+
+struct ImageCodecTiming
+{
+    std::string name;
+    double megapixelsPerSecond;
+    size_t bytes;
+};
+std::vector<ImageCodecTiming> imageCodecBenchmark(int width, int height, int iterations);
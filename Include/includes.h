@@ -1,5 +1,10 @@
 #pragma once
 #include <vector>
+#include <array>
+#include <algorithm>
+#include <deque>
+#include <list>
+#include <map>
 #include <unordered_map>
 #include <memory>
 #include <string>
@@ -7,12 +12,40 @@
 #include <stdexcept>
 #include <utility>
 #include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <thread>
+#include <chrono>
 #include <variant>
+#include <bit>
+#include <cstdio>
+#include <cmath>
 #include <lua.hpp>
 #include <windows.h>
+#include <tlhelp32.h>
+#include <intrin.h>
 #include <CommCtrl.h>
 #include <commdlg.h>
 #include <shlobj.h>
 #include <format>
 #include "globalhelpers.h"
+#include "luaobject.h"
+#include "constants.h"
+#include "module.h"
+#include "timerwheel.h"
+#include "handlewaits.h"
+#include "schedulerwaits.h"
+#include "scheduler.h"
+#include "spawn.h"
+#include "pixelview.h"
+#include "pixelbuffer.h"
+#include "rasterkernels.h"
+#include "pixelsearch.h"
+#include "imagecodec.h"
+#include "peexports.h"
+#include "procsignature.h"
+#include "doublebuffer.h"
+#include "gdicache.h"
+#include "intarray.h"
+#include "textmeasure.h"
 #include "windowsfuncs.h"
\ No newline at end of file
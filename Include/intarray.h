@@ -0,0 +1,11 @@
+#pragma once
+// Fixed size array of integers in one userdata. Indexing from Lua is 1 based,
+// pointer() exposes the contiguous lua_Integer storage.
+#define INTARRAYNAME "luibexwin.IntArray"
+struct IntArray
+{
+    size_t count;
+    lua_Integer values[1];
+};
+IntArray* newIntArray(lua_State* L, size_t count);
+IntArray* checkIntArray(lua_State* L, int idx);
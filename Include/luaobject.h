@@ -0,0 +1,45 @@
+#pragma once
+// Full userdata holding a C++ object, with a lazily created metatable.
+template<typename T>
+int luaobject_gc(lua_State* L)
+{
+    T* obj = (T*)lua_touserdata(L, 1);
+    obj->~T();
+    return 0;
+}
+template<typename T, typename... Args>
+T* newLuaObject(lua_State* L, const char* tname, const luaL_Reg* methods, const luaL_Reg* metamethods, Args&&... args)
+{
+    T* obj = (T*)lua_newuserdata(L, sizeof(T));
+    new (obj) T(std::forward<Args>(args)...);
+    if (luaL_newmetatable(L, tname))
+    {
+        lua_pushcfunction(L, luaobject_gc<T>);
+        lua_setfield(L, -2, "__gc");
+        if (methods)
+        {
+            lua_newtable(L);
+            luaL_setfuncs(L, methods, 0);
+            lua_setfield(L, -2, "__index");
+        }
+        if (metamethods)
+            luaL_setfuncs(L, metamethods, 0);
+    }
+    lua_setmetatable(L, -2);
+    return obj;
+}
+#define luaL_checkobject(L, idx, T, tname) ((T*)luaL_checkudata(L, idx, tname))
+// Per lua_State singleton kept in the registry, keyed by a per-type address.
+template<typename T>
+T* getRegistryObject(lua_State* L, const char* tname)
+{
+    static const char key = 0;
+    lua_rawgetp(L, LUA_REGISTRYINDEX, &key);
+    T* obj = (T*)luaL_testudata(L, -1, tname);
+    lua_pop(L, 1);
+    if (obj)
+        return obj;
+    obj = newLuaObject<T>(L, tname, nullptr, nullptr);
+    lua_rawsetp(L, LUA_REGISTRYINDEX, &key);
+    return obj;
+}
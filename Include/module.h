@@ -0,0 +1,11 @@
+#pragma once
+// The table returned by require"luibexwin" and the submodules behind it.
+struct LuaSubmodule
+{
+    const char* name;
+    const luaL_Reg* funcs;
+};
+extern const LuaSubmodule luibexwin_submodules[];
+void push_module(lua_State* L);
+void push_constants_table(lua_State* L);
+void register_constants(lua_State* L);
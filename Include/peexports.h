@@ -0,0 +1,61 @@
+#pragma once
+// Export directory of a PE32 or PE32+ image read once into a hash index of
+// name to export. Only depends on the standard library, the image is reached
+// through a read callback so the same parser serves the current process,
+// another process and files on disk.
+struct PeSource
+{
+    // Copies size bytes at offset, false when they cannot be read. Offsets
+    // are RVAs for a loaded image and file offsets otherwise.
+    std::function<bool(uint64_t offset, void* dst, size_t size)> read;
+    bool mapped = true;
+};
+struct PeExport
+{
+    uint32_t rva = 0;
+    uint32_t ordinal = 0;
+    // Offsets into PeExports::strings, NO_STRING when absent. name is the
+    // first of the names of this export.
+    uint32_t name = NO_STRING;
+    uint32_t forwarder = NO_STRING;
+    static constexpr uint32_t NO_STRING = UINT32_MAX;
+};
+// One entry of the name table. Several names may share an export.
+struct PeName
+{
+    uint32_t name;
+    uint32_t index;
+};
+class PeExports
+{
+public:
+    // Returns NULL on success or a message describing what is malformed.
+    const char* parse(const PeSource& src);
+    const PeExport* find(std::string_view name) const;
+    const PeExport* findOrdinal(uint32_t ordinal) const;
+    const char* string(uint32_t offset) const { return offset == PeExport::NO_STRING ? nullptr : strings.c_str() + offset; }
+
+    // Indexed by ordinal - ordinalBase, unused ordinals have rva 0.
+    std::vector<PeExport> exports;
+    // Every name with the index of its export, in ordinal order.
+    std::vector<PeName> names;
+    uint32_t ordinalBase = 0;
+    uint32_t namedCount = 0;
+    uint32_t sizeOfImage = 0;
+    uint64_t imageBase = 0;
+    bool is64 = false;
+    std::string moduleName;
+    std::string strings;
+
+private:
+    struct Slot
+    {
+        uint32_t hash = 0;
+        // Into names.
+        uint32_t index = UINT32_MAX;
+    };
+    std::vector<Slot> slots;
+    void buildIndex();
+};
+// Reads a PE file from disk through a FILE*.
+PeSource peFileSource(FILE* file);
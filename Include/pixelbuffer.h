@@ -0,0 +1,17 @@
+#pragma once
+// Lua pixel buffers over a PixelView, see pixelview.h.
+#define PIXELBUFFERNAME "luibexwin.PixelBuffer"
+// Heap memory, or the bits of a DIB section selected into its own memory DC.
+struct PixelBuffer
+{
+    PixelView view;
+    std::vector<uint32_t> memory;
+    HBITMAP bitmap = NULL;
+    HDC dc = NULL;
+    HGDIOBJ oldBitmap = NULL;
+    ~PixelBuffer();
+};
+PixelBuffer* newPixelBuffer(lua_State* L, int width, int height, bool dib, HDC compatible = NULL);
+PixelBuffer* checkPixelBuffer(lua_State* L, int idx);
+// Width or height argument, at least 1 and at most PIXEL_MAX_PIXELS.
+int checkPixelExtent(lua_State* L, int idx);
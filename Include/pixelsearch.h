@@ -0,0 +1,25 @@
+#pragma once
+// Color and sub-image search over pixel views, optionally split into row
+// bands searched by a shared worker pool. threads is clamped to the hardware
+// threads. Nothing here depends on Win32.
+struct PixelMatch
+{
+    int x;
+    int y;
+};
+// Same allowed difference for R, G and B, alpha is ignored.
+uint32_t pixelTolerance(int tolerance);
+uint32_t pixelTolerance(int r, int g, int b);
+bool pixelFindColor(const PixelView& v, PixelRect r, uint32_t color, uint32_t tol, int threads, PixelMatch* match);
+size_t pixelFindAllColors(const PixelView& v, PixelRect r, uint32_t color, uint32_t tol, size_t limit, std::vector<PixelMatch>& out);
+bool pixelFindImage(const PixelView& v, PixelRect r, const PixelView& image, uint32_t tol, int threads, PixelMatch* match);
+
+struct PixelSearchTiming
+{
+    std::string name;
+    int threads;
+    double megapixelsPerSecond;
+};
+// Synthetic frame with the target in the last rows, so every search scans
+// nearly all of it.
+std::vector<PixelSearchTiming> pixelSearchBenchmark(int width, int height, int threads, int iterations);
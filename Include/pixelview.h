@@ -0,0 +1,32 @@
+#pragma once
+// 32-bit pixels as stored by a top-down BI_RGB DIB: B, G, R, A in memory,
+// 0xAARRGGBB when read as uint32_t. stride is counted in pixels.
+struct PixelView
+{
+    uint32_t* pixels = nullptr;
+    int width = 0;
+    int height = 0;
+    int stride = 0;
+    uint32_t* row(int y) const { return pixels + (ptrdiff_t)y * stride; }
+};
+struct PixelRect
+{
+    int x;
+    int y;
+    int w;
+    int h;
+};
+// Largest pixel buffer that is allocated, 1 GiB.
+#define PIXEL_MAX_PIXELS ((int64_t)1 << 28)
+// Script coordinates are clamped to this, so the far edge and the distance
+// between two edges still fit an int. No view comes close to it.
+constexpr int64_t PIXEL_COORD_LIMIT = INT_MAX / 2;
+int pixelCoord(int64_t v);
+// Moves both edges into the limit, a rect covering a view still covers it.
+PixelRect pixelRect(int64_t x, int64_t y, int64_t w, int64_t h);
+// Clipping is done in 64 bits, any rect is valid input.
+bool pixelClipRect(const PixelView& v, PixelRect& r);
+// Clips sr against src and its image at (dx, dy) against dst.
+bool pixelClipCopy(const PixelView& dst, int& dx, int& dy, const PixelView& src, PixelRect& sr);
+void pixelFillRect(const PixelView& dst, PixelRect r, uint32_t color);
+void pixelCopyRect(const PixelView& dst, int dx, int dy, const PixelView& src, PixelRect sr);
@@ -0,0 +1,6 @@
+#pragma once
+// Pushes a Lua function calling func with the return type at retIdx and the
+// array of argument types at argsIdx, named as for Addr2Val. The types are
+// checked and compiled once here, so calls do not look at strings; raises a
+// Lua error for an unknown type or a signature execFunc cannot call.
+void pushProcCaller(lua_State* L, FARPROC func, int retIdx, int argsIdx);
@@ -0,0 +1,53 @@
+#pragma once
+// Row kernels over 0xAARRGGBB pixels. One table per instruction set, the
+// best one the CPU supports is selected on first use.
+enum RasterLevel
+{
+    RASTER_SCALAR,
+    RASTER_SSE2,
+    RASTER_AVX2,
+    RASTER_LEVELS
+};
+struct RasterKernels
+{
+    const char* name;
+    void (*fill)(uint32_t* dst, int count, uint32_t color);
+    // color is straight alpha, src of over is premultiplied.
+    void (*blend)(uint32_t* dst, int count, uint32_t color);
+    void (*over)(uint32_t* dst, const uint32_t* src, int count);
+    void (*colorKey)(uint32_t* dst, const uint32_t* src, int count, uint32_t key);
+    void (*swizzle)(uint32_t* dst, const uint32_t* src, int count);
+    // xs are 16.16 source columns, fy is the 7 bit weight of row1.
+    void (*bilinear)(uint32_t* dst, const uint32_t* row0, const uint32_t* row1, const int64_t* xs, int count, int fy, int maxX);
+    bool (*equal)(const uint32_t* a, const uint32_t* b, int count);
+    // tol holds the allowed difference per channel, 0xFF in a lane ignores it.
+    int (*findColor)(const uint32_t* row, int count, uint32_t color, uint32_t tol);
+    bool (*near)(const uint32_t* a, const uint32_t* b, int count, uint32_t tol);
+    void (*premultiply)(uint32_t* dst, const uint32_t* src, int count);
+};
+const RasterKernels& rasterKernels();
+RasterLevel rasterSupportedLevel();
+RasterLevel rasterActiveLevel();
+void rasterSetLevel(RasterLevel level);
+const char* rasterLevelName(RasterLevel level);
+
+void pixelBlendRect(const PixelView& dst, PixelRect r, uint32_t color);
+void pixelCompositeRect(const PixelView& dst, int dx, int dy, const PixelView& src, PixelRect sr);
+void pixelColorKeyRect(const PixelView& dst, int dx, int dy, const PixelView& src, PixelRect sr, uint32_t key);
+void pixelSwizzleRect(const PixelView& dst, PixelRect r);
+void pixelPremultiplyRect(const PixelView& dst, PixelRect r);
+void pixelScaleRect(const PixelView& dst, PixelRect dr, const PixelView& src, PixelRect sr, bool bilinear);
+// Coordinates may lie anywhere, the segment is clipped to the view first.
+void pixelDrawLine(const PixelView& dst, int64_t x0, int64_t y0, int64_t x1, int64_t y1, uint32_t color);
+// Sets mask[row * cols + col] to 1 for every tile that differs between two
+// views of the same size, returns how many did.
+int pixelDiffTiles(const PixelView& a, const PixelView& b, int tileSize, uint8_t* mask);
+
+struct RasterTiming
+{
+    RasterLevel level;
+    const char* kernel;
+    double megapixelsPerSecond;
+};
+// Every rect operation at every supported level, the active level is kept.
+std::vector<RasterTiming> rasterBenchmark(int width, int height, int iterations);
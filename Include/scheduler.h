@@ -0,0 +1,30 @@
+#pragma once
+// Native side of the coroutine scheduler in scheduler.cpp, for work that
+// completes in APCs or completion routines of the thread running it.
+// TimerWheel plus one high resolution waitable timer, set for the earliest
+// expiry by arm().
+class WaitableTimerWheel : public TimerWheel
+{
+public:
+    WaitableTimerWheel();
+    ~WaitableTimerWheel();
+    void arm();
+    HANDLE handle() const { return timer; }
+
+private:
+    HANDLE timer = NULL;
+};
+struct Scheduler;
+Scheduler* getScheduler(lua_State* L);
+// Queues task to run on the thread driving RunScheduler before it resumes
+// coroutines. Posting does not touch the Lua state, so it is safe in APCs.
+void postSchedulerTask(Scheduler* s, std::function<void(lua_State*)> task);
+void runSchedulerTasks(lua_State* L, Scheduler* s);
+// Pops the error object on top of L and prints "<what> failed: <error>".
+// Goes to stderr when print is missing or raises, so it never raises itself.
+void reportSchedulerError(lua_State* L, const char* what);
+// Native operations in flight keep RunScheduler(true) from returning.
+void addSchedulerWork(Scheduler* s, int delta);
+// Resumes the coroutines in AwaitCompletion(key) with the nvalues on top of
+// L, which are popped. Returns how many were woken.
+int signalSchedulerCompletion(lua_State* L, Scheduler* s, lua_Integer key, int nvalues);
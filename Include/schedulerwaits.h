@@ -0,0 +1,71 @@
+#pragma once
+// What each coroutine suspended in the scheduler waits for, by registry ref,
+// and which of them a deadline, a handle, a message or a completion wakes.
+// Lua free: scheduler.cpp moves the values, and the clock and handle backend
+// are those of the TimerWheel and HandleWaits given, mocks in the tests.
+struct SchedulerWake
+{
+    int ref;
+    // Waited on a handle, resumed with whether it was signaled.
+    bool handle;
+    bool signaled;
+};
+class SchedulerWaits
+{
+public:
+    // handles is opened on the first addHandle, with backend.
+    SchedulerWaits(TimerWheel& timers, HandleWaits& handles, HandleWaitBackend* backend);
+    ~SchedulerWaits();
+    SchedulerWaits(const SchedulerWaits&) = delete;
+    SchedulerWaits& operator=(const SchedulerWaits&) = delete;
+
+    // A negative ms waits without deadline.
+    void addTimeout(int ref, int64_t ms);
+    // One registration per handle, however many coroutines wait on it. False
+    // with the last error set, and nothing added, when h cannot be waited on.
+    bool addHandle(int ref, HANDLE h, int64_t ms);
+    // A NULL hwnd matches any window, msgMin = msgMax = 0 any message.
+    void addMessage(int ref, void* hwnd, unsigned msgMin, unsigned msgMax);
+    void addCompletion(int ref, int64_t key);
+    void remove(int ref);
+
+    // The take* functions append the refs woken and remove their waits.
+    void takeExpired(std::vector<SchedulerWake>& out);
+    // Every waiter of a fired handle at once.
+    void takeFiredHandles(std::vector<SchedulerWake>& out);
+    void takeMessageWaiters(void* hwnd, unsigned message, std::vector<int>& out);
+    void takeCompletionWaiters(int64_t key, std::vector<int>& out);
+
+    bool empty() const { return waits.empty(); }
+    size_t size() const { return waits.size(); }
+
+private:
+    struct Wait
+    {
+        HANDLE handle = NULL;
+        bool hasDeadline = false;
+        uint64_t timerId = 0;
+        bool forMessage = false;
+        void* msgHwnd = nullptr;
+        unsigned msgMin = 0;
+        unsigned msgMax = 0;
+        bool forCompletion = false;
+        int64_t completion = 0;
+    };
+    struct HandleWaiters
+    {
+        std::vector<int> refs;
+        std::unique_ptr<HandleWait> wait;
+    };
+    TimerWheel& timers;
+    HandleWaits& handles;
+    HandleWaitBackend* backend;
+    std::unordered_map<int, Wait> waits;
+    std::unordered_map<HANDLE, HandleWaiters> handleWaiters;
+    std::vector<int> messageWaiters;
+    std::unordered_map<int64_t, std::vector<int>> completionWaiters;
+    std::vector<TimerWheel::Expired> expired;
+    std::vector<HandleWait*> fired;
+
+    void addDeadline(int ref, Wait& wait, int64_t ms);
+};
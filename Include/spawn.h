@@ -0,0 +1,44 @@
+#pragma once
+// Child process whose stdout and stderr are read through overlapped pipes.
+// Reads finish in completion routines and the exit is queued as an APC, both
+// run on the thread that started the process during its alertable waits
+// (RunScheduler, SleepEx(ms, true), Process:wait), never concurrently.
+struct SpawnedProcess;
+struct SpawnStream
+{
+    OVERLAPPED ov{};
+    SpawnedProcess* owner = nullptr;
+    HANDLE pipe = NULL;
+    bool open = false;
+    std::string data;
+    char chunk[16384];
+};
+struct SpawnedProcess
+{
+    SpawnStream out;
+    SpawnStream err;
+    HANDLE process = NULL;
+    DWORD pid = 0;
+    DWORD exitCode = STILL_ACTIVE;
+    bool exited = false;
+    bool finished = false;
+    bool closing = false;
+    uint64_t startMs = 0;
+    uint64_t endMs = 0;
+    // Both run in completion routines and must not call into Lua. onOutput
+    // gets the number of bytes just appended to stream.data, onFinish runs
+    // once the process exited and both pipes are closed.
+    std::function<void(SpawnedProcess*, SpawnStream&, size_t)> onOutput;
+    std::function<void(SpawnedProcess*)> onFinish;
+
+    HANDLE thread = NULL;
+    HANDLE wait = NULL;
+    int pending = 0;
+    std::atomic<bool> exitQueued = false;
+};
+// commandLine is passed to CreateProcessA unchanged, job (optional) gets the
+// child before its first instruction runs. Sets the last error on failure.
+bool startProcess(SpawnedProcess* p, const char* commandLine, const char* cwd, HANDLE job, DWORD flags);
+// Stops reading and waits for the outstanding completions, the child keeps
+// running. Must be called on the thread that started it.
+void closeProcess(SpawnedProcess* p);
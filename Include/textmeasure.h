@@ -0,0 +1,6 @@
+#pragma once
+// Text extents cached per (selected font, DPI, character extra, string), for
+// MeasureText and MeasureTextBatch. DCs in another mapping or graphics mode
+// are measured every time. Safe to call from any thread.
+bool measureTextCached(HDC hdc, const char* text, size_t len, SIZE* size);
+void textMeasureForgetFont(HGDIOBJ font);
@@ -0,0 +1,53 @@
+#pragma once
+// Hierarchical timing wheel with 1 ms ticks. Insert and cancel are O(1).
+// Only depends on the standard library, the waitable timer armed for the
+// earliest expiry is added by WaitableTimerWheel in scheduler.h.
+class TimerWheel
+{
+public:
+    struct Expired
+    {
+        uint64_t id;
+        int64_t cookie;
+    };
+    // The wheel reads the time through clock, tests pass a manual one.
+    explicit TimerWheel(uint64_t (*clock)() = &TimerWheel::now);
+    TimerWheel(const TimerWheel&) = delete;
+    TimerWheel& operator=(const TimerWheel&) = delete;
+
+    uint64_t add(uint64_t delayMs, uint64_t periodMs, int64_t cookie = 0);
+    bool cancel(uint64_t id);
+    size_t advance(uint64_t nowMs, std::vector<Expired>& fired);
+    uint64_t nextExpiry() const;
+    size_t size() const { return active; }
+    // Monotonic milliseconds.
+    static uint64_t now();
+    uint64_t clockNow() const { return clock(); }
+
+private:
+    static constexpr int LEVELS = 5;
+    static constexpr int BITS = 6;
+    static constexpr int SLOTS = 1 << BITS;
+    struct Node
+    {
+        uint64_t expires = 0;
+        uint64_t period = 0;
+        int64_t cookie = 0;
+        uint32_t generation = 1;
+        int32_t prev = -1;
+        int32_t next = -1;
+        int32_t slot = -1;
+    };
+    uint64_t (*clock)();
+    std::vector<Node> nodes;
+    std::vector<uint32_t> freeNodes;
+    int32_t heads[LEVELS * SLOTS];
+    uint64_t occupied[LEVELS];
+    uint64_t current;
+    size_t active = 0;
+
+    void link(uint32_t index);
+    void unlink(uint32_t index);
+    int32_t detach(int slot);
+    void release(uint32_t index);
+};
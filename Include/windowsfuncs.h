@@ -35,6 +35,7 @@ REGISTERINH(RegisterClassEx)
 REGISTERINH(LoadLibrary)
 REGISTERINH(FreeLibrary)
 REGISTERINH(GetProcAddress)
+REGISTERINH(BindLibrary)
 REGISTERINH(GetMessage)
 REGISTERINH(TranslateMessage)
 REGISTERINH(DispatchMessage)
@@ -130,7 +131,63 @@ REGISTERINH(SetLayeredWindowAttributes)
 REGISTERINH(GetLayeredWindowAttributes)
 REGISTERINH(CreateProcess)
 REGISTERINH(TerminateProcess)
+REGISTERINH(OpenProcess)
+REGISTERINH(ReadProcessMemory)
 REGISTERINH(CloseHandle)
 REGISTERINH(CopyAddr)
 REGISTERINH(WriteAddr)
 REGISTERINH(GetLuaStateAddr)
+REGISTERINH(SpawnCoroutine)
+REGISTERINH(AwaitTimeout)
+REGISTERINH(AwaitHandle)
+REGISTERINH(AwaitMessage)
+REGISTERINH(AwaitCompletion)
+REGISTERINH(SignalCompletion)
+REGISTERINH(RunScheduler)
+REGISTERINH(StopScheduler)
+REGISTERINH(CreateTimerWheel)
+REGISTERINH(CreateWaitSet)
+REGISTERINH(QueryPerformanceCounter)
+REGISTERINH(QueryPerformanceFrequency)
+REGISTERINH(ProfileLabel)
+REGISTERINH(ProfileBegin)
+REGISTERINH(ProfileEnd)
+REGISTERINH(ProfileRecord)
+REGISTERINH(ProfileStats)
+REGISTERINH(ProfileReset)
+REGISTERINH(CreatePixelBuffer)
+REGISTERINH(CreateDIBPixelBuffer)
+REGISTERINH(ARGB)
+REGISTERINH(RasterKernelLevel)
+REGISTERINH(RasterBenchmark)
+REGISTERINH(CreateCommandList)
+REGISTERINH(EnableDoubleBuffer)
+REGISTERINH(DisableDoubleBuffer)
+REGISTERINH(GetDirtyRects)
+REGISTERINH(CachedSolidBrush)
+REGISTERINH(CachedPen)
+REGISTERINH(CachedFont)
+REGISTERINH(ReleaseCachedObject)
+REGISTERINH(SetCachedObjectLimit)
+REGISTERINH(GetCachedObjectCounts)
+REGISTERINH(GetGuiResources)
+REGISTERINH(MeasureText)
+REGISTERINH(MeasureTextBatch)
+REGISTERINH(ClearTextMeasureCache)
+REGISTERINH(CreateScreenCapture)
+REGISTERINH(PixelSearchBenchmark)
+REGISTERINH(UpdateLayeredWindow)
+REGISTERINH(LoadPixelBuffer)
+REGISTERINH(DecodePixelBuffer)
+REGISTERINH(LoadImageRows)
+REGISTERINH(DecodeImageRows)
+REGISTERINH(SavePixelBuffer)
+REGISTERINH(EncodePixelBuffer)
+REGISTERINH(ImageCodecBenchmark)
+REGISTERINH(ConstantName)
+REGISTERINH(SpawnProcess)
+REGISTERINH(CreateProcessPool)
+REGISTERINH(CreateSnapshot)
+REGISTERINH(DiffSnapshots)
+REGISTERINH(ParseExports)
+REGISTERINH(ParseExportsFile)
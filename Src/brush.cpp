@@ -29,15 +29,4 @@ Lua_Function(GetSysColorBrush)
 	HBRUSH hBrush = GetSysColorBrush(nIndex);
 	pushWindowStruct(L, HBRUSH, hBrush);
 	return 1;
-}
-void register_brush(lua_State* L)
-{
-	REGIMACRO(BLACK_BRUSH)
-	REGIMACRO(WHITE_BRUSH)
-	REGIMACRO(GRAY_BRUSH)
-	REGIMACRO(LTGRAY_BRUSH)
-	REGIMACRO(DKGRAY_BRUSH)
-	REGIMACRO(HOLLOW_BRUSH)
-	REGIMACRO(NULL_BRUSH)
-	REGIMACRO(DC_BRUSH)
 }
\ No newline at end of file
@@ -0,0 +1,155 @@
+#define SCREENCAPTURENAME "luibexwin.ScreenCapture"
+// Ring of DIB pixel buffers, each capture goes into the next slot and is
+// compared tile by tile with the one before it. The PixelBuffer userdata of
+// the slots live in the capture's uservalue table.
+struct ScreenCapture
+{
+    std::vector<PixelBuffer*> slots;
+    int current = -1;
+    bool hasPrevious = false;
+    int x = 0;
+    int y = 0;
+    int tileSize = 32;
+    int cols = 0;
+    int rows = 0;
+    std::vector<uint8_t> mask;
+    int changed = 0;
+};
+static ScreenCapture* checkScreenCapture(lua_State* L, int idx)
+{
+    return luaL_checkobject(L, idx, ScreenCapture, SCREENCAPTURENAME);
+}
+static void pushCaptureSlot(lua_State* L, int idx, int slot)
+{
+    lua_getuservalue(L, idx);
+    lua_rawgeti(L, -1, slot + 1);
+    lua_remove(L, -2);
+}
+// cap:capture([x, y]) -> PixelBuffer, changed tile count
+static int screencapture_capture(lua_State* L)
+{
+    ScreenCapture* cap = checkScreenCapture(L, 1);
+    cap->x = (int)luaL_optinteger(L, 2, cap->x);
+    cap->y = (int)luaL_optinteger(L, 3, cap->y);
+    int next = (cap->current + 1) % (int)cap->slots.size();
+    PixelBuffer* frame = cap->slots[next];
+    HDC screen = GetDC(NULL);
+    BOOL ok = BitBlt(frame->dc, 0, 0, frame->view.width, frame->view.height, screen, cap->x, cap->y, SRCCOPY | CAPTUREBLT);
+    ReleaseDC(NULL, screen);
+    if (!ok)
+        return 0;
+    GdiFlush();
+    if (cap->hasPrevious)
+        cap->changed = pixelDiffTiles(cap->slots[cap->current]->view, frame->view, cap->tileSize, cap->mask.data());
+    else
+    {
+        std::fill(cap->mask.begin(), cap->mask.end(), (uint8_t)1);
+        cap->changed = (int)cap->mask.size();
+    }
+    cap->current = next;
+    cap->hasPrevious = true;
+    pushCaptureSlot(L, 1, next);
+    lua_pushinteger(L, cap->changed);
+    return 2;
+}
+// cap:frame([age]) -> PixelBuffer captured age frames ago, 0 is the latest
+static int screencapture_frame(lua_State* L)
+{
+    ScreenCapture* cap = checkScreenCapture(L, 1);
+    lua_Integer age = luaL_optinteger(L, 2, 0);
+    luaL_argcheck(L, age >= 0 && age < (lua_Integer)cap->slots.size(), 2, "age out of range");
+    if (cap->current < 0)
+        return 0;
+    int count = (int)cap->slots.size();
+    pushCaptureSlot(L, 1, ((cap->current - (int)age) % count + count) % count);
+    return 1;
+}
+// cap:mask() -> IntArray with 1 for each changed tile, row major
+static int screencapture_mask(lua_State* L)
+{
+    ScreenCapture* cap = checkScreenCapture(L, 1);
+    IntArray* out = newIntArray(L, cap->mask.size());
+    for (size_t i = 0; i < cap->mask.size(); ++i)
+        out->values[i] = cap->mask[i];
+    return 1;
+}
+// cap:changedTiles() -> IntArray of the 1 based indices of changed tiles
+static int screencapture_changedtiles(lua_State* L)
+{
+    ScreenCapture* cap = checkScreenCapture(L, 1);
+    IntArray* out = newIntArray(L, (size_t)cap->changed);
+    size_t n = 0;
+    for (size_t i = 0; i < cap->mask.size() && n < out->count; ++i)
+        if (cap->mask[i])
+            out->values[n++] = (lua_Integer)i + 1;
+    return 1;
+}
+// cap:tileRect(i) -> x, y, w, h in buffer coordinates
+static int screencapture_tilerect(lua_State* L)
+{
+    ScreenCapture* cap = checkScreenCapture(L, 1);
+    lua_Integer i = luaL_checkinteger(L, 2);
+    luaL_argcheck(L, i >= 1 && i <= (lua_Integer)cap->mask.size(), 2, "tile out of range");
+    const PixelView& view = cap->slots[0]->view;
+    int x = (int)((i - 1) % cap->cols) * cap->tileSize;
+    int y = (int)((i - 1) / cap->cols) * cap->tileSize;
+    lua_pushinteger(L, x);
+    lua_pushinteger(L, y);
+    lua_pushinteger(L, std::min(cap->tileSize, view.width - x));
+    lua_pushinteger(L, std::min(cap->tileSize, view.height - y));
+    return 4;
+}
+// cap:grid() -> cols, rows, tileSize
+static int screencapture_grid(lua_State* L)
+{
+    ScreenCapture* cap = checkScreenCapture(L, 1);
+    lua_pushinteger(L, cap->cols);
+    lua_pushinteger(L, cap->rows);
+    lua_pushinteger(L, cap->tileSize);
+    return 3;
+}
+// Next capture reports every tile as changed.
+static int screencapture_reset(lua_State* L)
+{
+    checkScreenCapture(L, 1)->hasPrevious = false;
+    return 0;
+}
+static const luaL_Reg screencapture_methods[] = {
+    {"capture", screencapture_capture},
+    {"frame", screencapture_frame},
+    {"mask", screencapture_mask},
+    {"changedTiles", screencapture_changedtiles},
+    {"tileRect", screencapture_tilerect},
+    {"grid", screencapture_grid},
+    {"reset", screencapture_reset},
+    {NULL, NULL}
+};
+// CreateScreenCapture(x, y, width, height [, slots = 2, tileSize = 32])
+Lua_Function(CreateScreenCapture)
+{
+    int x = (int)luaL_checkinteger(L, 1);
+    int y = (int)luaL_checkinteger(L, 2);
+    int width = checkPixelExtent(L, 3);
+    int height = checkPixelExtent(L, 4);
+    lua_Integer slots = luaL_optinteger(L, 5, 2);
+    lua_Integer tileSize = luaL_optinteger(L, 6, 32);
+    luaL_argcheck(L, slots >= 2 && slots <= 64, 5, "slots must be between 2 and 64");
+    luaL_argcheck(L, tileSize >= 4 && tileSize <= std::max(width, height), 6, "tile size must be between 4 and the larger side");
+    ScreenCapture* cap = newLuaObject<ScreenCapture>(L, SCREENCAPTURENAME, screencapture_methods, nullptr);
+    int capIndex = lua_gettop(L);
+    cap->x = x;
+    cap->y = y;
+    cap->tileSize = (int)tileSize;
+    cap->cols = (int)((width + tileSize - 1) / tileSize);
+    cap->rows = (int)((height + tileSize - 1) / tileSize);
+    lua_createtable(L, (int)slots, 0);
+    for (int i = 0; i < slots; ++i)
+    {
+        PixelBuffer* pb = newPixelBuffer(L, width, height, true);
+        lua_rawseti(L, -2, i + 1);
+        cap->slots.push_back(pb);
+    }
+    lua_setuservalue(L, capIndex);
+    cap->mask.assign((size_t)cap->cols * cap->rows, 0);
+    return 1;
+}
@@ -0,0 +1,254 @@
+#define COMMANDLISTNAME "luibexwin.CommandList"
+// Largest reserve hint CreateCommandList accepts, lists still grow past it.
+#define COMMANDLIST_MAX_RESERVE (1 << 20)
+enum GdiOp : uint8_t
+{
+    GDI_FILLRECT,
+    GDI_FILLSOLID,
+    GDI_SELECTOBJECT,
+    GDI_TEXTCOLOR,
+    GDI_BKCOLOR,
+    GDI_BKMODE,
+    GDI_TEXTOUT,
+    GDI_DRAWTEXT,
+    GDI_BITBLT,
+    GDI_SETPIXEL,
+    GDI_MOVETO,
+    GDI_LINETO,
+    GDI_RECTANGLE,
+    GDI_ELLIPSE
+};
+// Text is kept in one pool per list, args[] holds its offset and length.
+struct GdiCommand
+{
+    GdiOp op;
+    int args[8];
+    void* handle;
+};
+struct CommandList
+{
+    std::vector<GdiCommand> commands;
+    std::string text;
+};
+static CommandList* checkCommandList(lua_State* L, int idx)
+{
+    return luaL_checkobject(L, idx, CommandList, COMMANDLISTNAME);
+}
+// Arguments are checked before anything is appended, a bad call leaves the list unchanged.
+static GdiCommand readCommand(lua_State* L, GdiOp op, int first, int nargs, void* handle = nullptr)
+{
+    GdiCommand cmd = {};
+    cmd.op = op;
+    cmd.handle = handle;
+    for (int i = 0; i < nargs; ++i)
+        cmd.args[i] = (int)luaL_checkinteger(L, first + i);
+    return cmd;
+}
+static void appendCommand(lua_State* L, const GdiCommand& cmd)
+{
+    checkCommandList(L, 1)->commands.push_back(cmd);
+}
+static void appendTextCommand(lua_State* L, GdiCommand& cmd, int idx, int slot)
+{
+    CommandList* cl = checkCommandList(L, 1);
+    size_t len;
+    const char* str = luaL_checklstring(L, idx, &len);
+    cmd.args[slot] = (int)cl->text.size();
+    cmd.args[slot + 1] = (int)len;
+    cl->text.append(str, len);
+    cl->commands.push_back(cmd);
+}
+// cl:fillRect(left, top, right, bottom, hbrush)
+static int commandlist_fillrect(lua_State* L)
+{
+    appendCommand(L, readCommand(L, GDI_FILLRECT, 2, 4, luaL_wingetbycheckudata(L, 6, HBRUSH)));
+    return 0;
+}
+// cl:fillSolid(left, top, right, bottom, colorref), no brush needed.
+static int commandlist_fillsolid(lua_State* L)
+{
+    appendCommand(L, readCommand(L, GDI_FILLSOLID, 2, 5));
+    return 0;
+}
+static int commandlist_selectobject(lua_State* L)
+{
+    appendCommand(L, readCommand(L, GDI_SELECTOBJECT, 2, 0, luaL_wingetbycheckudata(L, 2, HGDIOBJ)));
+    return 0;
+}
+static int commandlist_settextcolor(lua_State* L)
+{
+    appendCommand(L, readCommand(L, GDI_TEXTCOLOR, 2, 1));
+    return 0;
+}
+static int commandlist_setbkcolor(lua_State* L)
+{
+    appendCommand(L, readCommand(L, GDI_BKCOLOR, 2, 1));
+    return 0;
+}
+static int commandlist_setbkmode(lua_State* L)
+{
+    appendCommand(L, readCommand(L, GDI_BKMODE, 2, 1));
+    return 0;
+}
+// cl:textOut(x, y, text)
+static int commandlist_textout(lua_State* L)
+{
+    GdiCommand cmd = readCommand(L, GDI_TEXTOUT, 2, 2);
+    appendTextCommand(L, cmd, 4, 2);
+    return 0;
+}
+// cl:drawText(text, left, top, right, bottom, format)
+static int commandlist_drawtext(lua_State* L)
+{
+    GdiCommand cmd = readCommand(L, GDI_DRAWTEXT, 3, 5);
+    appendTextCommand(L, cmd, 2, 5);
+    return 0;
+}
+// cl:bitBlt(x, y, cx, cy, hdcSrc, x1, y1, rop)
+static int commandlist_bitblt(lua_State* L)
+{
+    HDC hdcSrc = luaL_wingetbycheckudata(L, 6, HDC);
+    GdiCommand cmd = readCommand(L, GDI_BITBLT, 2, 4, hdcSrc);
+    cmd.args[4] = (int)luaL_checkinteger(L, 7);
+    cmd.args[5] = (int)luaL_checkinteger(L, 8);
+    cmd.args[6] = (int)(DWORD)luaL_checkinteger(L, 9);
+    appendCommand(L, cmd);
+    return 0;
+}
+static int commandlist_setpixel(lua_State* L)
+{
+    appendCommand(L, readCommand(L, GDI_SETPIXEL, 2, 3));
+    return 0;
+}
+static int commandlist_moveto(lua_State* L)
+{
+    appendCommand(L, readCommand(L, GDI_MOVETO, 2, 2));
+    return 0;
+}
+static int commandlist_lineto(lua_State* L)
+{
+    appendCommand(L, readCommand(L, GDI_LINETO, 2, 2));
+    return 0;
+}
+static int commandlist_rectangle(lua_State* L)
+{
+    appendCommand(L, readCommand(L, GDI_RECTANGLE, 2, 4));
+    return 0;
+}
+static int commandlist_ellipse(lua_State* L)
+{
+    appendCommand(L, readCommand(L, GDI_ELLIPSE, 2, 4));
+    return 0;
+}
+static int commandlist_clear(lua_State* L)
+{
+    CommandList* cl = checkCommandList(L, 1);
+    cl->commands.clear();
+    cl->text.clear();
+    return 0;
+}
+static int commandlist_count(lua_State* L)
+{
+    lua_pushinteger(L, (lua_Integer)checkCommandList(L, 1)->commands.size());
+    return 1;
+}
+static BOOL executeCommand(HDC hdc, const GdiCommand& cmd, const std::string& text)
+{
+    const int* a = cmd.args;
+    switch (cmd.op)
+    {
+    case GDI_FILLRECT:
+    {
+        RECT rect = { a[0], a[1], a[2], a[3] };
+        return FillRect(hdc, &rect, (HBRUSH)cmd.handle);
+    }
+    case GDI_FILLSOLID:
+    {
+        RECT rect = { a[0], a[1], a[2], a[3] };
+        COLORREF prev = SetBkColor(hdc, (COLORREF)a[4]);
+        BOOL result = ExtTextOutA(hdc, 0, 0, ETO_OPAQUE, &rect, NULL, 0, NULL);
+        SetBkColor(hdc, prev);
+        return result;
+    }
+    case GDI_SELECTOBJECT:
+        return SelectObject(hdc, (HGDIOBJ)cmd.handle) != NULL;
+    case GDI_TEXTCOLOR:
+        return SetTextColor(hdc, (COLORREF)a[0]) != CLR_INVALID;
+    case GDI_BKCOLOR:
+        return SetBkColor(hdc, (COLORREF)a[0]) != CLR_INVALID;
+    case GDI_BKMODE:
+        return SetBkMode(hdc, a[0]) != 0;
+    case GDI_TEXTOUT:
+        return TextOutA(hdc, a[0], a[1], text.data() + a[2], a[3]);
+    case GDI_DRAWTEXT:
+    {
+        RECT rect = { a[0], a[1], a[2], a[3] };
+        return DrawTextA(hdc, text.data() + a[5], a[6], &rect, (UINT)a[4]) != 0;
+    }
+    case GDI_BITBLT:
+        return BitBlt(hdc, a[0], a[1], a[2], a[3], (HDC)cmd.handle, a[4], a[5], (DWORD)a[6]);
+    case GDI_SETPIXEL:
+        return SetPixel(hdc, a[0], a[1], (COLORREF)a[2]) != (COLORREF)-1;
+    case GDI_MOVETO:
+        return MoveToEx(hdc, a[0], a[1], NULL);
+    case GDI_LINETO:
+        return LineTo(hdc, a[0], a[1]);
+    case GDI_RECTANGLE:
+        return Rectangle(hdc, a[0], a[1], a[2], a[3]);
+    case GDI_ELLIPSE:
+        return Ellipse(hdc, a[0], a[1], a[2], a[3]);
+    }
+    return FALSE;
+}
+// cl:execute(hdc) -> true, or false and the index of the first failed command.
+// The DC state is saved and restored around the replay.
+static int commandlist_execute(lua_State* L)
+{
+    CommandList* cl = checkCommandList(L, 1);
+    HDC hdc = luaL_wingetbycheckudata(L, 2, HDC);
+    int saved = SaveDC(hdc);
+    size_t failed = 0;
+    for (size_t i = 0; i < cl->commands.size(); ++i)
+        if (!executeCommand(hdc, cl->commands[i], cl->text) && !failed)
+            failed = i + 1;
+    if (saved)
+        RestoreDC(hdc, saved);
+    lua_pushboolean(L, failed == 0);
+    if (failed == 0)
+        return 1;
+    lua_pushinteger(L, (lua_Integer)failed);
+    return 2;
+}
+static const luaL_Reg commandlist_methods[] = {
+    {"fillRect", commandlist_fillrect},
+    {"fillSolid", commandlist_fillsolid},
+    {"selectObject", commandlist_selectobject},
+    {"setTextColor", commandlist_settextcolor},
+    {"setBkColor", commandlist_setbkcolor},
+    {"setBkMode", commandlist_setbkmode},
+    {"textOut", commandlist_textout},
+    {"drawText", commandlist_drawtext},
+    {"bitBlt", commandlist_bitblt},
+    {"setPixel", commandlist_setpixel},
+    {"moveTo", commandlist_moveto},
+    {"lineTo", commandlist_lineto},
+    {"rectangle", commandlist_rectangle},
+    {"ellipse", commandlist_ellipse},
+    {"clear", commandlist_clear},
+    {"count", commandlist_count},
+    {"execute", commandlist_execute},
+    {NULL, NULL}
+};
+static const luaL_Reg commandlist_metamethods[] = {
+    {"__len", commandlist_count},
+    {NULL, NULL}
+};
+Lua_Function(CreateCommandList)
+{
+    lua_Integer reserve = luaL_optinteger(L, 1, 0);
+    luaL_argcheck(L, reserve >= 0 && reserve <= COMMANDLIST_MAX_RESERVE, 1, "reserve must be between 0 and 1048576");
+    CommandList* cl = newLuaObject<CommandList>(L, COMMANDLISTNAME, commandlist_methods, commandlist_metamethods);
+    if (reserve > 0)
+        cl->commands.reserve((size_t)reserve);
+    return 1;
+}
@@ -10,20 +10,4 @@ Lua_Function(InitCommonControlsEx)
     BOOL ok = InitCommonControlsEx(&icex);
     lua_pushboolean(L, ok);
     return 1;
-}
-void register_commcontrol(lua_State* L)
-{
-    // Iconos
-    REGUMACRO(LPWSTR, TD_INFORMATION_ICON)
-    REGUMACRO(LPWSTR, TD_WARNING_ICON)
-    REGUMACRO(LPWSTR, TD_ERROR_ICON)
-    REGUMACRO(LPWSTR, TD_SHIELD_ICON)
-
-    // Botones
-    REGIMACRO(TDCBF_OK_BUTTON)
-    REGIMACRO(TDCBF_YES_BUTTON)
-    REGIMACRO(TDCBF_NO_BUTTON)
-    REGIMACRO(TDCBF_CANCEL_BUTTON)
-    REGIMACRO(TDCBF_RETRY_BUTTON)
-    REGIMACRO(TDCBF_CLOSE_BUTTON)
 }
\ No newline at end of file
@@ -0,0 +1,965 @@
+// The constant tables and families of constants.h. They only need the
+// Win32 headers, so the load benchmark can build them on any platform.
+
+INIT_CONSTANTS(brush_constants)
+	REGIMACRO(BLACK_BRUSH)
+	REGIMACRO(WHITE_BRUSH)
+	REGIMACRO(GRAY_BRUSH)
+	REGIMACRO(LTGRAY_BRUSH)
+	REGIMACRO(DKGRAY_BRUSH)
+	REGIMACRO(HOLLOW_BRUSH)
+	REGIMACRO(NULL_BRUSH)
+	REGIMACRO(DC_BRUSH)
+	// pen styles
+	REGIMACRO(PS_SOLID)
+	REGIMACRO(PS_DASH)
+	REGIMACRO(PS_DOT)
+	REGIMACRO(PS_DASHDOT)
+	REGIMACRO(PS_DASHDOTDOT)
+	REGIMACRO(PS_NULL)
+	REGIMACRO(PS_INSIDEFRAME)
+	// font weights and quality
+	REGIMACRO(FW_THIN)
+	REGIMACRO(FW_LIGHT)
+	REGIMACRO(FW_NORMAL)
+	REGIMACRO(FW_MEDIUM)
+	REGIMACRO(FW_SEMIBOLD)
+	REGIMACRO(FW_BOLD)
+	REGIMACRO(FW_HEAVY)
+	REGIMACRO(DEFAULT_QUALITY)
+	REGIMACRO(ANTIALIASED_QUALITY)
+	REGIMACRO(CLEARTYPE_QUALITY)
+	REGIMACRO(DEFAULT_CHARSET)
+	REGIMACRO(ANSI_CHARSET)
+	// GetGuiResources
+	REGIMACRO(GR_GDIOBJECTS)
+	REGIMACRO(GR_USEROBJECTS)
+	REGIMACRO(GR_GDIOBJECTS_PEAK)
+	REGIMACRO(GR_USEROBJECTS_PEAK)
+END_CONSTANTS(brush_constants)
+
+INIT_CONSTANTS(commcontrol_constants)
+    // Iconos
+    REGUMACRO(LPWSTR, TD_INFORMATION_ICON)
+    REGUMACRO(LPWSTR, TD_WARNING_ICON)
+    REGUMACRO(LPWSTR, TD_ERROR_ICON)
+    REGUMACRO(LPWSTR, TD_SHIELD_ICON)
+
+    // Botones
+    REGIMACRO(TDCBF_OK_BUTTON)
+    REGIMACRO(TDCBF_YES_BUTTON)
+    REGIMACRO(TDCBF_NO_BUTTON)
+    REGIMACRO(TDCBF_CANCEL_BUTTON)
+    REGIMACRO(TDCBF_RETRY_BUTTON)
+    REGIMACRO(TDCBF_CLOSE_BUTTON)
+END_CONSTANTS(commcontrol_constants)
+
+INIT_CONSTANTS(cursor_constants)
+        REGUMACRO(LPSTR, IDC_ARROW)         // 32512
+        REGUMACRO(LPSTR, IDC_IBEAM)         // 32513
+        REGUMACRO(LPSTR, IDC_WAIT)          // 32514
+        REGUMACRO(LPSTR, IDC_CROSS)         // 32515
+        REGUMACRO(LPSTR, IDC_UPARROW)       // 32516
+        REGUMACRO(LPSTR, IDC_SIZE)          // 32640
+        REGUMACRO(LPSTR, IDC_ICON)          // 32641
+        REGUMACRO(LPSTR, IDC_SIZENWSE)      // 32642
+        REGUMACRO(LPSTR, IDC_SIZENESW)      // 32643
+        REGUMACRO(LPSTR, IDC_SIZEWE)        // 32644
+        REGUMACRO(LPSTR, IDC_SIZENS)        // 32645
+        REGUMACRO(LPSTR, IDC_SIZEALL)       // 32646
+        REGUMACRO(LPSTR, IDC_NO)            // 32648
+#if(WINVER >= 0x0500)
+        REGUMACRO(LPSTR, IDC_HAND)          // 32649
+#endif
+
+        REGUMACRO(LPSTR, IDC_APPSTARTING)   // 32650
+
+#if(WINVER >= 0x0400)
+        REGUMACRO(LPSTR, IDC_HELP)          // 32651
+#endif
+
+#if(WINVER >= 0x0606)
+        REGUMACRO(LPSTR, IDC_PIN)           // 32671
+        REGUMACRO(LPSTR, IDC_PERSON)        // 32672
+#endif
+END_CONSTANTS(cursor_constants)
+
+INIT_CONSTANTS(errors_constants)
+    REGUMACRO(HANDLE, INVALID_HANDLE_VALUE)
+    REGIMACRO(INVALID_FILE_ATTRIBUTES)
+    REGIMACRO(INVALID_SET_FILE_POINTER)
+END_CONSTANTS(errors_constants)
+
+INIT_CONSTANTS(explorerutills_constants)
+    REGIMACRO(MAX_PATH)
+    REGIMACRO(BIF_RETURNONLYFSDIRS)
+    REGIMACRO(BIF_DONTGOBELOWDOMAIN)
+    REGIMACRO(BIF_STATUSTEXT)
+    REGIMACRO(BIF_RETURNFSANCESTORS)
+    REGIMACRO(BIF_EDITBOX)
+    REGIMACRO(BIF_VALIDATE)
+    REGIMACRO(BIF_NEWDIALOGSTYLE)
+    REGIMACRO(BIF_USENEWUI)
+    REGIMACRO(BIF_BROWSEINCLUDEFILES)
+    REGIMACRO(BIF_BROWSEFORCOMPUTER)
+    REGIMACRO(BIF_BROWSEFORPRINTER)
+    REGIMACRO(BIF_BROWSEINCLUDEURLS)
+    REGIMACRO(BIF_BROWSEFILEJUNCTIONS)
+    REGIMACRO(OFN_READONLY)
+    REGIMACRO(OFN_OVERWRITEPROMPT)
+    REGIMACRO(OFN_HIDEREADONLY)
+    REGIMACRO(OFN_NOCHANGEDIR)
+    REGIMACRO(OFN_SHOWHELP)
+    REGIMACRO(OFN_ENABLEHOOK)
+    REGIMACRO(OFN_ENABLETEMPLATE)
+    REGIMACRO(OFN_ENABLETEMPLATEHANDLE)
+    REGIMACRO(OFN_NOVALIDATE)
+    REGIMACRO(OFN_ALLOWMULTISELECT)
+    REGIMACRO(OFN_EXTENSIONDIFFERENT)
+    REGIMACRO(OFN_PATHMUSTEXIST)
+    REGIMACRO(OFN_FILEMUSTEXIST)
+    REGIMACRO(OFN_CREATEPROMPT)
+    REGIMACRO(OFN_SHAREAWARE)
+    REGIMACRO(OFN_NOREADONLYRETURN)
+    REGIMACRO(OFN_NOTESTFILECREATE)
+    REGIMACRO(OFN_NONETWORKBUTTON)
+    REGIMACRO(OFN_NOLONGNAMES)
+    REGIMACRO(OFN_EXPLORER)
+    REGIMACRO(OFN_NODEREFERENCELINKS)
+    REGIMACRO(OFN_LONGNAMES)
+    REGIMACRO(OFN_ENABLEINCLUDENOTIFY)
+    REGIMACRO(OFN_ENABLESIZING)
+    REGIMACRO(OFN_DONTADDTORECENT)
+    REGIMACRO(OFN_FORCESHOWHIDDEN)
+
+END_CONSTANTS(explorerutills_constants)
+
+INIT_CONSTANTS(filesystem_constants)
+    REGIMACRO(FILE_ATTRIBUTE_READONLY)
+        REGIMACRO(FILE_ATTRIBUTE_HIDDEN)
+        REGIMACRO(FILE_ATTRIBUTE_SYSTEM)
+        REGIMACRO(FILE_ATTRIBUTE_DIRECTORY)
+        REGIMACRO(FILE_ATTRIBUTE_ARCHIVE)
+        REGIMACRO(FILE_ATTRIBUTE_NORMAL)
+        REGIMACRO(FILE_ATTRIBUTE_TEMPORARY)
+        REGIMACRO(FILE_ATTRIBUTE_OFFLINE)
+        REGIMACRO(FILE_ATTRIBUTE_ENCRYPTED)
+        REGIMACRO(FILE_ATTRIBUTE_COMPRESSED)
+        REGIMACRO(FILE_ATTRIBUTE_REPARSE_POINT)
+        REGIMACRO(FILE_FLAG_BACKUP_SEMANTICS)
+        REGIMACRO(FILE_FLAG_DELETE_ON_CLOSE)
+        REGIMACRO(FILE_FLAG_OVERLAPPED)
+        REGIMACRO(FILE_FLAG_NO_BUFFERING)
+        REGIMACRO(FILE_FLAG_RANDOM_ACCESS)
+        REGIMACRO(FILE_FLAG_SEQUENTIAL_SCAN)
+        REGIMACRO(GENERIC_READ)
+        REGIMACRO(GENERIC_WRITE)
+        REGIMACRO(GENERIC_EXECUTE)
+        REGIMACRO(GENERIC_ALL)
+        REGIMACRO(SECURITY_DESCRIPTOR_REVISION)
+        REGIMACRO(DACL_SECURITY_INFORMATION)
+        REGIMACRO(OWNER_SECURITY_INFORMATION)
+        REGIMACRO(GROUP_SECURITY_INFORMATION)
+END_CONSTANTS(filesystem_constants)
+
+INIT_CONSTANTS(commonwinutils_constants)
+        // WS_*
+        REGIMACRO(WS_OVERLAPPED)
+        REGIMACRO(WS_POPUP)
+        REGIMACRO(WS_VISIBLE)
+        REGIMACRO(WS_CHILD)
+        REGIMACRO(WS_BORDER)
+        REGIMACRO(WS_DLGFRAME)
+        REGIMACRO(WS_CAPTION)
+        REGIMACRO(WS_SYSMENU)
+        REGIMACRO(WS_THICKFRAME)
+        REGIMACRO(WS_MINIMIZEBOX)
+        REGIMACRO(WS_MAXIMIZEBOX)
+        REGIMACRO(WS_OVERLAPPEDWINDOW)
+        REGIMACRO(WS_POPUPWINDOW)
+        REGIMACRO(WS_VSCROLL)
+        REGIMACRO(WS_HSCROLL)
+        REGIMACRO(WS_GROUP)
+        REGIMACRO(WS_TABSTOP)
+        REGIMACRO(WS_DISABLED)
+        REGIMACRO(WS_CLIPSIBLINGS)
+        REGIMACRO(WS_CLIPCHILDREN)
+        REGIMACRO(WS_MINIMIZE)
+        REGIMACRO(WS_MAXIMIZE)
+
+        // M�s macros comunes para ShowWindow y dem�s
+        REGIMACRO(SW_SHOW)
+        REGIMACRO(SW_HIDE)
+        REGIMACRO(SW_MINIMIZE)
+        REGIMACRO(SW_MAXIMIZE)
+        REGIMACRO(SW_RESTORE)
+        REGIMACRO(SW_SHOWDEFAULT)
+        REGIMACRO(SW_FORCEMINIMIZE)
+        REGIMACRO(SW_SHOWNOACTIVATE)
+        REGIMACRO(SW_SHOWNA)
+        REGIMACRO(SW_SHOWNORMAL)
+        REGIMACRO(SW_SHOWMINIMIZED)
+        REGIMACRO(SW_SHOWMAXIMIZED)
+        REGIMACRO(SW_SHOWNOACTIVATE)
+        REGIMACRO(SW_RESTORE)
+        REGIMACRO(SW_MINIMIZE)
+        REGIMACRO(SW_MAX)
+        // Estilos extendidos
+        REGIMACRO(WS_EX_APPWINDOW)
+        REGIMACRO(WS_EX_CLIENTEDGE)
+        REGIMACRO(WS_EX_TOOLWINDOW)
+        // Constantes CW_ para posici�n y tama�o por defecto
+        REGIMACRO(CW_USEDEFAULT)
+        // Lang
+        REGIMACRO(LANG_NEUTRAL)
+        REGIMACRO(SUBLANG_DEFAULT)
+        // Constantes MB_ para message box
+        REGIMACRO(MB_OK)                  // Bot�n OK
+        REGIMACRO(MB_OKCANCEL)            // Botones OK y Cancel
+        REGIMACRO(MB_ABORTRETRYIGNORE)    // Botones Abort, Retry, Ignore
+        REGIMACRO(MB_YESNOCANCEL)         // Botones Yes, No, Cancel
+        REGIMACRO(MB_YESNO)               // Botones Yes y No
+        REGIMACRO(MB_RETRYCANCEL)         // Botones Retry y Cancel
+        REGIMACRO(MB_CANCELTRYCONTINUE)   // Botones Cancel, Try, Continue
+
+        REGIMACRO(MB_ICONHAND)            // Icono de error (hand/crash)
+        REGIMACRO(MB_ICONQUESTION)        // Icono de pregunta
+        REGIMACRO(MB_ICONEXCLAMATION)     // Icono de advertencia
+        REGIMACRO(MB_ICONASTERISK)        // Icono de informaci�n
+        REGIMACRO(MB_USERICON)            // Icono personalizado del usuario
+        REGIMACRO(MB_ICONWARNING)         // Alias de MB_ICONEXCLAMATION
+        REGIMACRO(MB_ICONERROR)           // Alias de MB_ICONHAND
+        REGIMACRO(MB_ICONINFORMATION)     // Alias de MB_ICONASTERISK
+        REGIMACRO(MB_ICONSTOP)            // Alias de MB_ICONHAND
+
+        // Constantes ID_ generalmente usadas para el MSGBOX
+        REGIMACRO(IDOK)
+        REGIMACRO(IDCANCEL)
+        REGIMACRO(IDABORT)
+        REGIMACRO(IDRETRY)
+        REGIMACRO(IDIGNORE)
+        REGIMACRO(IDYES)
+        REGIMACRO(IDNO)
+        REGIMACRO(IDTRYAGAIN)
+        REGIMACRO(IDCONTINUE)
+        // Format message
+        REGIMACRO(FORMAT_MESSAGE_ALLOCATE_BUFFER)
+        REGIMACRO(FORMAT_MESSAGE_FROM_SYSTEM)
+        REGIMACRO(FORMAT_MESSAGE_IGNORE_INSERTS)
+        // Color
+        REGIMACRO(COLOR_WINDOW)
+        REGIMACRO(COLOR_BTNFACE)
+        REGIMACRO(COLOR_HIGHLIGHT)
+        REGIMACRO(COLOR_SCROLLBAR)
+        // HWnds predefinidos (handles especiales)
+        REGUMACRO(HWND, HWND_DESKTOP)
+        REGUMACRO(HWND, HWND_BOTTOM)
+        REGUMACRO(HWND, HWND_TOP)
+        REGUMACRO(HWND, HWND_TOPMOST)
+        REGUMACRO(HWND, HWND_NOTOPMOST)
+        // Sleep
+        REGIMACRO(WAIT_IO_COMPLETION)
+        // PM messages
+        REGIMACRO(PM_REMOVE)
+        REGIMACRO(PM_NOYIELD)
+        REGIMACRO(PM_NOREMOVE)
+        // Proceso
+        REGIMACRO(PROCESS_ALL_ACCESS)
+        REGIMACRO(PROCESS_VM_READ)
+        REGIMACRO(PROCESS_QUERY_INFORMATION)
+        // Button
+        REGIMACRO(BS_PUSHBUTTON)
+        REGIMACRO(BS_DEFPUSHBUTTON)
+        REGIMACRO(BS_CHECKBOX)
+        REGIMACRO(BS_AUTOCHECKBOX)
+        REGIMACRO(BS_RADIOBUTTON)
+        REGIMACRO(BS_3STATE)
+        REGIMACRO(BS_AUTO3STATE)
+        REGIMACRO(BS_GROUPBOX)
+        REGIMACRO(BS_USERBUTTON)
+        REGIMACRO(BS_AUTORADIOBUTTON)
+        REGIMACRO(BS_OWNERDRAW)
+        REGIMACRO(BS_PUSHLIKE)
+        REGIMACRO(BS_FLAT)
+        REGIMACRO(BS_RIGHTBUTTON)
+
+        // System metrics
+        REGIMACRO(SM_CXSCREEN)
+        REGIMACRO(SM_CYSCREEN)
+        REGIMACRO(SM_CXVSCROLL)
+        REGIMACRO(SM_CYHSCROLL)
+        REGIMACRO(SM_CYCAPTION)
+        REGIMACRO(SM_CXBORDER)
+        REGIMACRO(SM_CYBORDER)
+        REGIMACRO(SM_CXDLGFRAME)
+        REGIMACRO(SM_CYDLGFRAME)
+        REGIMACRO(SM_CYVTHUMB)
+        REGIMACRO(SM_CXHTHUMB)
+        REGIMACRO(SM_CXICON)
+        REGIMACRO(SM_CYICON)
+        REGIMACRO(SM_CXCURSOR)
+        REGIMACRO(SM_CYCURSOR)
+        REGIMACRO(SM_CYMENU)
+        REGIMACRO(SM_CXFULLSCREEN)
+        REGIMACRO(SM_CYFULLSCREEN)
+        REGIMACRO(SM_CYKANJIWINDOW)
+        REGIMACRO(SM_MOUSEPRESENT)
+        REGIMACRO(SM_CYVSCROLL)
+        REGIMACRO(SM_CXHSCROLL)
+        REGIMACRO(SM_DEBUG)
+        REGIMACRO(SM_SWAPBUTTON)
+        REGIMACRO(SM_RESERVED1)
+        REGIMACRO(SM_RESERVED2)
+        REGIMACRO(SM_RESERVED3)
+        REGIMACRO(SM_RESERVED4)
+        REGIMACRO(SM_CXMIN)
+        REGIMACRO(SM_CYMIN)
+        REGIMACRO(SM_CXSIZE)
+        REGIMACRO(SM_CYSIZE)
+        REGIMACRO(SM_CXFRAME)
+        REGIMACRO(SM_CYFRAME)
+        REGIMACRO(SM_CXMINTRACK)
+        REGIMACRO(SM_CYMINTRACK)
+        REGIMACRO(SM_CXDOUBLECLK)
+        REGIMACRO(SM_CYDOUBLECLK)
+        REGIMACRO(SM_CXICONSPACING)
+        REGIMACRO(SM_CYICONSPACING)
+        REGIMACRO(SM_MENUDROPALIGNMENT)
+        REGIMACRO(SM_PENWINDOWS)
+        REGIMACRO(SM_DBCSENABLED)
+        REGIMACRO(SM_CMOUSEBUTTONS)
+        REGIMACRO(SM_CXFIXEDFRAME)
+        REGIMACRO(SM_CYFIXEDFRAME)
+        REGIMACRO(SM_CXSIZEFRAME)
+        REGIMACRO(SM_CYSIZEFRAME)
+        REGIMACRO(SM_SECURE)
+        REGIMACRO(SM_CXEDGE)
+        REGIMACRO(SM_CYEDGE)
+        REGIMACRO(SM_CXMINSPACING)
+        REGIMACRO(SM_CYMINSPACING)
+        REGIMACRO(SM_CXSMICON)
+        REGIMACRO(SM_CYSMICON)
+        REGIMACRO(SM_CYSMCAPTION)
+        REGIMACRO(SM_CXSMSIZE)
+        REGIMACRO(SM_CYSMSIZE)
+        REGIMACRO(SM_CXMENUSIZE)
+        REGIMACRO(SM_CYMENUSIZE)
+        REGIMACRO(SM_ARRANGE)
+        REGIMACRO(SM_CXMINIMIZED)
+        REGIMACRO(SM_CYMINIMIZED)
+        REGIMACRO(SM_CXMAXTRACK)
+        REGIMACRO(SM_CYMAXTRACK)
+        REGIMACRO(SM_CXMAXIMIZED)
+        REGIMACRO(SM_CYMAXIMIZED)
+        REGIMACRO(SM_NETWORK)
+        REGIMACRO(SM_CLEANBOOT)
+        REGIMACRO(SM_CXDRAG)
+        REGIMACRO(SM_CYDRAG)
+        REGIMACRO(SM_SHOWSOUNDS)
+        REGIMACRO(SM_CXMENUCHECK)
+        REGIMACRO(SM_CYMENUCHECK)
+        REGIMACRO(SM_SLOWMACHINE)
+        REGIMACRO(SM_MIDEASTENABLED)
+        REGIMACRO(SM_MOUSEWHEELPRESENT)
+        REGIMACRO(SM_XVIRTUALSCREEN)
+        REGIMACRO(SM_YVIRTUALSCREEN)
+        REGIMACRO(SM_CXVIRTUALSCREEN)
+        REGIMACRO(SM_CYVIRTUALSCREEN)
+        REGIMACRO(SM_CMONITORS)
+        REGIMACRO(SM_SAMEDISPLAYFORMAT)
+        REGIMACRO(SM_IMMENABLED)
+        REGIMACRO(SM_CXFOCUSBORDER)
+        REGIMACRO(SM_CYFOCUSBORDER)
+        REGIMACRO(SM_TABLETPC)
+        REGIMACRO(SM_SERVERR2)
+
+        REGIMACRO(SWP_NOSIZE)
+        REGIMACRO(SWP_NOMOVE)
+        REGIMACRO(SWP_NOZORDER)
+        REGIMACRO(SWP_NOREDRAW)
+        REGIMACRO(SWP_NOACTIVATE)
+        REGIMACRO(SWP_FRAMECHANGED)
+        REGIMACRO(SWP_SHOWWINDOW)
+        REGIMACRO(SWP_HIDEWINDOW)
+        REGIMACRO(SWP_NOCOPYBITS)
+        REGIMACRO(SWP_NOOWNERZORDER)
+        REGIMACRO(SWP_NOSENDCHANGING)
+        REGIMACRO(SWP_DRAWFRAME)
+        REGIMACRO(SWP_NOREPOSITION)
+        REGIMACRO(SWP_DEFERERASE)
+        REGIMACRO(SWP_ASYNCWINDOWPOS)
+
+        REGIMACRO(WS_EX_DLGMODALFRAME)
+REGIMACRO(WS_EX_NOPARENTNOTIFY)
+REGIMACRO(WS_EX_TOPMOST)
+REGIMACRO(WS_EX_ACCEPTFILES)
+REGIMACRO(WS_EX_TRANSPARENT)
+REGIMACRO(WS_EX_MDICHILD)
+REGIMACRO(WS_EX_TOOLWINDOW)
+REGIMACRO(WS_EX_WINDOWEDGE)
+REGIMACRO(WS_EX_CLIENTEDGE)
+REGIMACRO(WS_EX_CONTEXTHELP)
+REGIMACRO(WS_EX_RIGHT)
+REGIMACRO(WS_EX_LEFT)
+REGIMACRO(WS_EX_RTLREADING)
+REGIMACRO(WS_EX_LTRREADING)
+REGIMACRO(WS_EX_LEFTSCROLLBAR)
+REGIMACRO(WS_EX_RIGHTSCROLLBAR)
+REGIMACRO(WS_EX_CONTROLPARENT)
+REGIMACRO(WS_EX_STATICEDGE)
+REGIMACRO(WS_EX_APPWINDOW)
+REGIMACRO(WS_EX_OVERLAPPEDWINDOW)
+REGIMACRO(WS_EX_PALETTEWINDOW)
+REGIMACRO(WS_EX_LAYERED)
+REGIMACRO(WS_EX_NOINHERITLAYOUT)
+REGIMACRO(WS_EX_NOREDIRECTIONBITMAP)
+REGIMACRO(WS_EX_LAYOUTRTL)
+REGIMACRO(WS_EX_COMPOSITED)
+REGIMACRO(WS_EX_NOACTIVATE)
+// LWA_* and ULW_*
+REGIMACRO(LWA_COLORKEY)
+REGIMACRO(LWA_ALPHA)
+REGIMACRO(ULW_COLORKEY)
+REGIMACRO(ULW_ALPHA)
+REGIMACRO(ULW_OPAQUE)
+END_CONSTANTS(commonwinutils_constants)
+
+INIT_CONSTANTS(icon_constants)
+    REGUMACRO(LPSTR, IDI_APPLICATION)
+END_CONSTANTS(icon_constants)
+
+INIT_CONSTANTS(vkeys_constants)
+	REGIMACRO(VK_LBUTTON)
+		REGIMACRO(VK_RBUTTON)
+		REGIMACRO(VK_CANCEL)
+		REGIMACRO(VK_MBUTTON)
+		REGIMACRO(VK_XBUTTON1)
+		REGIMACRO(VK_XBUTTON2)
+		REGIMACRO(VK_BACK)
+		REGIMACRO(VK_TAB)
+		REGIMACRO(VK_CLEAR)
+		REGIMACRO(VK_RETURN)
+		REGIMACRO(VK_SHIFT)
+		REGIMACRO(VK_CONTROL)
+		REGIMACRO(VK_MENU)
+		REGIMACRO(VK_PAUSE)
+		REGIMACRO(VK_CAPITAL)
+		REGIMACRO(VK_KANA)
+		REGIMACRO(VK_HANGUL)
+		REGIMACRO(VK_JUNJA)
+		REGIMACRO(VK_FINAL)
+		REGIMACRO(VK_HANJA)
+		REGIMACRO(VK_KANJI)
+		REGIMACRO(VK_ESCAPE)
+		REGIMACRO(VK_CONVERT)
+		REGIMACRO(VK_NONCONVERT)
+		REGIMACRO(VK_ACCEPT)
+		REGIMACRO(VK_MODECHANGE)
+		REGIMACRO(VK_SPACE)
+		REGIMACRO(VK_PRIOR)
+		REGIMACRO(VK_NEXT)
+		REGIMACRO(VK_END)
+		REGIMACRO(VK_HOME)
+		REGIMACRO(VK_LEFT)
+		REGIMACRO(VK_UP)
+		REGIMACRO(VK_RIGHT)
+		REGIMACRO(VK_DOWN)
+		REGIMACRO(VK_SELECT)
+		REGIMACRO(VK_PRINT)
+		REGIMACRO(VK_EXECUTE)
+		REGIMACRO(VK_SNAPSHOT)
+		REGIMACRO(VK_INSERT)
+		REGIMACRO(VK_DELETE)
+		REGIMACRO(VK_HELP)
+		REGIMACRO(VK_LWIN)
+		REGIMACRO(VK_RWIN)
+		REGIMACRO(VK_APPS)
+		REGIMACRO(VK_SLEEP)
+		REGIMACRO(VK_NUMPAD0)
+		REGIMACRO(VK_NUMPAD1)
+		REGIMACRO(VK_NUMPAD2)
+		REGIMACRO(VK_NUMPAD3)
+		REGIMACRO(VK_NUMPAD4)
+		REGIMACRO(VK_NUMPAD5)
+		REGIMACRO(VK_NUMPAD6)
+		REGIMACRO(VK_NUMPAD7)
+		REGIMACRO(VK_NUMPAD8)
+		REGIMACRO(VK_NUMPAD9)
+		REGIMACRO(VK_MULTIPLY)
+		REGIMACRO(VK_ADD)
+		REGIMACRO(VK_SEPARATOR)
+		REGIMACRO(VK_SUBTRACT)
+		REGIMACRO(VK_DECIMAL)
+		REGIMACRO(VK_DIVIDE)
+		REGIMACRO(VK_F1)
+		REGIMACRO(VK_F2)
+		REGIMACRO(VK_F3)
+		REGIMACRO(VK_F4)
+		REGIMACRO(VK_F5)
+		REGIMACRO(VK_F6)
+		REGIMACRO(VK_F7)
+		REGIMACRO(VK_F8)
+		REGIMACRO(VK_F9)
+		REGIMACRO(VK_F10)
+		REGIMACRO(VK_F11)
+		REGIMACRO(VK_F12)
+		REGIMACRO(VK_F13)
+		REGIMACRO(VK_F14)
+		REGIMACRO(VK_F15)
+		REGIMACRO(VK_F16)
+		REGIMACRO(VK_F17)
+		REGIMACRO(VK_F18)
+		REGIMACRO(VK_F19)
+		REGIMACRO(VK_F20)
+		REGIMACRO(VK_F21)
+		REGIMACRO(VK_F22)
+		REGIMACRO(VK_F23)
+		REGIMACRO(VK_F24)
+		REGIMACRO(VK_NUMLOCK)
+		REGIMACRO(VK_SCROLL)
+		REGIMACRO(VK_OEM_NEC_EQUAL)
+		REGIMACRO(VK_OEM_FJ_JISHO)
+		REGIMACRO(VK_OEM_FJ_MASSHOU)
+		REGIMACRO(VK_OEM_FJ_TOUROKU)
+		REGIMACRO(VK_OEM_FJ_LOYA)
+		REGIMACRO(VK_OEM_FJ_ROYA)
+		REGIMACRO(VK_LSHIFT)
+		REGIMACRO(VK_RSHIFT)
+		REGIMACRO(VK_LCONTROL)
+		REGIMACRO(VK_RCONTROL)
+		REGIMACRO(VK_LMENU)
+		REGIMACRO(VK_RMENU)
+		REGIMACRO(VK_PROCESSKEY)
+		REGIMACRO(VK_PACKET)
+		REGIMACRO(VK_ATTN)
+		REGIMACRO(VK_CRSEL)
+		REGIMACRO(VK_EXSEL)
+		REGIMACRO(VK_EREOF)
+		REGIMACRO(VK_PLAY)
+		REGIMACRO(VK_ZOOM)
+		REGIMACRO(VK_NONAME)
+		REGIMACRO(VK_PA1)
+		REGIMACRO(VK_OEM_CLEAR)
+		REGIMACRO(VK_OEM_AX)
+		REGIMACRO(VK_OEM_102)
+		REGIMACRO(VK_OEM_1)
+		REGIMACRO(VK_OEM_PLUS)
+		REGIMACRO(VK_OEM_COMMA)
+		REGIMACRO(VK_OEM_MINUS)
+		REGIMACRO(VK_OEM_PERIOD)
+		REGIMACRO(VK_OEM_2)
+		REGIMACRO(VK_OEM_3)
+		REGIMACRO(VK_OEM_4)
+		REGIMACRO(VK_OEM_5)
+		REGIMACRO(VK_OEM_6)
+		REGIMACRO(VK_OEM_7)
+		REGIMACRO(VK_OEM_8)
+		REGIMACRO(VK_BROWSER_BACK)
+		REGIMACRO(VK_BROWSER_FORWARD)
+		REGIMACRO(VK_BROWSER_REFRESH)
+		REGIMACRO(VK_BROWSER_STOP)
+		REGIMACRO(VK_BROWSER_SEARCH)
+		REGIMACRO(VK_BROWSER_FAVORITES)
+		REGIMACRO(VK_BROWSER_HOME)
+		REGIMACRO(VK_VOLUME_MUTE)
+		REGIMACRO(VK_VOLUME_DOWN)
+		REGIMACRO(VK_VOLUME_UP)
+		REGIMACRO(VK_MEDIA_NEXT_TRACK)
+		REGIMACRO(VK_MEDIA_PREV_TRACK)
+		REGIMACRO(VK_MEDIA_STOP)
+		REGIMACRO(VK_MEDIA_PLAY_PAUSE)
+		REGIMACRO(VK_LAUNCH_MAIL)
+		REGIMACRO(VK_LAUNCH_MEDIA_SELECT)
+		REGIMACRO(VK_LAUNCH_APP1)
+		REGIMACRO(VK_LAUNCH_APP2)
+END_CONSTANTS(vkeys_constants)
+CONSTANT_FAMILY(vkeys_constants, vk_family, "VK_")
+
+INIT_CONSTANTS(render_constants)
+    REGIMACRO(SRCCOPY)
+    REGIMACRO(SRCPAINT)
+    REGIMACRO(SRCAND)
+    REGIMACRO(SRCINVERT)
+    REGIMACRO(SRCERASE)
+    REGIMACRO(NOTSRCCOPY)
+    REGIMACRO(NOTSRCERASE)
+    REGIMACRO(MERGECOPY)
+    REGIMACRO(MERGEPAINT)
+    REGIMACRO(PATCOPY)
+    REGIMACRO(PATPAINT)
+    REGIMACRO(PATINVERT)
+    REGIMACRO(DSTINVERT)
+    REGIMACRO(BLACKNESS)
+    REGIMACRO(WHITENESS)
+    // background modes
+	REGIMACRO(TRANSPARENT)
+    REGIMACRO(OPAQUE)
+    REGIMACRO(BKMODE_LAST)
+END_CONSTANTS(render_constants)
+CONSTANT_FAMILY(render_constants, src_family, "SRC")
+
+INIT_CONSTANTS(sound_constants)
+    REGIMACRO(SND_SYNC)
+    REGIMACRO(SND_ASYNC)
+    REGIMACRO(SND_NODEFAULT)
+    REGIMACRO(SND_MEMORY)
+    REGIMACRO(SND_LOOP)
+    REGIMACRO(SND_NOSTOP)
+    REGIMACRO(SND_NOWAIT)
+    REGIMACRO(SND_ALIAS)
+    REGIMACRO(SND_ALIAS_ID)
+    REGIMACRO(SND_FILENAME)
+    REGIMACRO(SND_RESOURCE)
+    REGIMACRO(SND_PURGE)
+    REGIMACRO(SND_APPLICATION)
+    REGIMACRO(SND_SYSTEM)
+    REGIMACRO(SND_RING)
+END_CONSTANTS(sound_constants)
+
+INIT_CONSTANTS(style_constants)
+	REGIMACRO(CS_VREDRAW)
+	REGIMACRO(CS_HREDRAW)
+	REGIMACRO(CS_OWNDC)
+	REGIMACRO(CS_CLASSDC)
+	REGIMACRO(CS_PARENTDC)
+	REGIMACRO(CS_NOCLOSE)
+	REGIMACRO(CS_SAVEBITS)
+	REGIMACRO(CS_BYTEALIGNCLIENT)
+	REGIMACRO(CS_BYTEALIGNWINDOW)
+	REGIMACRO(CS_GLOBALCLASS)
+	REGIMACRO(CS_DBLCLKS)
+	REGIMACRO(CS_IME)
+	REGIMACRO(CS_DROPSHADOW)
+END_CONSTANTS(style_constants)
+CONSTANT_FAMILY(style_constants, cs_family, "CS_")
+
+INIT_CONSTANTS(wm_constants)
+    REGIMACRO(WM_NULL)
+        REGIMACRO(WM_CREATE)
+        REGIMACRO(WM_DESTROY)
+        REGIMACRO(WM_MOVE)
+        REGIMACRO(WM_SIZE)
+        REGIMACRO(WM_ACTIVATE)
+        REGIMACRO(WM_SETFOCUS)
+        REGIMACRO(WM_KILLFOCUS)
+        REGIMACRO(WM_ENABLE)
+        REGIMACRO(WM_SETREDRAW)
+        REGIMACRO(WM_SETTEXT)
+        REGIMACRO(WM_GETTEXT)
+        REGIMACRO(WM_GETTEXTLENGTH)
+        REGIMACRO(WM_PAINT)
+        REGIMACRO(WM_CLOSE)
+        REGIMACRO(WM_QUERYENDSESSION)
+        REGIMACRO(WM_QUIT)
+        REGIMACRO(WM_QUERYOPEN)
+        REGIMACRO(WM_ERASEBKGND)
+        REGIMACRO(WM_SYSCOLORCHANGE)
+        REGIMACRO(WM_ENDSESSION)
+        REGIMACRO(WM_SHOWWINDOW)
+        REGIMACRO(WM_WININICHANGE)
+        REGIMACRO(WM_SETTINGCHANGE)
+        REGIMACRO(WM_DEVMODECHANGE)
+        REGIMACRO(WM_ACTIVATEAPP)
+        REGIMACRO(WM_FONTCHANGE)
+        REGIMACRO(WM_TIMECHANGE)
+        REGIMACRO(WM_CANCELMODE)
+        REGIMACRO(WM_SETCURSOR)
+        REGIMACRO(WM_MOUSEACTIVATE)
+        REGIMACRO(WM_CHILDACTIVATE)
+        REGIMACRO(WM_QUEUESYNC)
+        REGIMACRO(WM_GETMINMAXINFO)
+        REGIMACRO(WM_PAINTICON)
+        REGIMACRO(WM_ICONERASEBKGND)
+        REGIMACRO(WM_NEXTDLGCTL)
+        REGIMACRO(WM_SPOOLERSTATUS)
+        REGIMACRO(WM_DRAWITEM)
+        REGIMACRO(WM_MEASUREITEM)
+        REGIMACRO(WM_DELETEITEM)
+        REGIMACRO(WM_VKEYTOITEM)
+        REGIMACRO(WM_CHARTOITEM)
+        REGIMACRO(WM_SETFONT)
+        REGIMACRO(WM_GETFONT)
+        REGIMACRO(WM_SETHOTKEY)
+        REGIMACRO(WM_GETHOTKEY)
+        REGIMACRO(WM_QUERYDRAGICON)
+        REGIMACRO(WM_COMPAREITEM)
+        REGIMACRO(WM_GETOBJECT)
+        REGIMACRO(WM_COMPACTING)
+        REGIMACRO(WM_COMMNOTIFY)
+        REGIMACRO(WM_WINDOWPOSCHANGING)
+        REGIMACRO(WM_WINDOWPOSCHANGED)
+        REGIMACRO(WM_POWER)
+        REGIMACRO(WM_COPYDATA)
+        REGIMACRO(WM_CANCELJOURNAL)
+        REGIMACRO(WM_NOTIFY)
+        REGIMACRO(WM_INPUTLANGCHANGEREQUEST)
+        REGIMACRO(WM_INPUTLANGCHANGE)
+        REGIMACRO(WM_TCARD)
+        REGIMACRO(WM_HELP)
+        REGIMACRO(WM_USERCHANGED)
+        REGIMACRO(WM_NOTIFYFORMAT)
+        REGIMACRO(WM_CONTEXTMENU)
+        REGIMACRO(WM_STYLECHANGING)
+        REGIMACRO(WM_STYLECHANGED)
+        REGIMACRO(WM_DISPLAYCHANGE)
+        REGIMACRO(WM_GETICON)
+        REGIMACRO(WM_SETICON)
+        REGIMACRO(WM_NCCREATE)
+        REGIMACRO(WM_NCDESTROY)
+        REGIMACRO(WM_NCCALCSIZE)
+        REGIMACRO(WM_NCHITTEST)
+        REGIMACRO(WM_NCPAINT)
+        REGIMACRO(WM_NCACTIVATE)
+        REGIMACRO(WM_GETDLGCODE)
+        REGIMACRO(WM_SYNCPAINT)
+        REGIMACRO(WM_NCMOUSEMOVE)
+        REGIMACRO(WM_NCLBUTTONDOWN)
+        REGIMACRO(WM_NCLBUTTONUP)
+        REGIMACRO(WM_NCLBUTTONDBLCLK)
+        REGIMACRO(WM_NCRBUTTONDOWN)
+        REGIMACRO(WM_NCRBUTTONUP)
+        REGIMACRO(WM_NCRBUTTONDBLCLK)
+        REGIMACRO(WM_NCMBUTTONDOWN)
+        REGIMACRO(WM_NCMBUTTONUP)
+        REGIMACRO(WM_NCMBUTTONDBLCLK)
+        REGIMACRO(WM_KEYDOWN)
+        REGIMACRO(WM_KEYUP)
+        REGIMACRO(WM_CHAR)
+        REGIMACRO(WM_DEADCHAR)
+        REGIMACRO(WM_SYSKEYDOWN)
+        REGIMACRO(WM_SYSKEYUP)
+        REGIMACRO(WM_SYSCHAR)
+        REGIMACRO(WM_SYSDEADCHAR)
+        REGIMACRO(WM_UNICHAR)
+        REGIMACRO(WM_IME_STARTCOMPOSITION)
+        REGIMACRO(WM_IME_ENDCOMPOSITION)
+        REGIMACRO(WM_IME_COMPOSITION)
+        REGIMACRO(WM_IME_KEYLAST)
+        REGIMACRO(WM_INITDIALOG)
+        REGIMACRO(WM_COMMAND)
+        REGIMACRO(WM_SYSCOMMAND)
+        REGIMACRO(WM_TIMER)
+        REGIMACRO(WM_HSCROLL)
+        REGIMACRO(WM_VSCROLL)
+        REGIMACRO(WM_INITMENU)
+        REGIMACRO(WM_INITMENUPOPUP)
+        REGIMACRO(WM_MENUSELECT)
+        REGIMACRO(WM_MENUCHAR)
+        REGIMACRO(WM_ENTERIDLE)
+        REGIMACRO(WM_MENURBUTTONUP)
+        REGIMACRO(WM_MENUDRAG)
+        REGIMACRO(WM_MENUGETOBJECT)
+        REGIMACRO(WM_UNINITMENUPOPUP)
+        REGIMACRO(WM_MENUCOMMAND)
+        REGIMACRO(WM_CHANGEUISTATE)
+        REGIMACRO(WM_UPDATEUISTATE)
+        REGIMACRO(WM_QUERYUISTATE)
+        REGIMACRO(WM_CTLCOLORMSGBOX)
+        REGIMACRO(WM_CTLCOLOREDIT)
+        REGIMACRO(WM_CTLCOLORLISTBOX)
+        REGIMACRO(WM_CTLCOLORBTN)
+        REGIMACRO(WM_CTLCOLORDLG)
+        REGIMACRO(WM_CTLCOLORSCROLLBAR)
+        REGIMACRO(WM_CTLCOLORSTATIC)
+        REGIMACRO(WM_MOUSEMOVE)
+        REGIMACRO(WM_LBUTTONDOWN)
+        REGIMACRO(WM_LBUTTONUP)
+        REGIMACRO(WM_LBUTTONDBLCLK)
+        REGIMACRO(WM_RBUTTONDOWN)
+        REGIMACRO(WM_RBUTTONUP)
+        REGIMACRO(WM_RBUTTONDBLCLK)
+        REGIMACRO(WM_MBUTTONDOWN)
+        REGIMACRO(WM_MBUTTONUP)
+        REGIMACRO(WM_MBUTTONDBLCLK)
+        REGIMACRO(WM_MOUSEWHEEL)
+        REGIMACRO(WM_XBUTTONDOWN)
+        REGIMACRO(WM_XBUTTONUP)
+        REGIMACRO(WM_PARENTNOTIFY)
+        REGIMACRO(WM_ENTERMENULOOP)
+        REGIMACRO(WM_EXITMENULOOP)
+        REGIMACRO(WM_NEXTMENU)
+        REGIMACRO(WM_SIZING)
+        REGIMACRO(WM_CAPTURECHANGED)
+        REGIMACRO(WM_MOVING)
+        REGIMACRO(WM_POWERBROADCAST)
+        REGIMACRO(WM_DEVICECHANGE)
+        REGIMACRO(WM_MDICREATE)
+        REGIMACRO(WM_MDIDESTROY)
+        REGIMACRO(WM_MDIACTIVATE)
+        REGIMACRO(WM_MDIRESTORE)
+        REGIMACRO(WM_MDINEXT)
+        REGIMACRO(WM_MDIMAXIMIZE)
+        REGIMACRO(WM_MDITILE)
+        REGIMACRO(WM_MDICASCADE)
+        REGIMACRO(WM_MDIICONARRANGE)
+        REGIMACRO(WM_MDIGETACTIVE)
+        REGIMACRO(WM_MDISETMENU)
+        REGIMACRO(WM_ENTERSIZEMOVE)
+        REGIMACRO(WM_EXITSIZEMOVE)
+        REGIMACRO(WM_DROPFILES)
+        REGIMACRO(WM_MDIREFRESHMENU)
+        REGIMACRO(WM_IME_SETCONTEXT)
+        REGIMACRO(WM_IME_NOTIFY)
+        REGIMACRO(WM_IME_CONTROL)
+        REGIMACRO(WM_IME_COMPOSITIONFULL)
+        REGIMACRO(WM_IME_SELECT)
+        REGIMACRO(WM_IME_CHAR)
+        REGIMACRO(WM_IME_REQUEST)
+        REGIMACRO(WM_IME_KEYDOWN)
+        REGIMACRO(WM_IME_KEYUP)
+        REGIMACRO(WM_MOUSEHOVER)
+        REGIMACRO(WM_MOUSELEAVE)
+        REGIMACRO(WM_CUT)
+        REGIMACRO(WM_COPY)
+        REGIMACRO(WM_PASTE)
+        REGIMACRO(WM_CLEAR)
+        REGIMACRO(WM_UNDO)
+        REGIMACRO(WM_RENDERFORMAT)
+        REGIMACRO(WM_RENDERALLFORMATS)
+        REGIMACRO(WM_DESTROYCLIPBOARD)
+        REGIMACRO(WM_DRAWCLIPBOARD)
+        REGIMACRO(WM_PAINTCLIPBOARD)
+        REGIMACRO(WM_VSCROLLCLIPBOARD)
+        REGIMACRO(WM_SIZECLIPBOARD)
+        REGIMACRO(WM_ASKCBFORMATNAME)
+        REGIMACRO(WM_CHANGECBCHAIN)
+        REGIMACRO(WM_HSCROLLCLIPBOARD)
+        REGIMACRO(WM_MOUSEFIRST)
+        REGIMACRO(WM_MOUSELAST)
+        REGIMACRO(WM_QUEUESYNC)
+        REGIMACRO(WM_GETMINMAXINFO)
+        REGIMACRO(WM_ICONERASEBKGND)
+        REGIMACRO(WM_NEXTDLGCTL)
+        REGIMACRO(WM_SPOOLERSTATUS)
+        REGIMACRO(WM_DRAWITEM)
+        REGIMACRO(WM_MEASUREITEM)
+        REGIMACRO(WM_DELETEITEM)
+        REGIMACRO(WM_VKEYTOITEM)
+        REGIMACRO(WM_CHARTOITEM)
+        REGIMACRO(WM_SETFONT)
+        REGIMACRO(WM_GETFONT)
+        REGIMACRO(WM_SETHOTKEY)
+        REGIMACRO(WM_GETHOTKEY)
+        REGIMACRO(WM_QUERYDRAGICON)
+        REGIMACRO(WM_COMPAREITEM)
+        REGIMACRO(WM_GETOBJECT)
+        REGIMACRO(WM_COMPACTING)
+        REGIMACRO(WM_COMMNOTIFY)
+        REGIMACRO(WM_WINDOWPOSCHANGING)
+        REGIMACRO(WM_WINDOWPOSCHANGED)
+        REGIMACRO(WM_POWERBROADCAST)
+        REGIMACRO(WM_COPYDATA)
+            REGIMACRO(BS_PUSHBUTTON)
+            REGIMACRO(BS_DEFPUSHBUTTON)
+            REGIMACRO(BS_CHECKBOX)
+            REGIMACRO(BS_AUTOCHECKBOX)
+            REGIMACRO(BS_RADIOBUTTON)
+            REGIMACRO(BS_3STATE)
+            REGIMACRO(BS_AUTO3STATE)
+            REGIMACRO(BS_GROUPBOX)
+            REGIMACRO(BS_USERBUTTON)
+            REGIMACRO(BS_AUTORADIOBUTTON)
+            REGIMACRO(BS_PUSHBOX)
+            REGIMACRO(BS_OWNERDRAW)
+            REGIMACRO(BS_TYPEMASK)
+            REGIMACRO(BS_LEFTTEXT)
+            REGIMACRO(BS_TEXT)
+            REGIMACRO(BS_ICON)
+            REGIMACRO(BS_BITMAP)
+            REGIMACRO(BS_LEFT)
+            REGIMACRO(BS_RIGHT)
+            REGIMACRO(BS_CENTER)
+            REGIMACRO(BS_TOP)
+            REGIMACRO(BS_BOTTOM)
+            REGIMACRO(BS_VCENTER)
+            REGIMACRO(BS_PUSHLIKE)
+            REGIMACRO(BS_MULTILINE)
+            REGIMACRO(BS_NOTIFY)
+            REGIMACRO(BS_FLAT)
+            REGIMACRO(BS_RIGHTBUTTON)
+
+            REGIMACRO(BN_CLICKED)
+            REGIMACRO(BN_PAINT)
+            REGIMACRO(BN_HILITE)
+            REGIMACRO(BN_UNHILITE)
+            REGIMACRO(BN_DISABLE)
+            REGIMACRO(BN_DOUBLECLICKED)
+            REGIMACRO(BN_PUSHED)
+            REGIMACRO(BN_UNPUSHED)
+            REGIMACRO(BN_DBLCLK)
+            REGIMACRO(BN_SETFOCUS)
+            REGIMACRO(BN_KILLFOCUS)
+
+            REGIMACRO(BM_GETCHECK)
+            REGIMACRO(BM_SETCHECK)
+            REGIMACRO(BM_GETSTATE)
+            REGIMACRO(BM_SETSTATE)
+            REGIMACRO(BM_SETSTYLE)
+            REGIMACRO(BM_CLICK)
+            REGIMACRO(BM_GETIMAGE)
+            REGIMACRO(BM_SETIMAGE)
+            REGIMACRO(BM_SETDONTCLICK)
+
+            REGIMACRO(BST_UNCHECKED)
+            REGIMACRO(BST_CHECKED)
+            REGIMACRO(BST_INDETERMINATE)
+            REGIMACRO(BST_PUSHED)
+            REGIMACRO(BST_FOCUS)
+END_CONSTANTS(wm_constants)
+CONSTANT_FAMILY(wm_constants, wm_family, "WM_")
+
+INIT_CONSTANTS(winmemory_constants) // los macros, huevn
+    REGIMACRO(CP_ACP)         // ANSI code page
+        REGIMACRO(CP_OEMCP)       // OEM code page
+        REGIMACRO(CP_MACCP)       // Mac code page
+        REGIMACRO(CP_THREAD_ACP)  // Threads ANSI code page
+        REGIMACRO(CP_UTF7)        // UTF-7
+        REGIMACRO(CP_UTF8)        // UTF-8
+        REGIMACRO(CP_SYMBOL)      // Symbol code page
+
+        REGIMACRO(GMEM_FIXED)
+        REGIMACRO(GMEM_MOVEABLE)
+        REGIMACRO(GMEM_NOCOMPACT)
+        REGIMACRO(GMEM_NODISCARD)
+        REGIMACRO(GMEM_ZEROINIT)
+        REGIMACRO(GMEM_MODIFY)
+        REGIMACRO(GMEM_DISCARDABLE)
+        REGIMACRO(GMEM_NOT_BANKED)
+        REGIMACRO(GMEM_NOTIFY)
+        REGIMACRO(GMEM_LOWER)
+        REGIMACRO(GMEM_VALID_FLAGS)
+        REGIMACRO(GMEM_INVALID_HANDLE)
+        REGIMACRO(GMEM_DISCARDED)
+        REGIMACRO(GMEM_LOCKCOUNT)
+
+        REGIMACRO(CF_TEXT)
+        REGIMACRO(CF_BITMAP)
+        REGIMACRO(CF_METAFILEPICT)
+        REGIMACRO(CF_SYLK)
+        REGIMACRO(CF_DIF)
+        REGIMACRO(CF_TIFF)
+        REGIMACRO(CF_OEMTEXT)
+        REGIMACRO(CF_DIB)
+        REGIMACRO(CF_PALETTE)
+        REGIMACRO(CF_PENDATA)
+        REGIMACRO(CF_RIFF)
+        REGIMACRO(CF_WAVE)
+        REGIMACRO(CF_UNICODETEXT)
+        REGIMACRO(CF_ENHMETAFILE)
+        REGIMACRO(CF_HDROP)
+        REGIMACRO(CF_LOCALE)
+        REGIMACRO(CF_DIBV5)
+        REGIMACRO(CF_OWNERDISPLAY)
+        REGIMACRO(CF_DSPTEXT)
+        REGIMACRO(CF_DSPBITMAP)
+        REGIMACRO(CF_DSPMETAFILEPICT)
+        REGIMACRO(CF_DSPENHMETAFILE)
+        // Get Window Long
+        REGIMACRO(GWLP_WNDPROC)
+        REGIMACRO(GWLP_HINSTANCE)
+        REGIMACRO(GWLP_HWNDPARENT)
+        REGIMACRO(GWL_STYLE)
+        REGIMACRO(GWL_EXSTYLE)
+        REGIMACRO(GWLP_USERDATA)
+        REGIMACRO(GWL_ID)
+END_CONSTANTS(winmemory_constants)
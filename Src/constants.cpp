@@ -0,0 +1,125 @@
+static const LuaConstantTable* const constantTables[] = {
+    &cursor_constants,
+    &wm_constants,
+    &style_constants,
+    &brush_constants,
+    &icon_constants,
+    &vkeys_constants,
+    &commcontrol_constants,
+    &explorerutills_constants,
+    &winmemory_constants,
+    &commonwinutils_constants,
+    &render_constants,
+    &filesystem_constants,
+    &sound_constants,
+    &errors_constants,
+};
+static const LuaConstantFamily* const constantFamilies[] = {
+    &wm_family,
+    &vk_family,
+    &cs_family,
+    &src_family,
+};
+const LuaConstant* findLuaConstant(std::string_view name)
+{
+    uint64_t hash = luaConstantHash(name);
+    for (const LuaConstantTable* table : constantTables)
+    {
+        const LuaConstant& c = luaConstantCandidate(*table, hash);
+        if (name == c.name)
+            return &c;
+    }
+    return nullptr;
+}
+const char* luaConstantName(std::string_view prefix, lua_Integer value)
+{
+    for (const LuaConstantFamily* family : constantFamilies)
+    {
+        if (prefix != family->prefix)
+            continue;
+        const LuaConstantName* end = family->names + family->count;
+        const LuaConstantName* it = std::lower_bound(family->names, end, value, [](const LuaConstantName& n, lua_Integer v) {
+            return n.value < v;
+        });
+        return it != end && it->value == value ? it->name : nullptr;
+    }
+    for (const LuaConstantTable* table : constantTables)
+        for (size_t i = 0; i < table->count; ++i)
+            if (luaConstantInFamily(table->entries[i], prefix) && table->entries[i].value == value)
+                return table->entries[i].name;
+    return nullptr;
+}
+void pushLuaConstant(lua_State* L, const LuaConstant& c)
+{
+    if (c.push)
+        c.push(L);
+    else
+        lua_pushinteger(L, c.value);
+}
+// __index(_G, name), upvalue 1 is the previous __index or nil.
+static int constants_index(lua_State* L)
+{
+    size_t len;
+    const char* name = lua_type(L, 2) == LUA_TSTRING ? lua_tolstring(L, 2, &len) : nullptr;
+    if (const LuaConstant* c = name ? findLuaConstant({ name, len }) : nullptr)
+    {
+        pushLuaConstant(L, *c);
+        lua_pushvalue(L, 2);
+        lua_pushvalue(L, -2);
+        lua_rawset(L, 1);
+        return 1;
+    }
+    switch (lua_type(L, lua_upvalueindex(1)))
+    {
+    case LUA_TFUNCTION:
+        lua_pushvalue(L, lua_upvalueindex(1));
+        lua_pushvalue(L, 1);
+        lua_pushvalue(L, 2);
+        lua_call(L, 2, 1);
+        return 1;
+    case LUA_TNIL:
+        return 0;
+    default:
+        lua_pushvalue(L, 2);
+        lua_gettable(L, lua_upvalueindex(1));
+        return 1;
+    }
+}
+// Missing globals are looked up in the constant tables, chaining to an
+// __index the global table already had.
+void register_constants(lua_State* L)
+{
+    lua_pushglobaltable(L);
+    if (!lua_getmetatable(L, -1))
+    {
+        lua_newtable(L);
+        lua_pushvalue(L, -1);
+        lua_setmetatable(L, -3);
+    }
+    lua_getfield(L, -1, "__index");
+    lua_pushcclosure(L, constants_index, 1);
+    lua_setfield(L, -2, "__index");
+    lua_pop(L, 2);
+}
+// Empty table resolving constants on first read, luibexwin.constants.
+void push_constants_table(lua_State* L)
+{
+    lua_newtable(L);
+    lua_createtable(L, 0, 1);
+    lua_pushnil(L);
+    lua_pushcclosure(L, constants_index, 1);
+    lua_setfield(L, -2, "__index");
+    lua_setmetatable(L, -2);
+}
+
+// ConstantName(prefix, value) -> name of the constant, e.g. ConstantName("WM_", 15) is "WM_PAINT"
+Lua_Function(ConstantName)
+{
+    size_t len;
+    const char* prefix = luaL_checklstring(L, 1, &len);
+    const char* name = luaConstantName({ prefix, len }, luaL_checkinteger(L, 2));
+    if (!name)
+        return 0;
+    lua_pushstring(L, name);
+    return 1;
+}
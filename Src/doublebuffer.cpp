@@ -0,0 +1,216 @@
+#define DOUBLEBUFFER_SUBCLASS_ID 0x4C444231
+// The back bitmap only grows, in steps of this many pixels, so resizing a
+// window does not recreate it on every WM_SIZE.
+constexpr int DOUBLEBUFFER_GROW = 64;
+struct DoubleBuffer
+{
+    HDC dc = NULL;
+    HBITMAP bitmap = NULL;
+    HGDIOBJ oldBitmap = NULL;
+    int width = 0;
+    int height = 0;
+    HRGN dirty = NULL;
+    HDC paintDC = NULL;
+};
+static std::unordered_map<HWND, DoubleBuffer> doubleBuffers;
+
+static DoubleBuffer* findDoubleBuffer(HWND hwnd)
+{
+    auto it = doubleBuffers.find(hwnd);
+    return it == doubleBuffers.end() ? nullptr : &it->second;
+}
+static bool ensureBackBuffer(HWND hwnd, DoubleBuffer& db, int width, int height)
+{
+    if (width <= db.width && height <= db.height)
+        return true;
+    int newWidth = std::max(db.width, (width + DOUBLEBUFFER_GROW - 1) / DOUBLEBUFFER_GROW * DOUBLEBUFFER_GROW);
+    int newHeight = std::max(db.height, (height + DOUBLEBUFFER_GROW - 1) / DOUBLEBUFFER_GROW * DOUBLEBUFFER_GROW);
+    HDC windowDC = GetDC(hwnd);
+    HBITMAP bitmap = CreateCompatibleBitmap(windowDC, newWidth, newHeight);
+    if (!db.dc)
+        db.dc = CreateCompatibleDC(windowDC);
+    ReleaseDC(hwnd, windowDC);
+    if (!bitmap || !db.dc)
+    {
+        if (bitmap)
+            DeleteObject(bitmap);
+        return false;
+    }
+    if (db.bitmap)
+    {
+        // Keep what was already painted, only the new area needs a repaint.
+        HDC copyDC = CreateCompatibleDC(db.dc);
+        HGDIOBJ prev = SelectObject(copyDC, bitmap);
+        BitBlt(copyDC, 0, 0, db.width, db.height, db.dc, 0, 0, SRCCOPY);
+        SelectObject(copyDC, prev);
+        DeleteDC(copyDC);
+        SelectObject(db.dc, bitmap);
+        DeleteObject(db.bitmap);
+    }
+    else
+        db.oldBitmap = SelectObject(db.dc, bitmap);
+    db.bitmap = bitmap;
+    db.width = newWidth;
+    db.height = newHeight;
+    return true;
+}
+static void releaseDoubleBuffer(DoubleBuffer& db)
+{
+    if (db.dc)
+    {
+        SelectClipRgn(db.dc, NULL);
+        SelectObject(db.dc, db.oldBitmap);
+        DeleteDC(db.dc);
+    }
+    if (db.bitmap)
+        DeleteObject(db.bitmap);
+    if (db.dirty)
+        DeleteObject(db.dirty);
+}
+static void disableDoubleBuffer(HWND hwnd);
+static LRESULT CALLBACK doubleBufferProc(HWND hwnd, UINT msg, WPARAM wp, LPARAM lp, UINT_PTR, DWORD_PTR)
+{
+    switch (msg)
+    {
+    case WM_ERASEBKGND:
+        if (findDoubleBuffer(hwnd))
+            return 1;
+        break;
+    case WM_SIZE:
+        if (DoubleBuffer* db = findDoubleBuffer(hwnd))
+            ensureBackBuffer(hwnd, *db, LOWORD(lp), HIWORD(lp));
+        break;
+    case WM_NCDESTROY:
+        disableDoubleBuffer(hwnd);
+        break;
+    }
+    return DefSubclassProc(hwnd, msg, wp, lp);
+}
+static void disableDoubleBuffer(HWND hwnd)
+{
+    auto it = doubleBuffers.find(hwnd);
+    if (it == doubleBuffers.end())
+        return;
+    releaseDoubleBuffer(it->second);
+    doubleBuffers.erase(it);
+    RemoveWindowSubclass(hwnd, doubleBufferProc, DOUBLEBUFFER_SUBCLASS_ID);
+}
+static std::vector<RECT> regionRects(HRGN rgn)
+{
+    std::vector<RECT> rects;
+    DWORD size = GetRegionData(rgn, 0, NULL);
+    if (size == 0)
+        return rects;
+    std::vector<char> data(size);
+    RGNDATA* rd = (RGNDATA*)data.data();
+    if (GetRegionData(rgn, size, rd) == 0)
+        return rects;
+    const RECT* first = (const RECT*)rd->Buffer;
+    rects.assign(first, first + rd->rdh.nCount);
+    return rects;
+}
+
+void doubleBufferInvalidate(HWND hwnd, const RECT* rect)
+{
+    DoubleBuffer* db = findDoubleBuffer(hwnd);
+    if (!db)
+        return;
+    RECT area;
+    if (rect)
+        area = *rect;
+    else
+        GetClientRect(hwnd, &area);
+    HRGN rgn = CreateRectRgnIndirect(&area);
+    CombineRgn(db->dirty, db->dirty, rgn, RGN_OR);
+    DeleteObject(rgn);
+}
+// The dirty region also takes whatever Windows invalidated on its own, then
+// becomes the clip region of the back buffer for the Lua painting code.
+HDC doubleBufferBeginPaint(HWND hwnd, LPPAINTSTRUCT ps)
+{
+    DoubleBuffer* db = findDoubleBuffer(hwnd);
+    if (!db)
+        return BeginPaint(hwnd, ps);
+    HRGN update = CreateRectRgn(0, 0, 0, 0);
+    if (GetUpdateRgn(hwnd, update, FALSE) != ERROR)
+        CombineRgn(db->dirty, db->dirty, update, RGN_OR);
+    DeleteObject(update);
+    HDC hdc = BeginPaint(hwnd, ps);
+    RECT client;
+    GetClientRect(hwnd, &client);
+    if (!hdc || !ensureBackBuffer(hwnd, *db, client.right, client.bottom))
+        return hdc;
+    db->paintDC = hdc;
+    SelectClipRgn(db->dc, db->dirty);
+    HBRUSH background = (HBRUSH)GetClassLongPtr(hwnd, GCLP_HBRBACKGROUND);
+    if (background)
+        for (const RECT& r : regionRects(db->dirty))
+            FillRect(db->dc, &r, background);
+    GetRgnBox(db->dirty, &ps->rcPaint);
+    ps->hdc = db->dc;
+    return db->dc;
+}
+BOOL doubleBufferEndPaint(HWND hwnd, LPPAINTSTRUCT ps)
+{
+    DoubleBuffer* db = findDoubleBuffer(hwnd);
+    if (!db || !db->paintDC)
+        return EndPaint(hwnd, ps);
+    GdiFlush();
+    for (const RECT& r : regionRects(db->dirty))
+        BitBlt(db->paintDC, r.left, r.top, r.right - r.left, r.bottom - r.top, db->dc, r.left, r.top, SRCCOPY);
+    SelectClipRgn(db->dc, NULL);
+    SetRectRgn(db->dirty, 0, 0, 0, 0);
+    ps->hdc = db->paintDC;
+    db->paintDC = NULL;
+    return EndPaint(hwnd, ps);
+}
+
+Lua_Function(EnableDoubleBuffer)
+{
+    HWND hwnd = luaL_wingetbycheckudata(L, 1, HWND);
+    if (findDoubleBuffer(hwnd))
+    {
+        lua_pushboolean(L, TRUE);
+        return 1;
+    }
+    RECT client;
+    if (!GetClientRect(hwnd, &client) || !SetWindowSubclass(hwnd, doubleBufferProc, DOUBLEBUFFER_SUBCLASS_ID, 0))
+    {
+        lua_pushboolean(L, FALSE);
+        return 1;
+    }
+    DoubleBuffer& db = doubleBuffers[hwnd];
+    db.dirty = CreateRectRgn(0, 0, 0, 0);
+    BOOL result = ensureBackBuffer(hwnd, db, client.right, client.bottom);
+    if (!result)
+        disableDoubleBuffer(hwnd);
+    else
+        InvalidateRect(hwnd, NULL, FALSE);
+    lua_pushboolean(L, result);
+    return 1;
+}
+Lua_Function(DisableDoubleBuffer)
+{
+    HWND hwnd = luaL_wingetbycheckudata(L, 1, HWND);
+    BOOL result = findDoubleBuffer(hwnd) != nullptr;
+    disableDoubleBuffer(hwnd);
+    lua_pushboolean(L, result);
+    return 1;
+}
+// GetDirtyRects(hwnd) -> array of rect tables still waiting to be painted
+Lua_Function(GetDirtyRects)
+{
+    HWND hwnd = luaL_wingetbycheckudata(L, 1, HWND);
+    DoubleBuffer* db = findDoubleBuffer(hwnd);
+    if (!db)
+        return 0;
+    std::vector<RECT> rects = regionRects(db->dirty);
+    lua_createtable(L, (int)rects.size(), 0);
+    for (size_t i = 0; i < rects.size(); ++i)
+    {
+        lua_createtable(L, 0, 4);
+        LPRECT_to_table(L, &rects[i], -1);
+        lua_rawseti(L, -2, (lua_Integer)i + 1);
+    }
+    return 1;
+}
@@ -101,10 +101,4 @@ Lua_Function(CommDlgExtendedError)
     DWORD err = CommDlgExtendedError();
     lua_pushinteger(L, (lua_Integer)err);
     return 1;
-}
-void register_errors(lua_State* L)
-{
-    REGUMACRO(HANDLE, INVALID_HANDLE_VALUE)
-    REGIMACRO(INVALID_FILE_ATTRIBUTES)
-    REGIMACRO(INVALID_SET_FILE_POINTER)
 }
\ No newline at end of file
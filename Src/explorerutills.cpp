@@ -16,7 +16,8 @@ static UINT_PTR Trampoline_OpenFNAHook(HWND hdlg, UINT uMsg, WPARAM wParam, LPAR
     }
 	luacustdatadef* dataRef = (luacustdatadef*)(ofn->lCustData);
     lua_State* L = dataRef->L;
-    lua_rawgeti(L, LUA_REGISTRYINDEX, dataRef->funcRef);
+    if (!getLWinProci(L, dataRef->funcRef, REGNAME))
+        return 0;
     pushWindowStruct(L, HWND, hdlg);
     lua_pushinteger(L, uMsg);
     lua_pushinteger(L, wParam);
@@ -37,24 +38,13 @@ static std::vector<std::unique_ptr<luacustdatadef>> luacustdatarefs;
 static std::vector<std::string> storage;
 static void cleanupRefs(lua_State* L, luacustdatadef* dataRef)
 {
-    
-    lua_pushstring(L, REGNAME);
-    lua_rawget(L, LUA_REGISTRYINDEX);
-    // Limpia el vector lua
-    for (size_t i = 1; i <= lua_rawlen(L, -1); ++i) {
-        lua_geti(L, -1, (lua_Integer)i);
-        if (lua_isinteger(L, -1)) {
-            lua_Integer refIndex = lua_tointeger(L, -1);
-            if (refIndex == dataRef->funcRef || refIndex == dataRef->custDataRef) {
-                lua_pushnil(L);
-                lua_seti(L, -3, (lua_Integer)i);
-            }
-        }
-        lua_pop(L, 1);
-	}
-    // Limpia el vector global
+    // lCustData/lParam is only ours when a Lua hook was given
     for (auto it = luacustdatarefs.begin(); it != luacustdatarefs.end(); ++it) {
         if (it->get() == dataRef) {
+            if (dataRef->funcRef)
+                removeLWinProc(L, dataRef->funcRef, REGNAME);
+            if (dataRef->custDataRef)
+                removeLWinProc(L, dataRef->custDataRef, REGNAME);
             luacustdatarefs.erase(it);
             break;
         }
@@ -132,7 +122,7 @@ static void table2lpopenfilenamea(lua_State* L, int index, LPOPENFILENAMEA lp)
     lua_pop(L, 1);
 
     lua_getfield(L, index, "lCustData");
-    if (lua_istable(L, -1)) {
+    if (hasFunc && lua_istable(L, -1)) {
         dataRef->custDataRef = addLWinProc(L, -1, REGNAME);
     }
 
@@ -187,7 +177,8 @@ static int Trampoline_BrowseFNA(HWND hwnd, UINT uMsg, LPARAM lParam, LPARAM data
     if (!cust || !cust->L) return 0;
 
     lua_State* L = cust->L;
-    lua_rawgeti(L, LUA_REGISTRYINDEX, cust->funcRef);
+    if (!getLWinProci(L, cust->funcRef, REGNAME))
+        return 0;
 
     // Pasamos los parmetros del callback a Lua
     lua_pushinteger(L, uMsg);
@@ -263,7 +254,7 @@ static void table2browseinfoa(lua_State* L, int index, LPBROWSEINFOA bi)
     lua_pop(L, 1);
 
     lua_getfield(L, index, "lParam");
-    if (lua_istable(L, -1)) {
+    if (hasFunc && lua_istable(L, -1)) {
         dataRef->custDataRef = addLWinProc(L, -1, REGNAME);
     }
 
@@ -337,48 +328,4 @@ Lua_Function(SHGetPathFromIDList)
     BOOL result = SHGetPathFromIDListA(pidl, path);
     lua_pushboolean(L, result);
     return 1;
-}
-void register_explorerutills(lua_State* L)
-{
-    REGIMACRO(MAX_PATH)
-    REGIMACRO(BIF_RETURNONLYFSDIRS)
-    REGIMACRO(BIF_DONTGOBELOWDOMAIN)
-    REGIMACRO(BIF_STATUSTEXT)
-    REGIMACRO(BIF_RETURNFSANCESTORS)
-    REGIMACRO(BIF_EDITBOX)
-    REGIMACRO(BIF_VALIDATE)
-    REGIMACRO(BIF_NEWDIALOGSTYLE)
-    REGIMACRO(BIF_USENEWUI)
-    REGIMACRO(BIF_BROWSEINCLUDEFILES)
-    REGIMACRO(BIF_BROWSEFORCOMPUTER)
-    REGIMACRO(BIF_BROWSEFORPRINTER)
-    REGIMACRO(BIF_BROWSEINCLUDEURLS)
-    REGIMACRO(BIF_BROWSEFILEJUNCTIONS)
-    REGIMACRO(OFN_READONLY)
-    REGIMACRO(OFN_OVERWRITEPROMPT)
-    REGIMACRO(OFN_HIDEREADONLY)
-    REGIMACRO(OFN_NOCHANGEDIR)
-    REGIMACRO(OFN_SHOWHELP)
-    REGIMACRO(OFN_ENABLEHOOK)
-    REGIMACRO(OFN_ENABLETEMPLATE)
-    REGIMACRO(OFN_ENABLETEMPLATEHANDLE)
-    REGIMACRO(OFN_NOVALIDATE)
-    REGIMACRO(OFN_ALLOWMULTISELECT)
-    REGIMACRO(OFN_EXTENSIONDIFFERENT)
-    REGIMACRO(OFN_PATHMUSTEXIST)
-    REGIMACRO(OFN_FILEMUSTEXIST)
-    REGIMACRO(OFN_CREATEPROMPT)
-    REGIMACRO(OFN_SHAREAWARE)
-    REGIMACRO(OFN_NOREADONLYRETURN)
-    REGIMACRO(OFN_NOTESTFILECREATE)
-    REGIMACRO(OFN_NONETWORKBUTTON)
-    REGIMACRO(OFN_NOLONGNAMES)
-    REGIMACRO(OFN_EXPLORER)
-    REGIMACRO(OFN_NODEREFERENCELINKS)
-    REGIMACRO(OFN_LONGNAMES)
-    REGIMACRO(OFN_ENABLEINCLUDENOTIFY)
-    REGIMACRO(OFN_ENABLESIZING)
-    REGIMACRO(OFN_DONTADDTORECENT)
-    REGIMACRO(OFN_FORCESHOWHIDDEN)
-
 }
\ No newline at end of file
@@ -1,28 +0,0 @@
-void register_filesystem(lua_State* L)
-{
-    REGIMACRO(FILE_ATTRIBUTE_READONLY)
-        REGIMACRO(FILE_ATTRIBUTE_HIDDEN)
-        REGIMACRO(FILE_ATTRIBUTE_SYSTEM)
-        REGIMACRO(FILE_ATTRIBUTE_DIRECTORY)
-        REGIMACRO(FILE_ATTRIBUTE_ARCHIVE)
-        REGIMACRO(FILE_ATTRIBUTE_NORMAL)
-        REGIMACRO(FILE_ATTRIBUTE_TEMPORARY)
-        REGIMACRO(FILE_ATTRIBUTE_OFFLINE)
-        REGIMACRO(FILE_ATTRIBUTE_ENCRYPTED)
-        REGIMACRO(FILE_ATTRIBUTE_COMPRESSED)
-        REGIMACRO(FILE_ATTRIBUTE_REPARSE_POINT)
-        REGIMACRO(FILE_FLAG_BACKUP_SEMANTICS)
-        REGIMACRO(FILE_FLAG_DELETE_ON_CLOSE)
-        REGIMACRO(FILE_FLAG_OVERLAPPED)
-        REGIMACRO(FILE_FLAG_NO_BUFFERING)
-        REGIMACRO(FILE_FLAG_RANDOM_ACCESS)
-        REGIMACRO(FILE_FLAG_SEQUENTIAL_SCAN)
-        REGIMACRO(GENERIC_READ)
-        REGIMACRO(GENERIC_WRITE)
-        REGIMACRO(GENERIC_EXECUTE)
-        REGIMACRO(GENERIC_ALL)
-        REGIMACRO(SECURITY_DESCRIPTOR_REVISION)
-        REGIMACRO(DACL_SECURITY_INFORMATION)
-        REGIMACRO(OWNER_SECURITY_INFORMATION)
-        REGIMACRO(GROUP_SECURITY_INFORMATION)
-}
\ No newline at end of file
@@ -367,259 +367,41 @@ Lua_Function(GetLayeredWindowAttributes)
     lua_pushboolean(L, result);
     return 1;
 }
-void register_commonwinutils(lua_State* L)
-{
-        // WS_*
-        REGIMACRO(WS_OVERLAPPED)
-        REGIMACRO(WS_POPUP)
-        REGIMACRO(WS_VISIBLE)
-        REGIMACRO(WS_CHILD)
-        REGIMACRO(WS_BORDER)
-        REGIMACRO(WS_DLGFRAME)
-        REGIMACRO(WS_CAPTION)
-        REGIMACRO(WS_SYSMENU)
-        REGIMACRO(WS_THICKFRAME)
-        REGIMACRO(WS_MINIMIZEBOX)
-        REGIMACRO(WS_MAXIMIZEBOX)
-        REGIMACRO(WS_OVERLAPPEDWINDOW)
-        REGIMACRO(WS_POPUPWINDOW)
-        REGIMACRO(WS_VSCROLL)
-        REGIMACRO(WS_HSCROLL)
-        REGIMACRO(WS_GROUP)
-        REGIMACRO(WS_TABSTOP)
-        REGIMACRO(WS_DISABLED)
-        REGIMACRO(WS_CLIPSIBLINGS)
-        REGIMACRO(WS_CLIPCHILDREN)
-        REGIMACRO(WS_MINIMIZE)
-        REGIMACRO(WS_MAXIMIZE)
-
-        // M�s macros comunes para ShowWindow y dem�s
-        REGIMACRO(SW_SHOW)
-        REGIMACRO(SW_HIDE)
-        REGIMACRO(SW_MINIMIZE)
-        REGIMACRO(SW_MAXIMIZE)
-        REGIMACRO(SW_RESTORE)
-        REGIMACRO(SW_SHOWDEFAULT)
-        REGIMACRO(SW_FORCEMINIMIZE)
-        REGIMACRO(SW_SHOWNOACTIVATE)
-        REGIMACRO(SW_SHOWNA)
-        REGIMACRO(SW_SHOWNORMAL)
-        REGIMACRO(SW_SHOWMINIMIZED)
-        REGIMACRO(SW_SHOWMAXIMIZED)
-        REGIMACRO(SW_SHOWNOACTIVATE)
-        REGIMACRO(SW_RESTORE)
-        REGIMACRO(SW_MINIMIZE)
-        REGIMACRO(SW_MAX)
-        // Estilos extendidos
-        REGIMACRO(WS_EX_APPWINDOW)
-        REGIMACRO(WS_EX_CLIENTEDGE)
-        REGIMACRO(WS_EX_TOOLWINDOW)
-        // Constantes CW_ para posici�n y tama�o por defecto
-        REGIMACRO(CW_USEDEFAULT)
-        // Lang
-        REGIMACRO(LANG_NEUTRAL)
-        REGIMACRO(SUBLANG_DEFAULT)
-        // Constantes MB_ para message box
-        REGIMACRO(MB_OK)                  // Bot�n OK
-        REGIMACRO(MB_OKCANCEL)            // Botones OK y Cancel
-        REGIMACRO(MB_ABORTRETRYIGNORE)    // Botones Abort, Retry, Ignore
-        REGIMACRO(MB_YESNOCANCEL)         // Botones Yes, No, Cancel
-        REGIMACRO(MB_YESNO)               // Botones Yes y No
-        REGIMACRO(MB_RETRYCANCEL)         // Botones Retry y Cancel
-        REGIMACRO(MB_CANCELTRYCONTINUE)   // Botones Cancel, Try, Continue
-
-        REGIMACRO(MB_ICONHAND)            // Icono de error (hand/crash)
-        REGIMACRO(MB_ICONQUESTION)        // Icono de pregunta
-        REGIMACRO(MB_ICONEXCLAMATION)     // Icono de advertencia
-        REGIMACRO(MB_ICONASTERISK)        // Icono de informaci�n
-        REGIMACRO(MB_USERICON)            // Icono personalizado del usuario
-        REGIMACRO(MB_ICONWARNING)         // Alias de MB_ICONEXCLAMATION
-        REGIMACRO(MB_ICONERROR)           // Alias de MB_ICONHAND
-        REGIMACRO(MB_ICONINFORMATION)     // Alias de MB_ICONASTERISK
-        REGIMACRO(MB_ICONSTOP)            // Alias de MB_ICONHAND
-
-        // Constantes ID_ generalmente usadas para el MSGBOX
-        REGIMACRO(IDOK)
-        REGIMACRO(IDCANCEL)
-        REGIMACRO(IDABORT)
-        REGIMACRO(IDRETRY)
-        REGIMACRO(IDIGNORE)
-        REGIMACRO(IDYES)
-        REGIMACRO(IDNO)
-        REGIMACRO(IDTRYAGAIN)
-        REGIMACRO(IDCONTINUE)
-        // Format message
-        REGIMACRO(FORMAT_MESSAGE_ALLOCATE_BUFFER)
-        REGIMACRO(FORMAT_MESSAGE_FROM_SYSTEM)
-        REGIMACRO(FORMAT_MESSAGE_IGNORE_INSERTS)
-        // Color
-        REGIMACRO(COLOR_WINDOW)
-        REGIMACRO(COLOR_BTNFACE)
-        REGIMACRO(COLOR_HIGHLIGHT)
-        REGIMACRO(COLOR_SCROLLBAR)
-        // HWnds predefinidos (handles especiales)
-        REGUMACRO(HWND, HWND_DESKTOP)
-        REGUMACRO(HWND, HWND_BOTTOM)
-        REGUMACRO(HWND, HWND_TOP)
-        REGUMACRO(HWND, HWND_TOPMOST)
-        REGUMACRO(HWND, HWND_NOTOPMOST)
-        // Sleep
-        REGIMACRO(WAIT_IO_COMPLETION)
-        // PM messages
-        REGIMACRO(PM_REMOVE)
-        REGIMACRO(PM_NOYIELD)
-        REGIMACRO(PM_NOREMOVE)
-        // Proceso
-        REGIMACRO(PROCESS_ALL_ACCESS)
-        REGIMACRO(PROCESS_VM_READ)
-        REGIMACRO(PROCESS_QUERY_INFORMATION)
-        // Button
-        REGIMACRO(BS_PUSHBUTTON)
-        REGIMACRO(BS_DEFPUSHBUTTON)
-        REGIMACRO(BS_CHECKBOX)
-        REGIMACRO(BS_AUTOCHECKBOX)
-        REGIMACRO(BS_RADIOBUTTON)
-        REGIMACRO(BS_3STATE)
-        REGIMACRO(BS_AUTO3STATE)
-        REGIMACRO(BS_GROUPBOX)
-        REGIMACRO(BS_USERBUTTON)
-        REGIMACRO(BS_AUTORADIOBUTTON)
-        REGIMACRO(BS_OWNERDRAW)
-        REGIMACRO(BS_PUSHLIKE)
-        REGIMACRO(BS_FLAT)
-        REGIMACRO(BS_RIGHTBUTTON)
-
-        // System metrics
-        REGIMACRO(SM_CXSCREEN)
-        REGIMACRO(SM_CYSCREEN)
-        REGIMACRO(SM_CXVSCROLL)
-        REGIMACRO(SM_CYHSCROLL)
-        REGIMACRO(SM_CYCAPTION)
-        REGIMACRO(SM_CXBORDER)
-        REGIMACRO(SM_CYBORDER)
-        REGIMACRO(SM_CXDLGFRAME)
-        REGIMACRO(SM_CYDLGFRAME)
-        REGIMACRO(SM_CYVTHUMB)
-        REGIMACRO(SM_CXHTHUMB)
-        REGIMACRO(SM_CXICON)
-        REGIMACRO(SM_CYICON)
-        REGIMACRO(SM_CXCURSOR)
-        REGIMACRO(SM_CYCURSOR)
-        REGIMACRO(SM_CYMENU)
-        REGIMACRO(SM_CXFULLSCREEN)
-        REGIMACRO(SM_CYFULLSCREEN)
-        REGIMACRO(SM_CYKANJIWINDOW)
-        REGIMACRO(SM_MOUSEPRESENT)
-        REGIMACRO(SM_CYVSCROLL)
-        REGIMACRO(SM_CXHSCROLL)
-        REGIMACRO(SM_DEBUG)
-        REGIMACRO(SM_SWAPBUTTON)
-        REGIMACRO(SM_RESERVED1)
-        REGIMACRO(SM_RESERVED2)
-        REGIMACRO(SM_RESERVED3)
-        REGIMACRO(SM_RESERVED4)
-        REGIMACRO(SM_CXMIN)
-        REGIMACRO(SM_CYMIN)
-        REGIMACRO(SM_CXSIZE)
-        REGIMACRO(SM_CYSIZE)
-        REGIMACRO(SM_CXFRAME)
-        REGIMACRO(SM_CYFRAME)
-        REGIMACRO(SM_CXMINTRACK)
-        REGIMACRO(SM_CYMINTRACK)
-        REGIMACRO(SM_CXDOUBLECLK)
-        REGIMACRO(SM_CYDOUBLECLK)
-        REGIMACRO(SM_CXICONSPACING)
-        REGIMACRO(SM_CYICONSPACING)
-        REGIMACRO(SM_MENUDROPALIGNMENT)
-        REGIMACRO(SM_PENWINDOWS)
-        REGIMACRO(SM_DBCSENABLED)
-        REGIMACRO(SM_CMOUSEBUTTONS)
-        REGIMACRO(SM_CXFIXEDFRAME)
-        REGIMACRO(SM_CYFIXEDFRAME)
-        REGIMACRO(SM_CXSIZEFRAME)
-        REGIMACRO(SM_CYSIZEFRAME)
-        REGIMACRO(SM_SECURE)
-        REGIMACRO(SM_CXEDGE)
-        REGIMACRO(SM_CYEDGE)
-        REGIMACRO(SM_CXMINSPACING)
-        REGIMACRO(SM_CYMINSPACING)
-        REGIMACRO(SM_CXSMICON)
-        REGIMACRO(SM_CYSMICON)
-        REGIMACRO(SM_CYSMCAPTION)
-        REGIMACRO(SM_CXSMSIZE)
-        REGIMACRO(SM_CYSMSIZE)
-        REGIMACRO(SM_CXMENUSIZE)
-        REGIMACRO(SM_CYMENUSIZE)
-        REGIMACRO(SM_ARRANGE)
-        REGIMACRO(SM_CXMINIMIZED)
-        REGIMACRO(SM_CYMINIMIZED)
-        REGIMACRO(SM_CXMAXTRACK)
-        REGIMACRO(SM_CYMAXTRACK)
-        REGIMACRO(SM_CXMAXIMIZED)
-        REGIMACRO(SM_CYMAXIMIZED)
-        REGIMACRO(SM_NETWORK)
-        REGIMACRO(SM_CLEANBOOT)
-        REGIMACRO(SM_CXDRAG)
-        REGIMACRO(SM_CYDRAG)
-        REGIMACRO(SM_SHOWSOUNDS)
-        REGIMACRO(SM_CXMENUCHECK)
-        REGIMACRO(SM_CYMENUCHECK)
-        REGIMACRO(SM_SLOWMACHINE)
-        REGIMACRO(SM_MIDEASTENABLED)
-        REGIMACRO(SM_MOUSEWHEELPRESENT)
-        REGIMACRO(SM_XVIRTUALSCREEN)
-        REGIMACRO(SM_YVIRTUALSCREEN)
-        REGIMACRO(SM_CXVIRTUALSCREEN)
-        REGIMACRO(SM_CYVIRTUALSCREEN)
-        REGIMACRO(SM_CMONITORS)
-        REGIMACRO(SM_SAMEDISPLAYFORMAT)
-        REGIMACRO(SM_IMMENABLED)
-        REGIMACRO(SM_CXFOCUSBORDER)
-        REGIMACRO(SM_CYFOCUSBORDER)
-        REGIMACRO(SM_TABLETPC)
-        REGIMACRO(SM_SERVERR2)
-
-        REGIMACRO(SWP_NOSIZE)
-        REGIMACRO(SWP_NOMOVE)
-        REGIMACRO(SWP_NOZORDER)
-        REGIMACRO(SWP_NOREDRAW)
-        REGIMACRO(SWP_NOACTIVATE)
-        REGIMACRO(SWP_FRAMECHANGED)
-        REGIMACRO(SWP_SHOWWINDOW)
-        REGIMACRO(SWP_HIDEWINDOW)
-        REGIMACRO(SWP_NOCOPYBITS)
-        REGIMACRO(SWP_NOOWNERZORDER)
-        REGIMACRO(SWP_NOSENDCHANGING)
-        REGIMACRO(SWP_DRAWFRAME)
-        REGIMACRO(SWP_NOREPOSITION)
-        REGIMACRO(SWP_DEFERERASE)
-        REGIMACRO(SWP_ASYNCWINDOWPOS)
-
-        REGIMACRO(WS_EX_DLGMODALFRAME)
-REGIMACRO(WS_EX_NOPARENTNOTIFY)
-REGIMACRO(WS_EX_TOPMOST)
-REGIMACRO(WS_EX_ACCEPTFILES)
-REGIMACRO(WS_EX_TRANSPARENT)
-REGIMACRO(WS_EX_MDICHILD)
-REGIMACRO(WS_EX_TOOLWINDOW)
-REGIMACRO(WS_EX_WINDOWEDGE)
-REGIMACRO(WS_EX_CLIENTEDGE)
-REGIMACRO(WS_EX_CONTEXTHELP)
-REGIMACRO(WS_EX_RIGHT)
-REGIMACRO(WS_EX_LEFT)
-REGIMACRO(WS_EX_RTLREADING)
-REGIMACRO(WS_EX_LTRREADING)
-REGIMACRO(WS_EX_LEFTSCROLLBAR)
-REGIMACRO(WS_EX_RIGHTSCROLLBAR)
-REGIMACRO(WS_EX_CONTROLPARENT)
-REGIMACRO(WS_EX_STATICEDGE)
-REGIMACRO(WS_EX_APPWINDOW)
-REGIMACRO(WS_EX_OVERLAPPEDWINDOW)
-REGIMACRO(WS_EX_PALETTEWINDOW)
-REGIMACRO(WS_EX_LAYERED)
-REGIMACRO(WS_EX_NOINHERITLAYOUT)
-REGIMACRO(WS_EX_NOREDIRECTIONBITMAP)
-REGIMACRO(WS_EX_LAYOUTRTL)
-REGIMACRO(WS_EX_COMPOSITED)
-REGIMACRO(WS_EX_NOACTIVATE)
+// UpdateLayeredWindow(hwnd, pb [, x, y, alpha = 255, dirty])
+// Presents a premultiplied DIB pixel buffer as the window content. x and y
+// move the window when given, dirty is a {left, top, right, bottom} table in
+// buffer coordinates limiting the update to that part of the window.
+Lua_Function(UpdateLayeredWindow)
+{
+    HWND hwnd = luaL_wingetbycheckudata(L, 1, HWND);
+    PixelBuffer* pb = checkPixelBuffer(L, 2);
+    luaL_argcheck(L, pb->dc != NULL, 2, "pixel buffer must be a DIB buffer");
+    POINT pos;
+    bool move = !lua_isnoneornil(L, 3);
+    if (move)
+    {
+        pos.x = (LONG)luaL_checkinteger(L, 3);
+        pos.y = (LONG)luaL_checkinteger(L, 4);
+    }
+    BYTE alpha = (BYTE)luaL_optinteger(L, 5, 255);
+    RECT dirty;
+    bool partial = !lua_isnoneornil(L, 6);
+    if (partial)
+        table_toLPRECT(L, 6, &dirty);
+    SIZE size = { pb->view.width, pb->view.height };
+    POINT origin = { 0, 0 };
+    BLENDFUNCTION blend = { AC_SRC_OVER, 0, alpha, AC_SRC_ALPHA };
+    UPDATELAYEREDWINDOWINFO info = { sizeof(info) };
+    info.pptDst = move ? &pos : NULL;
+    info.psize = &size;
+    info.hdcSrc = pb->dc;
+    info.pptSrc = &origin;
+    info.pblend = &blend;
+    info.dwFlags = ULW_ALPHA;
+    info.prcDirty = partial ? &dirty : NULL;
+    // Pending writes through the DIB pointer have to land before the copy.
+    GdiFlush();
+    BOOL result = UpdateLayeredWindowIndirect(hwnd, &info);
+    lua_pushboolean(L, result);
+    return 1;
 }
\ No newline at end of file
@@ -0,0 +1,196 @@
+struct GdiCacheEntry
+{
+    std::string key;
+    GdiCacheType type;
+    int refs = 0;
+    std::list<HGDIOBJ>::iterator idlePos;
+};
+// Shared by every Lua state and thread of the process.
+struct GdiCache
+{
+    std::mutex lock;
+    std::unordered_map<std::string, HGDIOBJ> byKey;
+    std::unordered_map<HGDIOBJ, GdiCacheEntry> byHandle;
+    // Unreferenced objects, most recently released first.
+    std::list<HGDIOBJ> idle;
+    size_t idleLimit = 256;
+    size_t counts[GDICACHE_TYPES] = {};
+};
+static GdiCache gdiCache;
+
+// Called with the lock held.
+static void trimGdiCache()
+{
+    while (gdiCache.idle.size() > gdiCache.idleLimit)
+    {
+        HGDIOBJ handle = gdiCache.idle.back();
+        gdiCache.idle.pop_back();
+        auto it = gdiCache.byHandle.find(handle);
+        --gdiCache.counts[it->second.type];
+        gdiCache.byKey.erase(it->second.key);
+        gdiCache.byHandle.erase(it);
+        if (GetObjectType(handle) == OBJ_FONT)
+            textMeasureForgetFont(handle);
+        DeleteObject(handle);
+    }
+}
+template<typename Create>
+static HGDIOBJ acquireGdiObject(GdiCacheType type, std::string key, Create create)
+{
+    key.insert(key.begin(), (char)type);
+    std::lock_guard<std::mutex> guard(gdiCache.lock);
+    auto found = gdiCache.byKey.find(key);
+    if (found != gdiCache.byKey.end())
+    {
+        GdiCacheEntry& entry = gdiCache.byHandle[found->second];
+        if (entry.refs++ == 0)
+            gdiCache.idle.erase(entry.idlePos);
+        return found->second;
+    }
+    HGDIOBJ handle = create();
+    if (!handle)
+        return NULL;
+    GdiCacheEntry& entry = gdiCache.byHandle[handle];
+    entry.key = key;
+    entry.type = type;
+    entry.refs = 1;
+    gdiCache.byKey.emplace(std::move(key), handle);
+    ++gdiCache.counts[type];
+    return handle;
+}
+template<typename... T>
+static std::string gdiCacheKey(const T&... values)
+{
+    std::string key;
+    (key.append((const char*)&values, sizeof(values)), ...);
+    return key;
+}
+
+HBRUSH gdiCacheSolidBrush(COLORREF color)
+{
+    return (HBRUSH)acquireGdiObject(GDICACHE_BRUSH, gdiCacheKey(color), [&] { return CreateSolidBrush(color); });
+}
+bool gdiCacheRelease(HGDIOBJ handle)
+{
+    std::lock_guard<std::mutex> guard(gdiCache.lock);
+    auto it = gdiCache.byHandle.find(handle);
+    if (it == gdiCache.byHandle.end())
+        return false;
+    GdiCacheEntry& entry = it->second;
+    if (entry.refs > 0 && --entry.refs == 0)
+    {
+        gdiCache.idle.push_front(handle);
+        entry.idlePos = gdiCache.idle.begin();
+        trimGdiCache();
+    }
+    return true;
+}
+bool gdiCacheOwns(HGDIOBJ handle)
+{
+    std::lock_guard<std::mutex> guard(gdiCache.lock);
+    return gdiCache.byHandle.count(handle) != 0;
+}
+bool gdiCacheForget(HGDIOBJ handle)
+{
+    std::lock_guard<std::mutex> guard(gdiCache.lock);
+    auto it = gdiCache.byHandle.find(handle);
+    if (it == gdiCache.byHandle.end())
+        return false;
+    if (it->second.refs == 0)
+        gdiCache.idle.erase(it->second.idlePos);
+    --gdiCache.counts[it->second.type];
+    gdiCache.byKey.erase(it->second.key);
+    gdiCache.byHandle.erase(it);
+    return true;
+}
+
+Lua_Function(CachedSolidBrush)
+{
+    HBRUSH brush = gdiCacheSolidBrush((COLORREF)luaL_checkinteger(L, 1));
+    pushWindowStruct(L, HBRUSH, brush);
+    return 1;
+}
+// CachedPen(style, width, color)
+Lua_Function(CachedPen)
+{
+    int style = (int)luaL_checkinteger(L, 1);
+    int width = (int)luaL_checkinteger(L, 2);
+    COLORREF color = (COLORREF)luaL_checkinteger(L, 3);
+    HGDIOBJ pen = acquireGdiObject(GDICACHE_PEN, gdiCacheKey(style, width, color), [&] { return CreatePen(style, width, color); });
+    pushWindowStruct(L, HPEN, pen);
+    return 1;
+}
+// CachedFont(face, height [, weight, italic, underline, strikeout, quality, charset])
+Lua_Function(CachedFont)
+{
+    size_t faceLen;
+    const char* face = luaL_checklstring(L, 1, &faceLen);
+    luaL_argcheck(L, faceLen < LF_FACESIZE, 1, "face name too long");
+    int height = (int)luaL_checkinteger(L, 2);
+    int weight = (int)luaL_optinteger(L, 3, FW_NORMAL);
+    DWORD italic = (DWORD)lua_toboolean(L, 4);
+    DWORD underline = (DWORD)lua_toboolean(L, 5);
+    DWORD strikeout = (DWORD)lua_toboolean(L, 6);
+    DWORD quality = (DWORD)luaL_optinteger(L, 7, DEFAULT_QUALITY);
+    DWORD charset = (DWORD)luaL_optinteger(L, 8, DEFAULT_CHARSET);
+    std::string key = gdiCacheKey(height, weight, italic, underline, strikeout, quality, charset);
+    key.append(face, faceLen);
+    HGDIOBJ font = acquireGdiObject(GDICACHE_FONT, std::move(key), [&] {
+        return CreateFontA(height, 0, 0, 0, weight, italic, underline, strikeout, charset,
+            OUT_DEFAULT_PRECIS, CLIP_DEFAULT_PRECIS, quality, DEFAULT_PITCH | FF_DONTCARE, face);
+    });
+    pushWindowStruct(L, HFONT, font);
+    return 1;
+}
+Lua_Function(ReleaseCachedObject)
+{
+    HGDIOBJ handle = luaL_wingetbycheckudata(L, 1, HGDIOBJ);
+    lua_pushboolean(L, gdiCacheRelease(handle));
+    return 1;
+}
+// SetCachedObjectLimit(n) -> previous limit, n unreferenced objects are kept.
+Lua_Function(SetCachedObjectLimit)
+{
+    lua_Integer limit = luaL_checkinteger(L, 1);
+    luaL_argcheck(L, limit >= 0, 1, "limit must not be negative");
+    size_t previous;
+    {
+        std::lock_guard<std::mutex> guard(gdiCache.lock);
+        previous = gdiCache.idleLimit;
+        gdiCache.idleLimit = (size_t)limit;
+        trimGdiCache();
+    }
+    lua_pushinteger(L, (lua_Integer)previous);
+    return 1;
+}
+// GetCachedObjectCounts() -> { brush, pen, font, idle, gdi, user }
+Lua_Function(GetCachedObjectCounts)
+{
+    size_t counts[GDICACHE_TYPES], idle;
+    {
+        std::lock_guard<std::mutex> guard(gdiCache.lock);
+        std::copy(std::begin(gdiCache.counts), std::end(gdiCache.counts), counts);
+        idle = gdiCache.idle.size();
+    }
+    lua_createtable(L, 0, 6);
+    lua_pushinteger(L, (lua_Integer)counts[GDICACHE_BRUSH]);
+    lua_setfield(L, -2, "brush");
+    lua_pushinteger(L, (lua_Integer)counts[GDICACHE_PEN]);
+    lua_setfield(L, -2, "pen");
+    lua_pushinteger(L, (lua_Integer)counts[GDICACHE_FONT]);
+    lua_setfield(L, -2, "font");
+    lua_pushinteger(L, (lua_Integer)idle);
+    lua_setfield(L, -2, "idle");
+    lua_pushinteger(L, GetGuiResources(GetCurrentProcess(), GR_GDIOBJECTS));
+    lua_setfield(L, -2, "gdi");
+    lua_pushinteger(L, GetGuiResources(GetCurrentProcess(), GR_USEROBJECTS));
+    lua_setfield(L, -2, "user");
+    return 1;
+}
+Lua_Function(GetGuiResources)
+{
+    HANDLE process = luaL_wingetbycheckudata(L, 1, HANDLE);
+    DWORD flags = (DWORD)luaL_checkinteger(L, 2);
+    lua_pushinteger(L, GetGuiResources(process, flags));
+    return 1;
+}
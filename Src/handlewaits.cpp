@@ -0,0 +1,106 @@
+// The entry is not touched once it is on the stack.
+void handleWaitFired(HandleWait* e, bool timedOut)
+{
+    HandleWaits* w = e->owner;
+    e->timedOut = timedOut;
+    e->queued = true;
+    e->next = w->fired.load(std::memory_order_relaxed);
+    while (!w->fired.compare_exchange_weak(e->next, e, std::memory_order_release, std::memory_order_relaxed))
+        ;
+    // Entries are closed before their owner, so w->wake is still set here.
+    if (!w->wakeQueued.exchange(true))
+        w->backend->queueWake(w, w->wake);
+}
+void runHandleWake(const std::shared_ptr<HandleWake>& wake)
+{
+    std::lock_guard<std::mutex> guard(wake->lock);
+    HandleWaits* w = wake->owner;
+    if (!w)
+        return;
+    w->wakeQueued = false;
+    if (w->onWake)
+        w->onWake(w->wakeParam);
+}
+static void disarmHandleWait(HandleWait* e)
+{
+    if (e->wait)
+        e->owner->backend->disarm(e);
+    e->wait = NULL;
+}
+bool openHandleWaits(HandleWaits* w, HandleWaitBackend* backend, void (*onWake)(void*), void* wakeParam)
+{
+    w->onWake = onWake;
+    w->wakeParam = wakeParam;
+    if (!backend->openOwner(w))
+        return false;
+    w->backend = backend;
+    w->wake = std::make_shared<HandleWake>();
+    w->wake->owner = w;
+    return true;
+}
+void closeHandleWaits(HandleWaits* w)
+{
+    if (w->wake)
+    {
+        std::lock_guard<std::mutex> guard(w->wake->lock);
+        w->wake->owner = nullptr;
+    }
+    w->wake.reset();
+    w->wakeQueued = false;
+    w->fired = nullptr;
+    w->retired.clear();
+    if (w->backend)
+        w->backend->closeOwner(w);
+    w->backend = nullptr;
+}
+// Registrations are one-shot, so a handle that stays signaled does not keep a
+// pool thread busy.
+bool armHandleWait(HandleWait* e)
+{
+    return e->owner->backend->arm(e);
+}
+std::unique_ptr<HandleWait> openHandleWait(HandleWaits* w, HANDLE h, DWORD timeout, uintptr_t cookie)
+{
+    auto e = std::make_unique<HandleWait>();
+    e->owner = w;
+    e->timeout = timeout;
+    e->cookie = cookie;
+    if (!w->backend->duplicate(e.get(), h))
+        return nullptr;
+    if (!armHandleWait(e.get()))
+    {
+        w->backend->closeDuplicate(e.get());
+        return nullptr;
+    }
+    return e;
+}
+void closeHandleWait(HandleWaits* w, std::unique_ptr<HandleWait> e)
+{
+    disarmHandleWait(e.get());
+    if (e->handle)
+        w->backend->closeDuplicate(e.get());
+    e->handle = NULL;
+    e->closed = true;
+    // Disarming waited for the callback, so queued is final here.
+    if (e->queued)
+        w->retired.push_back(std::move(e));
+}
+void drainHandleWaits(HandleWaits* w, std::vector<HandleWait*>& out)
+{
+    size_t first = out.size();
+    for (HandleWait* e = w->fired.exchange(nullptr, std::memory_order_acquire); e; e = e->next)
+    {
+        e->queued = false;
+        if (!e->closed)
+            out.push_back(e);
+    }
+    // The stack is newest first.
+    std::reverse(out.begin() + first, out.end());
+    for (size_t i = first; i < out.size(); ++i)
+        disarmHandleWait(out[i]);
+    w->retired.clear();
+}
+bool handleWaitsPending(const HandleWaits* w)
+{
+    return w->fired.load(std::memory_order_relaxed) != nullptr;
+}
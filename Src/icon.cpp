@@ -16,8 +16,4 @@ Lua_Function(LoadIcon)
     HICON icon = LoadIconA(hInstance, lpIconName);
     pushWindowStruct(L, HICON, icon);
     return 1;
-}
-void register_icon(lua_State* L)
-{
-    REGUMACRO(LPSTR, IDI_APPLICATION);
 }
\ No newline at end of file
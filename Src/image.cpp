@@ -0,0 +1,220 @@
+// Runs inside lua_pcall from the decode callbacks, which must not longjmp
+// over the decoder.
+static int newPixelBufferProtected(lua_State* L)
+{
+    newPixelBuffer(L, (int)lua_tointeger(L, 1), (int)lua_tointeger(L, 2), lua_toboolean(L, 3));
+    return 1;
+}
+static bool pushNewPixelBuffer(lua_State* L, int width, int height, bool dib)
+{
+    lua_pushcfunction(L, newPixelBufferProtected);
+    lua_pushinteger(L, width);
+    lua_pushinteger(L, height);
+    lua_pushboolean(L, dib);
+    return lua_pcall(L, 3, 1, 0) == LUA_OK;
+}
+// Argument 1 is a path when fromFile, the encoded image otherwise. Callers
+// check it is a string before the sink exists.
+static const char* decodeImageArg(lua_State* L, bool fromFile, ImageSink& sink)
+{
+    size_t size;
+    const char* arg = lua_tolstring(L, 1, &size);
+    if (!fromFile)
+    {
+        ImageReader in(arg, size);
+        return imageDecode(in, sink);
+    }
+    FILE* file;
+    if (fopen_s(&file, arg, "rb") != 0)
+        return "cannot open file";
+    const char* error;
+    {
+        ImageReader in(file);
+        error = imageDecode(in, sink);
+    }
+    fclose(file);
+    return error;
+}
+// A failed callback left its error on the stack, it is raised only after the
+// decoder returned.
+static int decodeFailure(lua_State* L, bool callbackFailed, const char* error)
+{
+    if (callbackFailed)
+        return lua_error(L);
+    lua_pushnil(L);
+    lua_pushstring(L, error);
+    return 2;
+}
+static int loadPixelBuffer(lua_State* L, bool fromFile)
+{
+    luaL_checkstring(L, 1);
+    bool dib = lua_toboolean(L, 2);
+    bool failed = false;
+    PixelBuffer* pb = nullptr;
+    ImageFormat format = IMAGE_UNKNOWN;
+    ImageSink sink;
+    sink.begin = [&](const ImageInfo& info) {
+        if (!pushNewPixelBuffer(L, info.width, info.height, dib))
+            return !(failed = true);
+        pb = (PixelBuffer*)lua_touserdata(L, -1);
+        format = info.format;
+        return true;
+    };
+    sink.row = [&](int y, const uint32_t* row) {
+        memcpy(pb->view.row(y), row, (size_t)pb->view.width * 4);
+        return true;
+    };
+    const char* error = decodeImageArg(L, fromFile, sink);
+    if (failed || error)
+        return decodeFailure(L, failed, error);
+    lua_pushstring(L, imageFormatName(format));
+    return 2;
+}
+// fn(y, row, width, height) gets every row as a width x 1 PixelBuffer that is
+// reused between calls, returning false from it stops the decode.
+static int decodeImageRows(lua_State* L, bool fromFile)
+{
+    luaL_checkstring(L, 1);
+    luaL_checktype(L, 2, LUA_TFUNCTION);
+    bool failed = false;
+    bool stopped = false;
+    PixelBuffer* line = nullptr;
+    ImageInfo header = { IMAGE_UNKNOWN, 0, 0 };
+    ImageSink sink;
+    sink.begin = [&](const ImageInfo& info) {
+        if (!pushNewPixelBuffer(L, info.width, 1, false))
+            return !(failed = true);
+        line = (PixelBuffer*)lua_touserdata(L, -1);
+        header = info;
+        return true;
+    };
+    sink.row = [&](int y, const uint32_t* row) {
+        memcpy(line->view.pixels, row, (size_t)header.width * 4);
+        lua_pushvalue(L, 2);
+        lua_pushinteger(L, y);
+        lua_pushvalue(L, -3);
+        lua_pushinteger(L, header.width);
+        lua_pushinteger(L, header.height);
+        if (lua_pcall(L, 4, 1, 0) != LUA_OK)
+            return !(failed = true);
+        stopped = lua_isboolean(L, -1) && !lua_toboolean(L, -1);
+        lua_pop(L, 1);
+        return !stopped;
+    };
+    const char* error = decodeImageArg(L, fromFile, sink);
+    if (failed || (error && !stopped))
+        return decodeFailure(L, failed, error);
+    lua_pushinteger(L, header.width);
+    lua_pushinteger(L, header.height);
+    lua_pushstring(L, imageFormatName(header.format));
+    return 3;
+}
+// LoadPixelBuffer(path [, dib]) -> pb, format or nil, message
+Lua_Function(LoadPixelBuffer)
+{
+    return loadPixelBuffer(L, true);
+}
+// DecodePixelBuffer(data [, dib]) -> pb, format or nil, message
+Lua_Function(DecodePixelBuffer)
+{
+    return loadPixelBuffer(L, false);
+}
+// LoadImageRows(path, fn) -> width, height, format or nil, message
+Lua_Function(LoadImageRows)
+{
+    return decodeImageRows(L, true);
+}
+// DecodeImageRows(data, fn) -> width, height, format or nil, message
+Lua_Function(DecodeImageRows)
+{
+    return decodeImageRows(L, false);
+}
+static ImageFormat checkEncodeFormat(lua_State* L, int idx, ImageFormat def)
+{
+    if (lua_isnoneornil(L, idx))
+        return def;
+    ImageFormat format = imageFormatFromName(luaL_checkstring(L, idx));
+    luaL_argcheck(L, format == IMAGE_BMP || format == IMAGE_QOI, idx, "format must be bmp or qoi");
+    return format;
+}
+// SavePixelBuffer(pb, path [, format]) -> true or nil, message
+// The format defaults to the file extension, then to bmp.
+Lua_Function(SavePixelBuffer)
+{
+    PixelBuffer* pb = checkPixelBuffer(L, 1);
+    const char* path = luaL_checkstring(L, 2);
+    const char* ext = strrchr(path, '.');
+    ImageFormat byName = ext ? imageFormatFromName(ext + 1) : IMAGE_UNKNOWN;
+    ImageFormat format = checkEncodeFormat(L, 3, byName == IMAGE_QOI ? IMAGE_QOI : IMAGE_BMP);
+    if (pb->dc)
+        GdiFlush();
+    FILE* file;
+    if (fopen_s(&file, path, "wb") != 0)
+        return decodeFailure(L, false, "cannot open file");
+    const char* error;
+    {
+        ImageWriter out(file);
+        error = imageEncode(out, pb->view, format);
+    }
+    if (fclose(file) != 0 && !error)
+        error = "write failed";
+    if (error)
+        return decodeFailure(L, false, error);
+    lua_pushboolean(L, 1);
+    return 1;
+}
+// EncodePixelBuffer(pb [, format = "qoi"]) -> string
+Lua_Function(EncodePixelBuffer)
+{
+    PixelBuffer* pb = checkPixelBuffer(L, 1);
+    ImageFormat format = checkEncodeFormat(L, 2, IMAGE_QOI);
+    if (pb->dc)
+        GdiFlush();
+    std::string error;
+    {
+        ImageWriter out;
+        if (const char* e = imageEncode(out, pb->view, format))
+            error = e;
+        else
+            lua_pushlstring(L, (const char*)out.buffer.data(), out.buffer.size());
+    }
+    if (!error.empty())
+        return luaL_error(L, "%s", error.c_str());
+    return 1;
+}
+// ImageCodecBenchmark([width = 1920, height = 1080, iterations = 5])
+// -> { { name, mps, bytes }, ... }
+Lua_Function(ImageCodecBenchmark)
+{
+    int width = luaL_opt(L, checkPixelExtent, 1, 1920);
+    int height = luaL_opt(L, checkPixelExtent, 2, 1080);
+    lua_Integer iterations = luaL_optinteger(L, 3, 5);
+    luaL_argcheck(L, (int64_t)width * height <= PIXEL_MAX_PIXELS, 1, "invalid pixel buffer size");
+    luaL_argcheck(L, iterations >= 1 && iterations <= INT_MAX, 3, "iterations must be positive");
+    // bad_alloc must not unwind through the Lua frames.
+    std::vector<ImageCodecTiming> timings;
+    bool allocated = true;
+    try
+    {
+        timings = imageCodecBenchmark(width, height, (int)iterations);
+    }
+    catch (const std::bad_alloc&)
+    {
+        allocated = false;
+    }
+    if (!allocated)
+        luaL_error(L, "not enough memory for a %dx%d benchmark frame", width, height);
+    lua_createtable(L, (int)timings.size(), 0);
+    for (size_t i = 0; i < timings.size(); ++i)
+    {
+        lua_createtable(L, 0, 3);
+        lua_pushstring(L, timings[i].name.c_str());
+        lua_setfield(L, -2, "name");
+        lua_pushnumber(L, timings[i].megapixelsPerSecond);
+        lua_setfield(L, -2, "mps");
+        lua_pushinteger(L, (lua_Integer)timings[i].bytes);
+        lua_setfield(L, -2, "bytes");
+        lua_rawseti(L, -2, (lua_Integer)i + 1);
+    }
+    return 1;
+}
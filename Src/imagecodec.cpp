@@ -0,0 +1,659 @@
+ImageReader::ImageReader(const void* data, size_t size)
+    : pos((const uint8_t*)data), end((const uint8_t*)data + size), consumed(size)
+{
+}
+ImageReader::ImageReader(FILE* file) : file(file), buffer(1 << 16)
+{
+}
+// Keeps the unread bytes and appends from the file until want are buffered
+// or the file ends.
+bool ImageReader::refill(size_t want)
+{
+    if (!file)
+        return false;
+    size_t left = (size_t)(end - pos);
+    if (left >= want)
+        return true;
+    if (want > buffer.size())
+        buffer.resize(want);
+    if (left > 0)
+        memmove(buffer.data(), pos, left);
+    size_t got = fread(buffer.data() + left, 1, buffer.size() - left, file);
+    consumed += got;
+    pos = buffer.data();
+    end = pos + left + got;
+    return left + got >= want;
+}
+bool ImageReader::read(void* dst, size_t n)
+{
+    uint8_t* out = (uint8_t*)dst;
+    while (n > 0)
+    {
+        if (pos == end && !refill())
+            return false;
+        size_t chunk = std::min(n, (size_t)(end - pos));
+        memcpy(out, pos, chunk);
+        pos += chunk;
+        out += chunk;
+        n -= chunk;
+    }
+    return true;
+}
+bool ImageReader::skip(size_t n)
+{
+    while (n > 0)
+    {
+        if (pos == end && !refill())
+            return false;
+        size_t chunk = std::min(n, (size_t)(end - pos));
+        pos += chunk;
+        n -= chunk;
+    }
+    return true;
+}
+size_t ImageReader::peek(const uint8_t** data, size_t n)
+{
+    refill(n);
+    *data = pos;
+    return std::min(n, (size_t)(end - pos));
+}
+
+void ImageWriter::write(const void* src, size_t n)
+{
+    const uint8_t* bytes = (const uint8_t*)src;
+    buffer.insert(buffer.end(), bytes, bytes + n);
+    if (file && buffer.size() >= (1 << 16))
+        flush();
+}
+bool ImageWriter::flush()
+{
+    if (!file)
+        return true;
+    if (!buffer.empty() && fwrite(buffer.data(), 1, buffer.size(), file) != buffer.size())
+        failed = true;
+    buffer.clear();
+    return !failed;
+}
+
+static uint32_t get16(const uint8_t* p)
+{
+    return (uint32_t)p[0] | (uint32_t)p[1] << 8;
+}
+static uint32_t get32(const uint8_t* p)
+{
+    return get16(p) | get16(p + 2) << 16;
+}
+static uint32_t get32be(const uint8_t* p)
+{
+    return (uint32_t)p[0] << 24 | (uint32_t)p[1] << 16 | (uint32_t)p[2] << 8 | p[3];
+}
+static void put16(ImageWriter& out, uint32_t v)
+{
+    uint8_t b[2] = { (uint8_t)v, (uint8_t)(v >> 8) };
+    out.write(b, 2);
+}
+static void put32(ImageWriter& out, uint32_t v)
+{
+    put16(out, v);
+    put16(out, v >> 16);
+}
+static void put32be(ImageWriter& out, uint32_t v)
+{
+    uint8_t b[4] = { (uint8_t)(v >> 24), (uint8_t)(v >> 16), (uint8_t)(v >> 8), (uint8_t)v };
+    out.write(b, 4);
+}
+static inline uint32_t argb(uint32_t a, uint32_t r, uint32_t g, uint32_t b)
+{
+    return a << 24 | r << 16 | g << 8 | b;
+}
+static bool imageSizeValid(int64_t width, int64_t height)
+{
+    return width > 0 && height > 0 && width <= INT_MAX / 4 && height <= INT_MAX && width * height <= IMAGE_MAX_PIXELS;
+}
+// Hands the rows to the sink, bottom-up images count y from the last row.
+struct RowEmitter
+{
+    ImageSink& sink;
+    ImageInfo info;
+    bool bottomUp;
+    std::vector<uint32_t> row;
+    RowEmitter(ImageSink& sink, ImageInfo info, bool bottomUp) : sink(sink), info(info), bottomUp(bottomUp) {}
+    const char* begin()
+    {
+        if (!imageSizeValid(info.width, info.height))
+            return "image too large";
+        if (sink.begin && !sink.begin(info))
+            return "decode cancelled";
+        row.resize((size_t)info.width);
+        return NULL;
+    }
+    bool emit(int i)
+    {
+        return sink.row(bottomUp ? info.height - 1 - i : i, row.data());
+    }
+};
+
+// Channel of a BI_BITFIELDS mask scaled to 8 bits.
+struct BitField
+{
+    uint32_t mask = 0;
+    int shift = 0;
+    uint32_t max = 0;
+    void set(uint32_t m)
+    {
+        mask = m;
+        shift = m ? std::countr_zero(m) : 0;
+        max = m >> shift;
+    }
+    uint32_t get(uint32_t v, uint32_t missing) const
+    {
+        if (!max)
+            return missing;
+        // Masks may be up to 32 bits wide, c * 255 needs 64.
+        uint64_t c = (v & mask) >> shift;
+        return max == 255 ? (uint32_t)c : (uint32_t)((c * 255 + max / 2) / max);
+    }
+};
+static const char* decodeBMP(ImageReader& in, ImageSink& sink)
+{
+    uint8_t head[14 + 124];
+    if (!in.read(head, 18))
+        return "truncated image";
+    uint32_t dataOffset = get32(head + 10);
+    uint32_t headerSize = get32(head + 14);
+    if (headerSize != 12 && (headerSize < 40 || headerSize > 124))
+        return "unsupported BMP header";
+    if (!in.read(head + 18, headerSize - 4))
+        return "truncated image";
+    const uint8_t* h = head + 14;
+    int64_t width, height;
+    uint32_t bpp, compression = 0, colors = 0;
+    if (headerSize == 12)
+    {
+        width = get16(h + 4);
+        height = (int16_t)get16(h + 6);
+        bpp = get16(h + 10);
+    }
+    else
+    {
+        width = (int32_t)get32(h + 4);
+        height = (int32_t)get32(h + 8);
+        bpp = get16(h + 14);
+        compression = get32(h + 16);
+        colors = get32(h + 32);
+    }
+    BitField r, g, b, a;
+    if (compression == 3 || compression == 6)
+    {
+        if (bpp != 16 && bpp != 32)
+            return "unsupported BMP bit depth";
+        uint8_t masks[16];
+        size_t count = compression == 6 ? 16 : 12;
+        if (headerSize >= 40 + count)
+            memcpy(masks, h + 40, count);
+        else if (!in.read(masks, count))
+            return "truncated image";
+        r.set(get32(masks));
+        g.set(get32(masks + 4));
+        b.set(get32(masks + 8));
+        if (count == 16 || headerSize >= 56)
+            a.set(count == 16 ? get32(masks + 12) : get32(h + 52));
+    }
+    else if (compression != 0)
+        return "unsupported BMP compression";
+    else if (bpp == 16)
+    {
+        r.set(0x7C00);
+        g.set(0x03E0);
+        b.set(0x001F);
+    }
+    else if (bpp == 32)
+    {
+        r.set(0x00FF0000);
+        g.set(0x0000FF00);
+        b.set(0x000000FF);
+    }
+    else if (bpp != 1 && bpp != 4 && bpp != 8 && bpp != 24)
+        return "unsupported BMP bit depth";
+
+    uint32_t palette[256] = {};
+    if (bpp <= 8)
+    {
+        uint32_t entries = colors ? colors : 1u << bpp;
+        if (entries > 256)
+            return "invalid BMP palette";
+        int entrySize = headerSize == 12 ? 3 : 4;
+        for (uint32_t i = 0; i < entries; ++i)
+        {
+            uint8_t e[4];
+            if (!in.read(e, entrySize))
+                return "truncated image";
+            palette[i] = argb(255, e[2], e[1], e[0]);
+        }
+    }
+    if (dataOffset < in.offset() || !in.skip(dataOffset - in.offset()))
+        return "truncated image";
+
+    bool bottomUp = height > 0;
+    height = bottomUp ? height : -height;
+    RowEmitter rows{ sink, { IMAGE_BMP, (int)width, (int)height }, bottomUp };
+    if (!imageSizeValid(width, height))
+        return "image too large";
+    if (const char* error = rows.begin())
+        return error;
+    size_t stride = ((size_t)width * bpp + 31) / 32 * 4;
+    std::vector<uint8_t> raw(stride);
+    bool plain32 = bpp == 32 && r.mask == 0x00FF0000 && g.mask == 0x0000FF00 && b.mask == 0x000000FF;
+    uint32_t* out = rows.row.data();
+    for (int y = 0; y < (int)height; ++y)
+    {
+        if (!in.read(raw.data(), stride))
+            return "truncated image";
+        const uint8_t* p = raw.data();
+        if (plain32 && a.mask == 0xFF000000)
+            memcpy(out, p, (size_t)width * 4);
+        else if (plain32 && !a.mask)
+            for (int x = 0; x < width; ++x)
+                out[x] = get32(p + x * 4) | 0xFF000000;
+        else if (bpp == 32 || bpp == 16)
+            for (int x = 0; x < width; ++x)
+            {
+                uint32_t v = bpp == 32 ? get32(p + x * 4) : get16(p + x * 2);
+                out[x] = argb(a.get(v, 255), r.get(v, 0), g.get(v, 0), b.get(v, 0));
+            }
+        else if (bpp == 24)
+            for (int x = 0; x < width; ++x, p += 3)
+                out[x] = argb(255, p[2], p[1], p[0]);
+        else
+        {
+            int perByte = 8 / bpp;
+            uint32_t mask = (1u << bpp) - 1;
+            for (int x = 0; x < width; ++x)
+            {
+                int shift = 8 - bpp * (x % perByte + 1);
+                out[x] = palette[(p[x / perByte] >> shift) & mask];
+            }
+        }
+        if (!rows.emit(y))
+            return "decode cancelled";
+    }
+    return NULL;
+}
+
+static const char* decodeQOI(ImageReader& in, ImageSink& sink)
+{
+    uint8_t head[14];
+    if (!in.read(head, 14))
+        return "truncated image";
+    if (head[12] != 3 && head[12] != 4)
+        return "invalid QOI header";
+    RowEmitter rows{ sink, { IMAGE_QOI, 0, 0 }, false };
+    if (!imageSizeValid(get32be(head + 4), get32be(head + 8)))
+        return "image too large";
+    rows.info.width = (int)get32be(head + 4);
+    rows.info.height = (int)get32be(head + 8);
+    if (const char* error = rows.begin())
+        return error;
+    uint32_t index[64] = {};
+    uint32_t px = 0xFF000000;
+    uint32_t a = 255, r = 0, g = 0, b = 0;
+    int run = 0;
+    uint32_t* out = rows.row.data();
+    for (int y = 0; y < rows.info.height; ++y)
+    {
+        for (int x = 0; x < rows.info.width; ++x)
+        {
+            if (run > 0)
+                --run;
+            else
+            {
+                int op = in.byte();
+                if (op < 0)
+                    return "truncated image";
+                if (op == 0xFE || op == 0xFF)
+                {
+                    int c[4] = { in.byte(), in.byte(), in.byte(), op == 0xFF ? in.byte() : (int)a };
+                    if ((c[0] | c[1] | c[2] | c[3]) < 0)
+                        return "truncated image";
+                    r = c[0], g = c[1], b = c[2], a = c[3];
+                }
+                else if ((op & 0xC0) == 0x00)
+                {
+                    uint32_t c = index[op];
+                    a = c >> 24, r = (c >> 16) & 0xFF, g = (c >> 8) & 0xFF, b = c & 0xFF;
+                }
+                else if ((op & 0xC0) == 0x40)
+                {
+                    r = (r + ((op >> 4) & 3) - 2) & 0xFF;
+                    g = (g + ((op >> 2) & 3) - 2) & 0xFF;
+                    b = (b + (op & 3) - 2) & 0xFF;
+                }
+                else if ((op & 0xC0) == 0x80)
+                {
+                    int next = in.byte();
+                    if (next < 0)
+                        return "truncated image";
+                    int dg = (op & 0x3F) - 32;
+                    r = (r + dg + ((next >> 4) & 0xF) - 8) & 0xFF;
+                    g = (g + dg) & 0xFF;
+                    b = (b + dg + (next & 0xF) - 8) & 0xFF;
+                }
+                else
+                    run = op & 0x3F;
+                px = argb(a, r, g, b);
+                index[(r * 3 + g * 5 + b * 7 + a * 11) % 64] = px;
+            }
+            out[x] = px;
+        }
+        if (!rows.emit(y))
+            return "decode cancelled";
+    }
+    return NULL;
+}
+
+static bool tgaTypeValid(const uint8_t* h)
+{
+    int type = h[2], bpp = h[16], entry = h[7];
+    if (h[1] > 1 || get16(h + 12) == 0 || get16(h + 14) == 0)
+        return false;
+    switch (type)
+    {
+    case 1:
+        return h[1] == 1 && (bpp == 8 || bpp == 16) && (entry == 15 || entry == 16 || entry == 24 || entry == 32);
+    case 2:
+        return bpp == 15 || bpp == 16 || bpp == 24 || bpp == 32;
+    case 3:
+        return bpp == 8 || bpp == 16;
+    }
+    return false;
+}
+static uint32_t tgaPixel(const uint8_t* p, int bits, bool alpha)
+{
+    switch (bits)
+    {
+    case 15:
+    case 16:
+    {
+        uint32_t v = get16(p);
+        uint32_t r = (v >> 10) & 31, g = (v >> 5) & 31, b = v & 31;
+        uint32_t a = alpha && bits == 16 ? (v & 0x8000 ? 255 : 0) : 255;
+        return argb(a, r << 3 | r >> 2, g << 3 | g >> 2, b << 3 | b >> 2);
+    }
+    case 24:
+        return argb(255, p[2], p[1], p[0]);
+    default:
+        return argb(alpha ? p[3] : 255, p[2], p[1], p[0]);
+    }
+}
+static const char* decodeTGA(ImageReader& in, ImageSink& sink)
+{
+    uint8_t h[18];
+    if (!in.read(h, 18))
+        return "truncated image";
+    if (!tgaTypeValid(h))
+        return "unsupported TGA image";
+    int type = h[2], bpp = h[16];
+    bool alpha = (h[17] & 0x0F) != 0;
+    if (!in.skip(h[0]))
+        return "truncated image";
+    std::vector<uint32_t> palette;
+    uint32_t first = get16(h + 3);
+    if (h[1] == 1)
+    {
+        int entry = h[7];
+        int entryBytes = (entry + 7) / 8;
+        uint32_t length = get16(h + 5);
+        std::vector<uint8_t> raw((size_t)length * entryBytes);
+        if (!in.read(raw.data(), raw.size()))
+            return "truncated image";
+        if (type == 1)
+        {
+            palette.resize(length);
+            for (uint32_t i = 0; i < length; ++i)
+                palette[i] = tgaPixel(raw.data() + (size_t)i * entryBytes, entry, alpha || entry == 32);
+        }
+    }
+    RowEmitter rows{ sink, { IMAGE_TGA, (int)get16(h + 12), (int)get16(h + 14) }, !(h[17] & 0x20) };
+    if (const char* error = rows.begin())
+        return error;
+    bool rightToLeft = (h[17] & 0x10) != 0;
+    int pixelBytes = (bpp + 7) / 8;
+    int width = rows.info.width;
+    std::vector<uint8_t> raw((size_t)width * pixelBytes);
+    uint32_t* out = rows.row.data();
+    for (int y = 0; y < rows.info.height; ++y)
+    {
+        if (!in.read(raw.data(), raw.size()))
+            return "truncated image";
+        for (int x = 0; x < width; ++x)
+        {
+            const uint8_t* p = raw.data() + (size_t)x * pixelBytes;
+            uint32_t c;
+            if (type == 1)
+            {
+                uint32_t i = (pixelBytes == 1 ? p[0] : get16(p)) - first;
+                c = i < palette.size() ? palette[i] : 0;
+            }
+            else if (type == 3)
+                c = argb(pixelBytes == 2 && alpha ? p[1] : 255, p[0], p[0], p[0]);
+            else
+                c = tgaPixel(p, bpp, alpha);
+            out[rightToLeft ? width - 1 - x : x] = c;
+        }
+        if (!rows.emit(y))
+            return "decode cancelled";
+    }
+    return NULL;
+}
+
+ImageFormat imageDetectFormat(const uint8_t* head, size_t size)
+{
+    if (size >= 18 && head[0] == 'B' && head[1] == 'M')
+        return IMAGE_BMP;
+    if (size >= 14 && memcmp(head, "qoif", 4) == 0)
+        return IMAGE_QOI;
+    if (size >= 18 && tgaTypeValid(head))
+        return IMAGE_TGA;
+    return IMAGE_UNKNOWN;
+}
+const char* imageDecode(ImageReader& in, ImageSink& sink)
+{
+    const uint8_t* head;
+    size_t size = in.peek(&head, 18);
+    switch (imageDetectFormat(head, size))
+    {
+    case IMAGE_BMP:
+        return decodeBMP(in, sink);
+    case IMAGE_QOI:
+        return decodeQOI(in, sink);
+    case IMAGE_TGA:
+        return decodeTGA(in, sink);
+    default:
+        return "unknown image format";
+    }
+}
+
+// 32 bpp BITMAPV4HEADER with an alpha mask, bottom-up.
+static void encodeBMP(ImageWriter& out, const PixelView& v)
+{
+    const uint32_t headerSize = 14 + 108;
+    uint32_t imageSize = (uint32_t)v.width * v.height * 4;
+    out.byte('B');
+    out.byte('M');
+    put32(out, headerSize + imageSize);
+    put32(out, 0);
+    put32(out, headerSize);
+    put32(out, 108);
+    put32(out, (uint32_t)v.width);
+    put32(out, (uint32_t)v.height);
+    put16(out, 1);
+    put16(out, 32);
+    put32(out, 3);
+    put32(out, imageSize);
+    put32(out, 2835);
+    put32(out, 2835);
+    put32(out, 0);
+    put32(out, 0);
+    put32(out, 0x00FF0000);
+    put32(out, 0x0000FF00);
+    put32(out, 0x000000FF);
+    put32(out, 0xFF000000);
+    put32(out, 0x73524742); // LCS_sRGB
+    for (int i = 0; i < 12; ++i)
+        put32(out, 0);
+    // Pixels are already B, G, R, A in memory.
+    for (int y = v.height - 1; y >= 0; --y)
+        out.write(v.row(y), (size_t)v.width * 4);
+}
+static void encodeQOI(ImageWriter& out, const PixelView& v)
+{
+    out.write("qoif", 4);
+    put32be(out, (uint32_t)v.width);
+    put32be(out, (uint32_t)v.height);
+    out.byte(4);
+    out.byte(0);
+    uint32_t index[64] = {};
+    uint32_t prev = 0xFF000000;
+    int run = 0;
+    for (int y = 0; y < v.height; ++y)
+    {
+        const uint32_t* row = v.row(y);
+        for (int x = 0; x < v.width; ++x)
+        {
+            uint32_t px = row[x];
+            if (px == prev)
+            {
+                if (++run == 62)
+                {
+                    out.byte((uint8_t)(0xC0 | (run - 1)));
+                    run = 0;
+                }
+                continue;
+            }
+            if (run > 0)
+            {
+                out.byte((uint8_t)(0xC0 | (run - 1)));
+                run = 0;
+            }
+            uint32_t a = px >> 24, r = (px >> 16) & 0xFF, g = (px >> 8) & 0xFF, b = px & 0xFF;
+            int hash = (int)((r * 3 + g * 5 + b * 7 + a * 11) % 64);
+            if (index[hash] == px)
+                out.byte((uint8_t)hash);
+            else
+            {
+                index[hash] = px;
+                if (a == prev >> 24)
+                {
+                    int dr = (int8_t)(r - ((prev >> 16) & 0xFF));
+                    int dg = (int8_t)(g - ((prev >> 8) & 0xFF));
+                    int db = (int8_t)(b - (prev & 0xFF));
+                    int drg = dr - dg, dbg = db - dg;
+                    if (dr >= -2 && dr <= 1 && dg >= -2 && dg <= 1 && db >= -2 && db <= 1)
+                        out.byte((uint8_t)(0x40 | (dr + 2) << 4 | (dg + 2) << 2 | (db + 2)));
+                    else if (drg >= -8 && drg <= 7 && dg >= -32 && dg <= 31 && dbg >= -8 && dbg <= 7)
+                    {
+                        out.byte((uint8_t)(0x80 | (dg + 32)));
+                        out.byte((uint8_t)((drg + 8) << 4 | (dbg + 8)));
+                    }
+                    else
+                    {
+                        uint8_t op[4] = { 0xFE, (uint8_t)r, (uint8_t)g, (uint8_t)b };
+                        out.write(op, 4);
+                    }
+                }
+                else
+                {
+                    uint8_t op[5] = { 0xFF, (uint8_t)r, (uint8_t)g, (uint8_t)b, (uint8_t)a };
+                    out.write(op, 5);
+                }
+            }
+            prev = px;
+        }
+    }
+    if (run > 0)
+        out.byte((uint8_t)(0xC0 | (run - 1)));
+    static const uint8_t padding[8] = { 0, 0, 0, 0, 0, 0, 0, 1 };
+    out.write(padding, 8);
+}
+const char* imageEncode(ImageWriter& out, const PixelView& v, ImageFormat format)
+{
+    if (!imageSizeValid(v.width, v.height))
+        return "image too large";
+    switch (format)
+    {
+    case IMAGE_BMP:
+        encodeBMP(out, v);
+        break;
+    case IMAGE_QOI:
+        encodeQOI(out, v);
+        break;
+    default:
+        return "unsupported image format";
+    }
+    return out.flush() ? NULL : "write failed";
+}
+
+static const char* const imageFormatNames[] = { "unknown", "bmp", "qoi", "tga" };
+ImageFormat imageFormatFromName(const char* name)
+{
+    std::string lower(name);
+    for (char& c : lower)
+        c = (char)tolower((unsigned char)c);
+    for (int i = IMAGE_BMP; i <= IMAGE_TGA; ++i)
+        if (lower == imageFormatNames[i])
+            return (ImageFormat)i;
+    return IMAGE_UNKNOWN;
+}
+const char* imageFormatName(ImageFormat format)
+{
+    return imageFormatNames[format];
+}
+
+std::vector<ImageCodecTiming> imageCodecBenchmark(int width, int height, int iterations)
+{
+    // Flat areas with gradients and noise, roughly what a desktop capture holds.
+    std::vector<uint32_t> frame((size_t)width * height);
+    uint32_t seed = 0x9E3779B9;
+    for (int y = 0; y < height; ++y)
+        for (int x = 0; x < width; ++x)
+        {
+            seed ^= seed << 13;
+            seed ^= seed >> 17;
+            seed ^= seed << 5;
+            uint32_t c = ((x / 64 + y / 64) & 1) ? 0xFFF0F0F0 : argb(255, x & 0xFF, y & 0xFF, 0x80);
+            frame[(size_t)y * width + x] = (x / 256) % 4 == 3 ? (seed | 0xFF000000) : c;
+        }
+    PixelView view{ frame.data(), width, height, width };
+    std::vector<uint32_t> decoded(frame.size());
+    ImageSink sink;
+    sink.row = [&](int y, const uint32_t* row) {
+        memcpy(decoded.data() + (size_t)y * width, row, (size_t)width * 4);
+        return true;
+    };
+    std::vector<ImageCodecTiming> timings;
+    auto time = [&](const char* name, size_t bytes, const std::function<void()>& run) {
+        run();
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; ++i)
+            run();
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        double pixels = (double)width * height * iterations;
+        timings.push_back({ name, seconds > 0 ? pixels / seconds / 1e6 : 0, bytes });
+    };
+    for (ImageFormat format : { IMAGE_BMP, IMAGE_QOI })
+    {
+        ImageWriter encoded;
+        imageEncode(encoded, view, format);
+        std::string name = imageFormatName(format);
+        time((name + "Encode").c_str(), encoded.buffer.size(), [&] {
+            ImageWriter out;
+            out.buffer.reserve(encoded.buffer.size());
+            imageEncode(out, view, format);
+        });
+        time((name + "Decode").c_str(), encoded.buffer.size(), [&] {
+            ImageReader in(encoded.buffer.data(), encoded.buffer.size());
+            imageDecode(in, sink);
+        });
+    }
+    return timings;
+}
@@ -0,0 +1,74 @@
+static int intarray_size(lua_State* L)
+{
+    lua_pushinteger(L, (lua_Integer)checkIntArray(L, 1)->count);
+    return 1;
+}
+static int intarray_pointer(lua_State* L)
+{
+    lua_pushlightuserdata(L, checkIntArray(L, 1)->values);
+    return 1;
+}
+static int intarray_totable(lua_State* L)
+{
+    IntArray* a = checkIntArray(L, 1);
+    lua_createtable(L, (int)a->count, 0);
+    for (size_t i = 0; i < a->count; ++i)
+    {
+        lua_pushinteger(L, a->values[i]);
+        lua_rawseti(L, -2, (lua_Integer)i + 1);
+    }
+    return 1;
+}
+static const luaL_Reg intarray_methods[] = {
+    {"size", intarray_size},
+    {"pointer", intarray_pointer},
+    {"totable", intarray_totable},
+    {NULL, NULL}
+};
+// Integer keys read elements, anything else looks up the methods table.
+static int intarray_index(lua_State* L)
+{
+    IntArray* a = checkIntArray(L, 1);
+    int isnum;
+    lua_Integer i = lua_tointegerx(L, 2, &isnum);
+    if (isnum)
+    {
+        if (i < 1 || (size_t)i > a->count)
+            return 0;
+        lua_pushinteger(L, a->values[i - 1]);
+        return 1;
+    }
+    lua_pushvalue(L, 2);
+    lua_rawget(L, lua_upvalueindex(1));
+    return 1;
+}
+static int intarray_newindex(lua_State* L)
+{
+    IntArray* a = checkIntArray(L, 1);
+    lua_Integer i = luaL_checkinteger(L, 2);
+    luaL_argcheck(L, i >= 1 && (size_t)i <= a->count, 2, "index out of range");
+    a->values[i - 1] = luaL_checkinteger(L, 3);
+    return 0;
+}
+IntArray* newIntArray(lua_State* L, size_t count)
+{
+    IntArray* a = (IntArray*)lua_newuserdata(L, offsetof(IntArray, values) + (count ? count : 1) * sizeof(lua_Integer));
+    a->count = count;
+    if (luaL_newmetatable(L, INTARRAYNAME))
+    {
+        lua_newtable(L);
+        luaL_setfuncs(L, intarray_methods, 0);
+        lua_pushcclosure(L, intarray_index, 1);
+        lua_setfield(L, -2, "__index");
+        lua_pushcfunction(L, intarray_newindex);
+        lua_setfield(L, -2, "__newindex");
+        lua_pushcfunction(L, intarray_size);
+        lua_setfield(L, -2, "__len");
+    }
+    lua_setmetatable(L, -2);
+    return a;
+}
+IntArray* checkIntArray(lua_State* L, int idx)
+{
+    return luaL_checkobject(L, idx, IntArray, INTARRAYNAME);
+}
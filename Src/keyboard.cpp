@@ -1,146 +0,0 @@
-void register_vkeys(lua_State* L)
-{
-	REGIMACRO(VK_LBUTTON)
-		REGIMACRO(VK_RBUTTON)
-		REGIMACRO(VK_CANCEL)
-		REGIMACRO(VK_MBUTTON)
-		REGIMACRO(VK_XBUTTON1)
-		REGIMACRO(VK_XBUTTON2)
-		REGIMACRO(VK_BACK)
-		REGIMACRO(VK_TAB)
-		REGIMACRO(VK_CLEAR)
-		REGIMACRO(VK_RETURN)
-		REGIMACRO(VK_SHIFT)
-		REGIMACRO(VK_CONTROL)
-		REGIMACRO(VK_MENU)
-		REGIMACRO(VK_PAUSE)
-		REGIMACRO(VK_CAPITAL)
-		REGIMACRO(VK_KANA)
-		REGIMACRO(VK_HANGUL)
-		REGIMACRO(VK_JUNJA)
-		REGIMACRO(VK_FINAL)
-		REGIMACRO(VK_HANJA)
-		REGIMACRO(VK_KANJI)
-		REGIMACRO(VK_ESCAPE)
-		REGIMACRO(VK_CONVERT)
-		REGIMACRO(VK_NONCONVERT)
-		REGIMACRO(VK_ACCEPT)
-		REGIMACRO(VK_MODECHANGE)
-		REGIMACRO(VK_SPACE)
-		REGIMACRO(VK_PRIOR)
-		REGIMACRO(VK_NEXT)
-		REGIMACRO(VK_END)
-		REGIMACRO(VK_HOME)
-		REGIMACRO(VK_LEFT)
-		REGIMACRO(VK_UP)
-		REGIMACRO(VK_RIGHT)
-		REGIMACRO(VK_DOWN)
-		REGIMACRO(VK_SELECT)
-		REGIMACRO(VK_PRINT)
-		REGIMACRO(VK_EXECUTE)
-		REGIMACRO(VK_SNAPSHOT)
-		REGIMACRO(VK_INSERT)
-		REGIMACRO(VK_DELETE)
-		REGIMACRO(VK_HELP)
-		REGIMACRO(VK_LWIN)
-		REGIMACRO(VK_RWIN)
-		REGIMACRO(VK_APPS)
-		REGIMACRO(VK_SLEEP)
-		REGIMACRO(VK_NUMPAD0)
-		REGIMACRO(VK_NUMPAD1)
-		REGIMACRO(VK_NUMPAD2)
-		REGIMACRO(VK_NUMPAD3)
-		REGIMACRO(VK_NUMPAD4)
-		REGIMACRO(VK_NUMPAD5)
-		REGIMACRO(VK_NUMPAD6)
-		REGIMACRO(VK_NUMPAD7)
-		REGIMACRO(VK_NUMPAD8)
-		REGIMACRO(VK_NUMPAD9)
-		REGIMACRO(VK_MULTIPLY)
-		REGIMACRO(VK_ADD)
-		REGIMACRO(VK_SEPARATOR)
-		REGIMACRO(VK_SUBTRACT)
-		REGIMACRO(VK_DECIMAL)
-		REGIMACRO(VK_DIVIDE)
-		REGIMACRO(VK_F1)
-		REGIMACRO(VK_F2)
-		REGIMACRO(VK_F3)
-		REGIMACRO(VK_F4)
-		REGIMACRO(VK_F5)
-		REGIMACRO(VK_F6)
-		REGIMACRO(VK_F7)
-		REGIMACRO(VK_F8)
-		REGIMACRO(VK_F9)
-		REGIMACRO(VK_F10)
-		REGIMACRO(VK_F11)
-		REGIMACRO(VK_F12)
-		REGIMACRO(VK_F13)
-		REGIMACRO(VK_F14)
-		REGIMACRO(VK_F15)
-		REGIMACRO(VK_F16)
-		REGIMACRO(VK_F17)
-		REGIMACRO(VK_F18)
-		REGIMACRO(VK_F19)
-		REGIMACRO(VK_F20)
-		REGIMACRO(VK_F21)
-		REGIMACRO(VK_F22)
-		REGIMACRO(VK_F23)
-		REGIMACRO(VK_F24)
-		REGIMACRO(VK_NUMLOCK)
-		REGIMACRO(VK_SCROLL)
-		REGIMACRO(VK_OEM_NEC_EQUAL)
-		REGIMACRO(VK_OEM_FJ_JISHO)
-		REGIMACRO(VK_OEM_FJ_MASSHOU)
-		REGIMACRO(VK_OEM_FJ_TOUROKU)
-		REGIMACRO(VK_OEM_FJ_LOYA)
-		REGIMACRO(VK_OEM_FJ_ROYA)
-		REGIMACRO(VK_LSHIFT)
-		REGIMACRO(VK_RSHIFT)
-		REGIMACRO(VK_LCONTROL)
-		REGIMACRO(VK_RCONTROL)
-		REGIMACRO(VK_LMENU)
-		REGIMACRO(VK_RMENU)
-		REGIMACRO(VK_PROCESSKEY)
-		REGIMACRO(VK_PACKET)
-		REGIMACRO(VK_ATTN)
-		REGIMACRO(VK_CRSEL)
-		REGIMACRO(VK_EXSEL)
-		REGIMACRO(VK_EREOF)
-		REGIMACRO(VK_PLAY)
-		REGIMACRO(VK_ZOOM)
-		REGIMACRO(VK_NONAME)
-		REGIMACRO(VK_PA1)
-		REGIMACRO(VK_OEM_CLEAR)
-		REGIMACRO(VK_OEM_AX)
-		REGIMACRO(VK_OEM_102)
-		REGIMACRO(VK_OEM_1)
-		REGIMACRO(VK_OEM_PLUS)
-		REGIMACRO(VK_OEM_COMMA)
-		REGIMACRO(VK_OEM_MINUS)
-		REGIMACRO(VK_OEM_PERIOD)
-		REGIMACRO(VK_OEM_2)
-		REGIMACRO(VK_OEM_3)
-		REGIMACRO(VK_OEM_4)
-		REGIMACRO(VK_OEM_5)
-		REGIMACRO(VK_OEM_6)
-		REGIMACRO(VK_OEM_7)
-		REGIMACRO(VK_OEM_8)
-		REGIMACRO(VK_BROWSER_BACK)
-		REGIMACRO(VK_BROWSER_FORWARD)
-		REGIMACRO(VK_BROWSER_REFRESH)
-		REGIMACRO(VK_BROWSER_STOP)
-		REGIMACRO(VK_BROWSER_SEARCH)
-		REGIMACRO(VK_BROWSER_FAVORITES)
-		REGIMACRO(VK_BROWSER_HOME)
-		REGIMACRO(VK_VOLUME_MUTE)
-		REGIMACRO(VK_VOLUME_DOWN)
-		REGIMACRO(VK_VOLUME_UP)
-		REGIMACRO(VK_MEDIA_NEXT_TRACK)
-		REGIMACRO(VK_MEDIA_PREV_TRACK)
-		REGIMACRO(VK_MEDIA_STOP)
-		REGIMACRO(VK_MEDIA_PLAY_PAUSE)
-		REGIMACRO(VK_LAUNCH_MAIL)
-		REGIMACRO(VK_LAUNCH_MEDIA_SELECT)
-		REGIMACRO(VK_LAUNCH_APP1)
-		REGIMACRO(VK_LAUNCH_APP2)
-}
\ No newline at end of file
@@ -32,4 +32,269 @@ Lua_Function(GetModuleHandleEx)
 
     lua_pushboolean(L, res);
     return 1;
-}
\ No newline at end of file
+}
+// Modules loaded by BindLibrary, lowercase name -> HMODULE. Each holds one
+// reference whatever the number of bindings, released when the state closes.
+#define LIBRARYCACHE "luibexwin.libraries"
+static int librarycache_gc(lua_State* L)
+{
+    lua_pushnil(L);
+    while (lua_next(L, 1))
+    {
+        FreeLibrary((HMODULE)lua_touserdata(L, -1));
+        lua_pop(L, 1);
+    }
+    return 0;
+}
+static HMODULE loadCachedLibrary(lua_State* L, const char* name)
+{
+    if (!luaL_getsubtable(L, LUA_REGISTRYINDEX, LIBRARYCACHE))
+    {
+        lua_createtable(L, 0, 1);
+        lua_pushcfunction(L, librarycache_gc);
+        lua_setfield(L, -2, "__gc");
+        lua_setmetatable(L, -2);
+    }
+    std::string key(name);
+    std::transform(key.begin(), key.end(), key.begin(), [](unsigned char c) { return (char)tolower(c); });
+    lua_getfield(L, -1, key.c_str());
+    HMODULE mod = (HMODULE)lua_touserdata(L, -1);
+    lua_pop(L, 1);
+    if (!mod && (mod = LoadLibraryA(name)))
+    {
+        lua_pushlightuserdata(L, (void*)mod);
+        lua_setfield(L, -2, key.c_str());
+    }
+    lua_pop(L, 1);
+    return mod;
+}
+// __index of a bound library: resolves and compiles a declared function the
+// first time it is used and stores the caller in the table, so later lookups
+// never come back here. Undeclared names are nil.
+static int library_index(lua_State* L)
+{
+    if (lua_type(L, 2) != LUA_TSTRING || lua_getfield(L, lua_upvalueindex(2), lua_tostring(L, 2)) != LUA_TTABLE)
+        return 0;
+    const char* name = lua_tostring(L, 2);
+    FARPROC func = GetProcAddress((HMODULE)lua_touserdata(L, lua_upvalueindex(1)), name);
+    if (!func)
+        return luaL_error(L, "%s: no export named '%s' (error %d)", lua_tostring(L, lua_upvalueindex(3)), name, (int)GetLastError());
+    lua_rawgeti(L, -1, 1);
+    lua_rawgeti(L, -2, 2);
+    pushProcCaller(L, func, -2, -1);
+    lua_pushvalue(L, 2);
+    lua_pushvalue(L, -2);
+    lua_rawset(L, 1);
+    return 1;
+}
+// BindLibrary(dll, { Name = { ret, { argtypes } }, ... }) -> table of
+// callables, or nil and the error code. Types are named as for Addr2Val.
+// Binding only loads the module, once per state; each function is looked up
+// and its signature compiled on first use, so large declarations are cheap
+// to bind and unused entries cost nothing.
+Lua_Function(BindLibrary)
+{
+    const char* name = luaL_checkstring(L, 1);
+    luaL_checktype(L, 2, LUA_TTABLE);
+    HMODULE mod = loadCachedLibrary(L, name);
+    if (!mod)
+    {
+        lua_pushnil(L);
+        lua_pushinteger(L, (lua_Integer)GetLastError());
+        return 2;
+    }
+    lua_newtable(L);
+    lua_createtable(L, 0, 1);
+    lua_pushlightuserdata(L, (void*)mod);
+    lua_pushvalue(L, 2);
+    lua_pushvalue(L, 1);
+    lua_pushcclosure(L, library_index, 3);
+    lua_setfield(L, -2, "__index");
+    lua_setmetatable(L, -2);
+    return 1;
+}
+#define EXPORTTABLENAME "luibexwin.ExportTable"
+// Export index of one module, see peexports.h. base is what RVAs are added to:
+// the module address, in this or another process, or 0 for a file.
+struct ExportTable
+{
+    PeExports pe;
+    uint64_t base = 0;
+    bool local = false;
+};
+static ExportTable* checkExportTable(lua_State* L, int idx)
+{
+    return luaL_checkobject(L, idx, ExportTable, EXPORTTABLENAME);
+}
+// Numbers are ordinals, strings names.
+static const PeExport* checkExport(lua_State* L, ExportTable* t, int idx)
+{
+    if (lua_type(L, idx) == LUA_TNUMBER)
+        return t->pe.findOrdinal((uint32_t)luaL_checkinteger(L, idx));
+    size_t len;
+    const char* name = luaL_checklstring(L, idx, &len);
+    return t->pe.find({ name, len });
+}
+static void pushExportAddress(lua_State* L, ExportTable* t, uint32_t rva)
+{
+    if (t->local)
+        lua_pushlightuserdata(L, (void*)(uintptr_t)(t->base + rva));
+    else
+        lua_pushinteger(L, (lua_Integer)(t->base + rva));
+}
+// exports:resolve(name | ordinal) -> address (lightuserdata for a module of
+// this process, integer otherwise, the RVA for a file), or nil and the
+// "DLL.Symbol" of a forwarder.
+static int exporttable_resolve(lua_State* L)
+{
+    ExportTable* t = checkExportTable(L, 1);
+    const PeExport* e = checkExport(L, t, 2);
+    if (!e)
+        return 0;
+    if (const char* forwarder = t->pe.string(e->forwarder))
+    {
+        lua_pushnil(L);
+        lua_pushstring(L, forwarder);
+        return 2;
+    }
+    pushExportAddress(L, t, e->rva);
+    return 1;
+}
+// exports:lookup(name | ordinal) -> { name, ordinal, rva, forwarder } or nil.
+// name is the one looked up, or the first name of an ordinal.
+static int exporttable_lookup(lua_State* L)
+{
+    ExportTable* t = checkExportTable(L, 1);
+    const PeExport* e = checkExport(L, t, 2);
+    if (!e)
+        return 0;
+    lua_createtable(L, 0, 4);
+    if (lua_type(L, 2) == LUA_TSTRING)
+    {
+        lua_pushvalue(L, 2);
+        lua_setfield(L, -2, "name");
+    }
+    else if (const char* name = t->pe.string(e->name))
+    {
+        lua_pushstring(L, name);
+        lua_setfield(L, -2, "name");
+    }
+    lua_pushinteger(L, e->ordinal);
+    lua_setfield(L, -2, "ordinal");
+    lua_pushinteger(L, e->rva);
+    lua_setfield(L, -2, "rva");
+    if (const char* forwarder = t->pe.string(e->forwarder))
+    {
+        lua_pushstring(L, forwarder);
+        lua_setfield(L, -2, "forwarder");
+    }
+    return 1;
+}
+// exports:names() -> { name, ... } in ordinal order, aliases included
+static int exporttable_names(lua_State* L)
+{
+    ExportTable* t = checkExportTable(L, 1);
+    lua_createtable(L, (int)t->pe.names.size(), 0);
+    lua_Integer n = 0;
+    for (const PeName& name : t->pe.names)
+    {
+        lua_pushstring(L, t->pe.string(name.name));
+        lua_rawseti(L, -2, ++n);
+    }
+    return 1;
+}
+// exports:count() -> exported functions, named ones
+static int exporttable_count(lua_State* L)
+{
+    ExportTable* t = checkExportTable(L, 1);
+    lua_pushinteger(L, (lua_Integer)t->pe.exports.size());
+    lua_pushinteger(L, (lua_Integer)t->pe.namedCount);
+    return 2;
+}
+// exports:module() -> name from the export directory, preferred image base, is 64 bit
+static int exporttable_module(lua_State* L)
+{
+    ExportTable* t = checkExportTable(L, 1);
+    lua_pushlstring(L, t->pe.moduleName.data(), t->pe.moduleName.size());
+    lua_pushinteger(L, (lua_Integer)t->pe.imageBase);
+    lua_pushboolean(L, t->pe.is64);
+    return 3;
+}
+static const luaL_Reg exporttable_methods[] = {
+    {"resolve", exporttable_resolve},
+    {"lookup", exporttable_lookup},
+    {"names", exporttable_names},
+    {"count", exporttable_count},
+    {"module", exporttable_module},
+    {NULL, NULL}
+};
+static int parseExportTable(lua_State* L, const PeSource& src, uint64_t base, bool local)
+{
+    ExportTable* t = newLuaObject<ExportTable>(L, EXPORTTABLENAME, exporttable_methods, nullptr);
+    t->base = base;
+    t->local = local;
+    if (const char* error = t->pe.parse(src))
+    {
+        lua_pushnil(L);
+        lua_pushstring(L, error);
+        return 2;
+    }
+    return 1;
+}
+// Committed, accessible bytes of the allocation starting at base, so a bad
+// header or a pointer that is no module fails the parse instead of faulting.
+static size_t readableExtent(const void* base)
+{
+    const uint8_t* p = (const uint8_t*)base;
+    size_t extent = 0;
+    MEMORY_BASIC_INFORMATION mbi;
+    while (VirtualQuery(p + extent, &mbi, sizeof(mbi)) && mbi.AllocationBase == base && mbi.State == MEM_COMMIT &&
+        !(mbi.Protect & (PAGE_NOACCESS | PAGE_GUARD)))
+        extent += mbi.RegionSize;
+    return extent;
+}
+// ParseExports(module [, process]) -> ExportTable or nil, message. module is
+// an HMODULE of this process, or a base address in process read with
+// ReadProcessMemory.
+Lua_Function(ParseExports)
+{
+    if (lua_isnoneornil(L, 2))
+    {
+        HMODULE mod = luaL_wingetbycheckudata(L, 1, HMODULE);
+        luaL_argcheck(L, mod, 1, "NULL module");
+        const uint8_t* image = (const uint8_t*)mod;
+        size_t extent = readableExtent(image);
+        PeSource src;
+        src.read = [image, extent](uint64_t offset, void* dst, size_t size) {
+            if (offset > extent || extent - offset < size)
+                return false;
+            memcpy(dst, image + offset, size);
+            return true;
+        };
+        return parseExportTable(L, src, (uint64_t)(uintptr_t)mod, true);
+    }
+    HANDLE process = luaL_wingetbycheckudata(L, 2, HANDLE);
+    uint64_t base = lua_islightuserdata(L, 1) ? (uint64_t)(uintptr_t)lua_touserdata(L, 1) : (uint64_t)luaL_checkinteger(L, 1);
+    PeSource src;
+    src.read = [process, base](uint64_t offset, void* dst, size_t size) {
+        SIZE_T got = 0;
+        return ReadProcessMemory(process, (LPCVOID)(uintptr_t)(base + offset), dst, size, &got) && got == size;
+    };
+    return parseExportTable(L, src, base, false);
+}
+// ParseExportsFile(path) -> ExportTable or nil, message. Sections are mapped
+// by hand, resolve returns RVAs.
+Lua_Function(ParseExportsFile)
+{
+    const char* path = luaL_checkstring(L, 1);
+    FILE* file;
+    if (fopen_s(&file, path, "rb") != 0)
+    {
+        lua_pushnil(L);
+        lua_pushfstring(L, "cannot open %s", path);
+        return 2;
+    }
+    int n = parseExportTable(L, peFileSource(file), 0, false);
+    fclose(file);
+    return n;
+}
@@ -0,0 +1,77 @@
+#define GLOBALSNAME "luibexwin.globals"
+static const LuaSubmodule* findSubmodule(std::string_view name)
+{
+    for (const LuaSubmodule* m = luibexwin_submodules; m->name; ++m)
+        if (name == m->name)
+            return m;
+    return nullptr;
+}
+static const luaL_Reg* findModuleFunction(std::string_view name)
+{
+    for (const LuaSubmodule* m = luibexwin_submodules; m->name; ++m)
+        for (const luaL_Reg* r = m->funcs; r->name; ++r)
+            if (name == r->name)
+                return r;
+    return nullptr;
+}
+// __index(module, name): a submodule, then a function of any submodule, then
+// a constant. Whatever is found is stored in the module so this runs once.
+static int module_index(lua_State* L)
+{
+    size_t len;
+    const char* key = lua_type(L, 2) == LUA_TSTRING ? lua_tolstring(L, 2, &len) : nullptr;
+    if (!key)
+        return 0;
+    std::string_view name(key, len);
+    if (name == "constants")
+        push_constants_table(L);
+    else if (const LuaSubmodule* m = findSubmodule(name))
+    {
+        size_t count = 0;
+        while (m->funcs[count].name)
+            ++count;
+        lua_createtable(L, 0, (int)count);
+        luaL_setfuncs(L, m->funcs, 0);
+    }
+    else if (const luaL_Reg* r = findModuleFunction(name))
+        lua_pushcfunction(L, r->func);
+    else if (const LuaConstant* c = findLuaConstant(name))
+        pushLuaConstant(L, *c);
+    else
+        return 0;
+    lua_pushvalue(L, 2);
+    lua_pushvalue(L, -2);
+    lua_rawset(L, 1);
+    return 1;
+}
+
+// InjectGlobals() -> puts every function in the global table and resolves
+// constants as globals, the layout scripts written for ibexwin/h.lua expect.
+Lua_Function(InjectGlobals)
+{
+    if (lua_getfield(L, LUA_REGISTRYINDEX, GLOBALSNAME) != LUA_TNIL)
+        return 0;
+    lua_pop(L, 1);
+    lua_pushglobaltable(L);
+    for (const LuaSubmodule* m = luibexwin_submodules; m->name; ++m)
+        luaL_setfuncs(L, m->funcs, 0);
+    lua_pop(L, 1);
+    register_constants(L);
+    lua_pushboolean(L, 1);
+    lua_setfield(L, LUA_REGISTRYINDEX, GLOBALSNAME);
+    return 0;
+}
+
+// The table returned by require"luibexwin". Submodules (window, message,
+// render, pixel, memory, process, input, shell, system, async, profiler and
+// constants) are built the first time they are read.
+void push_module(lua_State* L)
+{
+    lua_createtable(L, 0, 1);
+    lua_pushcfunction(L, ll_InjectGlobals);
+    lua_setfield(L, -2, "InjectGlobals");
+    lua_createtable(L, 0, 1);
+    lua_pushcfunction(L, module_index);
+    lua_setfield(L, -2, "__index");
+    lua_setmetatable(L, -2);
+}
@@ -0,0 +1,266 @@
+// Field offsets from the PE/COFF specification, read little endian.
+constexpr uint32_t PE_MAX_FUNCTIONS = 1 << 20;
+static uint16_t peU16(const uint8_t* p)
+{
+    return (uint16_t)(p[0] | p[1] << 8);
+}
+static uint32_t peU32(const uint8_t* p)
+{
+    return (uint32_t)p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+}
+static uint64_t peU64(const uint8_t* p)
+{
+    return (uint64_t)peU32(p) | (uint64_t)peU32(p + 4) << 32;
+}
+static uint32_t peHash(std::string_view name)
+{
+    uint32_t h = 2166136261u;
+    for (char c : name)
+    {
+        h ^= (uint8_t)c;
+        h *= 16777619u;
+    }
+    return h;
+}
+namespace {
+struct PeSection
+{
+    uint32_t rva;
+    uint32_t size;
+    uint32_t offset;
+    uint32_t rawSize;
+};
+// Reads by RVA. The export directory is fetched in one read, which covers
+// the tables and names of every common linker, so a remote module costs a
+// handful of ReadProcessMemory calls.
+struct PeImage
+{
+    const PeSource& src;
+    std::vector<PeSection> sections;
+    uint32_t sizeOfImage = 0;
+    uint32_t blockRva = 0;
+    std::vector<uint8_t> block;
+
+    explicit PeImage(const PeSource& src) : src(src) {}
+    bool toOffset(uint32_t rva, size_t size, uint64_t& offset) const
+    {
+        if (src.mapped)
+        {
+            offset = rva;
+            return !sizeOfImage || (uint64_t)rva + size <= sizeOfImage;
+        }
+        for (const PeSection& s : sections)
+        {
+            if (rva >= s.rva && rva - s.rva < std::max(s.size, s.rawSize))
+            {
+                if ((uint64_t)(rva - s.rva) + size > s.rawSize)
+                    return false;
+                offset = (uint64_t)s.offset + (rva - s.rva);
+                return true;
+            }
+        }
+        // Headers come before the first section and are not remapped.
+        offset = rva;
+        return sections.empty() || (uint64_t)rva + size <= sections.front().rva;
+    }
+    bool read(uint32_t rva, void* dst, size_t size) const
+    {
+        if (rva >= blockRva && (uint64_t)rva - blockRva + size <= block.size())
+        {
+            memcpy(dst, block.data() + (rva - blockRva), size);
+            return true;
+        }
+        uint64_t offset;
+        return toOffset(rva, size, offset) && src.read(offset, dst, size);
+    }
+    bool readString(uint32_t rva, std::string& out) const
+    {
+        out.clear();
+        if (rva >= blockRva && rva - blockRva < block.size())
+        {
+            const char* p = (const char*)block.data() + (rva - blockRva);
+            size_t n = strnlen(p, block.size() - (rva - blockRva));
+            if (n < block.size() - (rva - blockRva))
+            {
+                out.assign(p, n);
+                return true;
+            }
+        }
+        char chunk[64];
+        for (uint32_t at = rva; out.size() < 4096; at += sizeof(chunk))
+        {
+            size_t want = sizeof(chunk);
+            // The last bytes of the image may be shorter than a chunk.
+            while (want && !read(at, chunk, want))
+                want /= 2;
+            if (!want)
+                return false;
+            size_t n = strnlen(chunk, want);
+            out.append(chunk, n);
+            if (n < want)
+                return true;
+        }
+        return false;
+    }
+};
+}
+
+const char* PeExports::parse(const PeSource& src)
+{
+    *this = PeExports();
+    PeImage image(src);
+    uint8_t dos[64];
+    if (!src.read(0, dos, sizeof(dos)) || peU16(dos) != 0x5A4D)
+        return "not a PE image (missing MZ header)";
+    uint32_t nt = peU32(dos + 0x3C);
+    if (nt > (1 << 20))
+        return "invalid e_lfanew";
+    uint8_t headers[24 + 240];
+    if (!src.read(nt, headers, sizeof(headers)) || peU32(headers) != 0x00004550)
+        return "not a PE image (missing PE signature)";
+    uint16_t sectionCount = peU16(headers + 6);
+    uint16_t optionalSize = peU16(headers + 20);
+    const uint8_t* opt = headers + 24;
+    uint16_t magic = peU16(opt);
+    if (magic != 0x10B && magic != 0x20B)
+        return "unknown optional header magic";
+    is64 = magic == 0x20B;
+    imageBase = is64 ? peU64(opt + 24) : peU32(opt + 28);
+    sizeOfImage = peU32(opt + 56);
+    uint32_t dirCount = peU32(opt + (is64 ? 108 : 92));
+    const uint8_t* dirs = opt + (is64 ? 112 : 96);
+    if (dirCount == 0 || (size_t)(dirs - opt) + 8 > optionalSize)
+        return nullptr;
+    uint32_t exportRva = peU32(dirs);
+    uint32_t exportSize = peU32(dirs + 4);
+    if (!exportRva || exportSize < 40)
+        return nullptr;
+
+    if (!src.mapped)
+    {
+        std::vector<uint8_t> table((size_t)sectionCount * 40);
+        if (!src.read((uint64_t)nt + 24 + optionalSize, table.data(), table.size()))
+            return "truncated section table";
+        for (uint16_t i = 0; i < sectionCount; ++i)
+        {
+            const uint8_t* s = table.data() + i * 40;
+            image.sections.push_back({ peU32(s + 12), peU32(s + 8), peU32(s + 20), peU32(s + 16) });
+        }
+        std::sort(image.sections.begin(), image.sections.end(), [](const PeSection& a, const PeSection& b) {
+            return a.rva < b.rva;
+        });
+    }
+    else
+        image.sizeOfImage = sizeOfImage;
+
+    // The size is bounded by the image, or the section holding it on disk,
+    // before a buffer of up to 4 GB is allocated for it.
+    uint64_t exportOffset;
+    if ((uint64_t)exportRva + exportSize > sizeOfImage || !image.toOffset(exportRva, exportSize, exportOffset))
+        return "export directory outside the image";
+    std::vector<uint8_t> block(exportSize);
+    if (!image.read(exportRva, block.data(), block.size()))
+        return "unreadable export directory";
+    image.block = std::move(block);
+    image.blockRva = exportRva;
+    const uint8_t* dir = image.block.data();
+    uint32_t nameRva = peU32(dir + 12);
+    ordinalBase = peU32(dir + 16);
+    uint32_t functionCount = peU32(dir + 20);
+    uint32_t nameCount = peU32(dir + 24);
+    uint32_t functionsRva = peU32(dir + 28);
+    uint32_t namesRva = peU32(dir + 32);
+    uint32_t ordinalsRva = peU32(dir + 36);
+    // Aliases can make names outnumber functions.
+    if (functionCount > PE_MAX_FUNCTIONS || nameCount > PE_MAX_FUNCTIONS)
+        return "implausible export counts";
+    if (nameRva)
+        image.readString(nameRva, moduleName);
+
+    std::vector<uint8_t> functions((size_t)functionCount * 4);
+    std::vector<uint8_t> nameRvas((size_t)nameCount * 4);
+    std::vector<uint8_t> ordinals((size_t)nameCount * 2);
+    if ((functionCount && !image.read(functionsRva, functions.data(), functions.size())) ||
+        (nameCount && !image.read(namesRva, nameRvas.data(), nameRvas.size())) ||
+        (nameCount && !image.read(ordinalsRva, ordinals.data(), ordinals.size())))
+        return "unreadable export tables";
+
+    std::string text;
+    exports.resize(functionCount);
+    for (uint32_t i = 0; i < functionCount; ++i)
+    {
+        PeExport& e = exports[i];
+        e.ordinal = ordinalBase + i;
+        e.rva = peU32(functions.data() + i * 4);
+        // An address inside the export directory is a "DLL.Symbol" string.
+        if (e.rva >= exportRva && e.rva - exportRva < exportSize && image.readString(e.rva, text))
+        {
+            e.forwarder = (uint32_t)strings.size();
+            strings.append(text);
+            strings.push_back('\0');
+        }
+    }
+    for (uint32_t i = 0; i < nameCount; ++i)
+    {
+        uint16_t index = peU16(ordinals.data() + i * 2);
+        if (index >= functionCount || !image.readString(peU32(nameRvas.data() + i * 4), text))
+            continue;
+        names.push_back({ (uint32_t)strings.size(), index });
+        if (exports[index].name == PeExport::NO_STRING)
+            exports[index].name = (uint32_t)strings.size();
+        strings.append(text);
+        strings.push_back('\0');
+    }
+    // The name table is sorted by name, aliases of one export stay in that
+    // order.
+    std::stable_sort(names.begin(), names.end(), [](const PeName& a, const PeName& b) {
+        return a.index < b.index;
+    });
+    namedCount = (uint32_t)names.size();
+    buildIndex();
+    return nullptr;
+}
+// Open addressing at most half full, slots keep the hash so a miss rarely
+// compares a string.
+void PeExports::buildIndex()
+{
+    size_t size = 16;
+    while (size < (size_t)namedCount * 2)
+        size <<= 1;
+    slots.assign(size, Slot());
+    for (uint32_t i = 0; i < names.size(); ++i)
+    {
+        uint32_t h = peHash(string(names[i].name));
+        size_t at = h & (size - 1);
+        while (slots[at].index != UINT32_MAX)
+            at = (at + 1) & (size - 1);
+        slots[at] = { h, i };
+    }
+}
+const PeExport* PeExports::find(std::string_view name) const
+{
+    if (slots.empty())
+        return nullptr;
+    uint32_t h = peHash(name);
+    size_t mask = slots.size() - 1;
+    for (size_t at = h & mask; slots[at].index != UINT32_MAX; at = (at + 1) & mask)
+        if (slots[at].hash == h && name == string(names[slots[at].index].name))
+            return &exports[names[slots[at].index].index];
+    return nullptr;
+}
+const PeExport* PeExports::findOrdinal(uint32_t ordinal) const
+{
+    if (ordinal < ordinalBase || ordinal - ordinalBase >= exports.size())
+        return nullptr;
+    const PeExport* e = &exports[ordinal - ordinalBase];
+    return e->rva ? e : nullptr;
+}
+PeSource peFileSource(FILE* file)
+{
+    PeSource src;
+    src.mapped = false;
+    src.read = [file](uint64_t offset, void* dst, size_t size) {
+        return offset <= LONG_MAX && fseek(file, (long)offset, SEEK_SET) == 0 && fread(dst, 1, size, file) == size;
+    };
+    return src;
+}
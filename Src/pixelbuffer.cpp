@@ -0,0 +1,470 @@
+PixelBuffer::~PixelBuffer()
+{
+    if (dc)
+    {
+        SelectObject(dc, oldBitmap);
+        DeleteDC(dc);
+    }
+    if (bitmap)
+        DeleteObject(bitmap);
+}
+PixelBuffer* checkPixelBuffer(lua_State* L, int idx)
+{
+    return luaL_checkobject(L, idx, PixelBuffer, PIXELBUFFERNAME);
+}
+static void fillBitmapInfo(BITMAPINFO& bmi, int width, int height)
+{
+    ZeroMemory(&bmi, sizeof(bmi));
+    bmi.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+    bmi.bmiHeader.biWidth = width;
+    bmi.bmiHeader.biHeight = -height;
+    bmi.bmiHeader.biPlanes = 1;
+    bmi.bmiHeader.biBitCount = 32;
+    bmi.bmiHeader.biCompression = BI_RGB;
+}
+static PixelRect checkPixelRect(lua_State* L, int idx)
+{
+    return pixelRect(luaL_checkinteger(L, idx), luaL_checkinteger(L, idx + 1), luaL_checkinteger(L, idx + 2), luaL_checkinteger(L, idx + 3));
+}
+static int checkPixelCoord(lua_State* L, int idx)
+{
+    return pixelCoord(luaL_checkinteger(L, idx));
+}
+static uint32_t* checkPixelAt(lua_State* L, PixelBuffer* pb, int idx)
+{
+    lua_Integer x = luaL_checkinteger(L, idx);
+    lua_Integer y = luaL_checkinteger(L, idx + 1);
+    luaL_argcheck(L, x >= 0 && x < pb->view.width, idx, "x out of range");
+    luaL_argcheck(L, y >= 0 && y < pb->view.height, idx + 1, "y out of range");
+    return pb->view.row((int)y) + x;
+}
+static int pixelbuffer_size(lua_State* L)
+{
+    PixelBuffer* pb = checkPixelBuffer(L, 1);
+    lua_pushinteger(L, pb->view.width);
+    lua_pushinteger(L, pb->view.height);
+    return 2;
+}
+static int pixelbuffer_stride(lua_State* L)
+{
+    lua_pushinteger(L, checkPixelBuffer(L, 1)->view.stride);
+    return 1;
+}
+static int pixelbuffer_pointer(lua_State* L)
+{
+    lua_pushlightuserdata(L, checkPixelBuffer(L, 1)->view.pixels);
+    return 1;
+}
+static int pixelbuffer_hdc(lua_State* L)
+{
+    PixelBuffer* pb = checkPixelBuffer(L, 1);
+    if (!pb->dc)
+        return 0;
+    pushWindowStruct(L, HDC, pb->dc);
+    return 1;
+}
+static int pixelbuffer_hbitmap(lua_State* L)
+{
+    PixelBuffer* pb = checkPixelBuffer(L, 1);
+    if (!pb->bitmap)
+        return 0;
+    pushWindowStruct(L, HBITMAP, pb->bitmap);
+    return 1;
+}
+static int pixelbuffer_get(lua_State* L)
+{
+    PixelBuffer* pb = checkPixelBuffer(L, 1);
+    lua_pushinteger(L, *checkPixelAt(L, pb, 2));
+    return 1;
+}
+static int pixelbuffer_set(lua_State* L)
+{
+    PixelBuffer* pb = checkPixelBuffer(L, 1);
+    *checkPixelAt(L, pb, 2) = (uint32_t)luaL_checkinteger(L, 4);
+    return 0;
+}
+static int pixelbuffer_fill(lua_State* L)
+{
+    PixelBuffer* pb = checkPixelBuffer(L, 1);
+    pixelFillRect(pb->view, { 0, 0, pb->view.width, pb->view.height }, (uint32_t)luaL_checkinteger(L, 2));
+    return 0;
+}
+static int pixelbuffer_fillrect(lua_State* L)
+{
+    PixelBuffer* pb = checkPixelBuffer(L, 1);
+    pixelFillRect(pb->view, checkPixelRect(L, 2), (uint32_t)luaL_checkinteger(L, 6));
+    return 0;
+}
+// pb:copyRect(src, sx, sy, w, h, dx, dy)
+static int pixelbuffer_copyrect(lua_State* L)
+{
+    PixelBuffer* dst = checkPixelBuffer(L, 1);
+    PixelBuffer* src = checkPixelBuffer(L, 2);
+    PixelRect sr = checkPixelRect(L, 3);
+    pixelCopyRect(dst->view, checkPixelCoord(L, 7), checkPixelCoord(L, 8), src->view, sr);
+    return 0;
+}
+// pb:blit(hdc, x, y [, sx, sy, w, h])
+static int pixelbuffer_blit(lua_State* L)
+{
+    PixelBuffer* pb = checkPixelBuffer(L, 1);
+    HDC hdc = luaL_wingetbycheckudata(L, 2, HDC);
+    int x = (int)luaL_checkinteger(L, 3);
+    int y = (int)luaL_checkinteger(L, 4);
+    int sx = (int)luaL_optinteger(L, 5, 0);
+    int sy = (int)luaL_optinteger(L, 6, 0);
+    int w = (int)luaL_optinteger(L, 7, pb->view.width - sx);
+    int h = (int)luaL_optinteger(L, 8, pb->view.height - sy);
+    BOOL result;
+    if (pb->dc)
+    {
+        GdiFlush();
+        result = BitBlt(hdc, x, y, w, h, pb->dc, sx, sy, SRCCOPY);
+    }
+    else
+    {
+        BITMAPINFO bmi;
+        fillBitmapInfo(bmi, pb->view.stride, pb->view.height);
+        result = StretchDIBits(hdc, x, y, w, h, sx, sy, w, h, pb->view.pixels, &bmi, DIB_RGB_COLORS, SRCCOPY) != 0;
+    }
+    lua_pushboolean(L, result);
+    return 1;
+}
+static int pixelbuffer_blendrect(lua_State* L)
+{
+    PixelBuffer* pb = checkPixelBuffer(L, 1);
+    pixelBlendRect(pb->view, checkPixelRect(L, 2), (uint32_t)luaL_checkinteger(L, 6));
+    return 0;
+}
+// pb:line(x0, y0, x1, y1, color)
+static int pixelbuffer_line(lua_State* L)
+{
+    PixelBuffer* pb = checkPixelBuffer(L, 1);
+    lua_Integer x0 = luaL_checkinteger(L, 2);
+    lua_Integer y0 = luaL_checkinteger(L, 3);
+    lua_Integer x1 = luaL_checkinteger(L, 4);
+    lua_Integer y1 = luaL_checkinteger(L, 5);
+    pixelDrawLine(pb->view, x0, y0, x1, y1, (uint32_t)luaL_checkinteger(L, 6));
+    return 0;
+}
+// pb:composite(src, sx, sy, w, h, dx, dy), src holds premultiplied alpha.
+static int pixelbuffer_composite(lua_State* L)
+{
+    PixelBuffer* dst = checkPixelBuffer(L, 1);
+    PixelBuffer* src = checkPixelBuffer(L, 2);
+    PixelRect sr = checkPixelRect(L, 3);
+    pixelCompositeRect(dst->view, checkPixelCoord(L, 7), checkPixelCoord(L, 8), src->view, sr);
+    return 0;
+}
+// pb:colorKey(src, sx, sy, w, h, dx, dy, key), the alpha byte of key is ignored.
+static int pixelbuffer_colorkey(lua_State* L)
+{
+    PixelBuffer* dst = checkPixelBuffer(L, 1);
+    PixelBuffer* src = checkPixelBuffer(L, 2);
+    PixelRect sr = checkPixelRect(L, 3);
+    pixelColorKeyRect(dst->view, checkPixelCoord(L, 7), checkPixelCoord(L, 8), src->view, sr, (uint32_t)luaL_checkinteger(L, 9));
+    return 0;
+}
+// pb:scale(src, sx, sy, sw, sh, dx, dy, dw, dh [, bilinear])
+static int pixelbuffer_scale(lua_State* L)
+{
+    PixelBuffer* dst = checkPixelBuffer(L, 1);
+    PixelBuffer* src = checkPixelBuffer(L, 2);
+    PixelRect sr = checkPixelRect(L, 3);
+    PixelRect dr = checkPixelRect(L, 7);
+    pixelScaleRect(dst->view, dr, src->view, sr, lua_toboolean(L, 11));
+    return 0;
+}
+// Swaps red and blue in place, BGRA <-> RGBA.
+static int pixelbuffer_swizzle(lua_State* L)
+{
+    PixelBuffer* pb = checkPixelBuffer(L, 1);
+    PixelRect r = lua_isnoneornil(L, 2) ? PixelRect{ 0, 0, pb->view.width, pb->view.height } : checkPixelRect(L, 2);
+    pixelSwizzleRect(pb->view, r);
+    return 0;
+}
+// Converts straight alpha to premultiplied in place, as UpdateLayeredWindow expects.
+static int pixelbuffer_premultiply(lua_State* L)
+{
+    PixelBuffer* pb = checkPixelBuffer(L, 1);
+    PixelRect r = lua_isnoneornil(L, 2) ? PixelRect{ 0, 0, pb->view.width, pb->view.height } : checkPixelRect(L, 2);
+    pixelPremultiplyRect(pb->view, r);
+    return 0;
+}
+// Tolerance is one number for all of R, G and B, or a {r, g, b} table.
+static uint32_t checkTolerance(lua_State* L, int idx)
+{
+    if (!lua_istable(L, idx))
+        return pixelTolerance((int)luaL_optinteger(L, idx, 0));
+    int t[3];
+    for (int i = 0; i < 3; ++i)
+    {
+        lua_rawgeti(L, idx, i + 1);
+        t[i] = (int)luaL_checkinteger(L, -1);
+        lua_pop(L, 1);
+    }
+    return pixelTolerance(t[0], t[1], t[2]);
+}
+static PixelRect optPixelRect(lua_State* L, int idx, const PixelView& v)
+{
+    if (lua_isnoneornil(L, idx))
+        return { 0, 0, v.width, v.height };
+    return checkPixelRect(L, idx);
+}
+static int pushMatch(lua_State* L, bool found, const PixelMatch& m)
+{
+    if (!found)
+        return 0;
+    lua_pushinteger(L, m.x);
+    lua_pushinteger(L, m.y);
+    return 2;
+}
+// pb:findColor(color [, tolerance, threads, x, y, w, h]) -> x, y
+static int pixelbuffer_findcolor(lua_State* L)
+{
+    PixelBuffer* pb = checkPixelBuffer(L, 1);
+    uint32_t color = (uint32_t)luaL_checkinteger(L, 2);
+    uint32_t tol = checkTolerance(L, 3);
+    int threads = (int)luaL_optinteger(L, 4, 1);
+    PixelMatch m;
+    return pushMatch(L, pixelFindColor(pb->view, optPixelRect(L, 5, pb->view), color, tol, threads, &m), m);
+}
+// pb:findAllColors(color [, tolerance, limit]) -> IntArray of x, y pairs
+static int pixelbuffer_findallcolors(lua_State* L)
+{
+    PixelBuffer* pb = checkPixelBuffer(L, 1);
+    uint32_t color = (uint32_t)luaL_checkinteger(L, 2);
+    uint32_t tol = checkTolerance(L, 3);
+    lua_Integer limit = luaL_optinteger(L, 4, 1024);
+    luaL_argcheck(L, limit >= 0, 4, "limit must not be negative");
+    limit = std::min(limit, (lua_Integer)pb->view.width * pb->view.height);
+    std::vector<PixelMatch> matches;
+    bool allocated = true;
+    try
+    {
+        pixelFindAllColors(pb->view, { 0, 0, pb->view.width, pb->view.height }, color, tol, (size_t)limit, matches);
+    }
+    catch (const std::bad_alloc&)
+    {
+        allocated = false;
+    }
+    if (!allocated)
+        return luaL_error(L, "not enough memory for %d matches", (int)limit);
+    IntArray* out = newIntArray(L, matches.size() * 2);
+    for (size_t i = 0; i < matches.size(); ++i)
+    {
+        out->values[i * 2] = matches[i].x;
+        out->values[i * 2 + 1] = matches[i].y;
+    }
+    return 1;
+}
+// pb:findImage(image [, tolerance, threads, x, y, w, h]) -> x, y
+static int pixelbuffer_findimage(lua_State* L)
+{
+    PixelBuffer* pb = checkPixelBuffer(L, 1);
+    PixelBuffer* image = checkPixelBuffer(L, 2);
+    uint32_t tol = checkTolerance(L, 3);
+    int threads = (int)luaL_optinteger(L, 4, 1);
+    PixelMatch m;
+    return pushMatch(L, pixelFindImage(pb->view, optPixelRect(L, 5, pb->view), image->view, tol, threads, &m), m);
+}
+// Raw BGRA bytes, count pixels starting at (x, y) and running along the row.
+static int pixelbuffer_read(lua_State* L)
+{
+    PixelBuffer* pb = checkPixelBuffer(L, 1);
+    uint32_t* p = checkPixelAt(L, pb, 2);
+    lua_Integer count = luaL_optinteger(L, 4, pb->view.width - lua_tointeger(L, 2));
+    lua_Integer avail = pb->view.row(pb->view.height - 1) + pb->view.width - p;
+    luaL_argcheck(L, count >= 0 && count <= avail, 4, "count out of range");
+    lua_pushlstring(L, (const char*)p, (size_t)count * sizeof(uint32_t));
+    return 1;
+}
+static int pixelbuffer_write(lua_State* L)
+{
+    PixelBuffer* pb = checkPixelBuffer(L, 1);
+    uint32_t* p = checkPixelAt(L, pb, 2);
+    size_t len;
+    const char* data = luaL_checklstring(L, 4, &len);
+    size_t avail = (size_t)(pb->view.row(pb->view.height - 1) + pb->view.width - p) * sizeof(uint32_t);
+    luaL_argcheck(L, len <= avail && len % sizeof(uint32_t) == 0, 4, "data does not fit in the buffer");
+    memcpy(p, data, len);
+    return 0;
+}
+static const luaL_Reg pixelbuffer_methods[] = {
+    {"size", pixelbuffer_size},
+    {"stride", pixelbuffer_stride},
+    {"pointer", pixelbuffer_pointer},
+    {"hdc", pixelbuffer_hdc},
+    {"hbitmap", pixelbuffer_hbitmap},
+    {"get", pixelbuffer_get},
+    {"set", pixelbuffer_set},
+    {"fill", pixelbuffer_fill},
+    {"fillRect", pixelbuffer_fillrect},
+    {"copyRect", pixelbuffer_copyrect},
+    {"blendRect", pixelbuffer_blendrect},
+    {"line", pixelbuffer_line},
+    {"composite", pixelbuffer_composite},
+    {"colorKey", pixelbuffer_colorkey},
+    {"scale", pixelbuffer_scale},
+    {"swizzle", pixelbuffer_swizzle},
+    {"premultiply", pixelbuffer_premultiply},
+    {"findColor", pixelbuffer_findcolor},
+    {"findAllColors", pixelbuffer_findallcolors},
+    {"findImage", pixelbuffer_findimage},
+    {"blit", pixelbuffer_blit},
+    {"read", pixelbuffer_read},
+    {"write", pixelbuffer_write},
+    {NULL, NULL}
+};
+PixelBuffer* newPixelBuffer(lua_State* L, int width, int height, bool dib, HDC compatible)
+{
+    if (width <= 0 || height <= 0 || (int64_t)width * height > PIXEL_MAX_PIXELS)
+        luaL_error(L, "invalid pixel buffer size %dx%d", width, height);
+    PixelBuffer* pb = newLuaObject<PixelBuffer>(L, PIXELBUFFERNAME, pixelbuffer_methods, nullptr);
+    pb->view.width = width;
+    pb->view.height = height;
+    pb->view.stride = width;
+    if (!dib)
+    {
+        // bad_alloc must not unwind through the Lua frames.
+        bool allocated = true;
+        try
+        {
+            pb->memory.assign((size_t)width * (size_t)height, 0);
+        }
+        catch (const std::bad_alloc&)
+        {
+            allocated = false;
+        }
+        if (!allocated)
+            luaL_error(L, "not enough memory for a %dx%d pixel buffer", width, height);
+        pb->view.pixels = pb->memory.data();
+        return pb;
+    }
+    BITMAPINFO bmi;
+    fillBitmapInfo(bmi, width, height);
+    void* bits = nullptr;
+    pb->bitmap = CreateDIBSection(compatible, &bmi, DIB_RGB_COLORS, &bits, NULL, 0);
+    if (!pb->bitmap)
+        luaL_error(L, "CreateDIBSection failed (%d)", (int)GetLastError());
+    pb->dc = CreateCompatibleDC(compatible);
+    pb->oldBitmap = SelectObject(pb->dc, pb->bitmap);
+    pb->view.pixels = (uint32_t*)bits;
+    return pb;
+}
+int checkPixelExtent(lua_State* L, int idx)
+{
+    lua_Integer n = luaL_checkinteger(L, idx);
+    luaL_argcheck(L, n > 0 && n <= PIXEL_MAX_PIXELS, idx, "invalid pixel buffer size");
+    return (int)n;
+}
+Lua_Function(CreatePixelBuffer)
+{
+    newPixelBuffer(L, checkPixelExtent(L, 1), checkPixelExtent(L, 2), false);
+    return 1;
+}
+Lua_Function(CreateDIBPixelBuffer)
+{
+    HDC hdc = luaL_wingetbyudata(L, 1, HDC);
+    newPixelBuffer(L, checkPixelExtent(L, 2), checkPixelExtent(L, 3), true, hdc);
+    return 1;
+}
+Lua_Function(ARGB)
+{
+    lua_Integer a = luaL_checkinteger(L, 1) & 0xFF;
+    lua_Integer r = luaL_checkinteger(L, 2) & 0xFF;
+    lua_Integer g = luaL_checkinteger(L, 3) & 0xFF;
+    lua_Integer b = luaL_checkinteger(L, 4) & 0xFF;
+    lua_pushinteger(L, (a << 24) | (r << 16) | (g << 8) | b);
+    return 1;
+}
+static int checkRasterLevel(lua_State* L, int idx)
+{
+    static const char* const names[] = { "scalar", "sse2", "avx2", NULL };
+    return luaL_checkoption(L, idx, NULL, names);
+}
+// RasterKernelLevel([level]) -> active level, best supported level
+Lua_Function(RasterKernelLevel)
+{
+    if (!lua_isnoneornil(L, 1))
+        rasterSetLevel((RasterLevel)checkRasterLevel(L, 1));
+    lua_pushstring(L, rasterKernels().name);
+    lua_pushstring(L, rasterLevelName(rasterSupportedLevel()));
+    return 2;
+}
+// RasterBenchmark([width, height, iterations]) -> { [level] = { [kernel] = megapixels per second } }
+Lua_Function(RasterBenchmark)
+{
+    int width = luaL_opt(L, checkPixelExtent, 1, 1024);
+    int height = luaL_opt(L, checkPixelExtent, 2, 1024);
+    int iterations = (int)luaL_optinteger(L, 3, 20);
+    luaL_argcheck(L, (int64_t)width * height <= PIXEL_MAX_PIXELS, 1, "invalid pixel buffer size");
+    luaL_argcheck(L, iterations > 0, 3, "iterations must be positive");
+    // bad_alloc must not unwind through the Lua frames.
+    std::vector<RasterTiming> timings;
+    bool allocated = true;
+    try
+    {
+        timings = rasterBenchmark(width, height, iterations);
+    }
+    catch (const std::bad_alloc&)
+    {
+        allocated = false;
+    }
+    if (!allocated)
+        luaL_error(L, "not enough memory for a %dx%d benchmark frame", width, height);
+    lua_newtable(L);
+    for (const RasterTiming& t : timings)
+    {
+        if (lua_getfield(L, -1, rasterLevelName(t.level)) != LUA_TTABLE)
+        {
+            lua_pop(L, 1);
+            lua_newtable(L);
+            lua_pushvalue(L, -1);
+            lua_setfield(L, -3, rasterLevelName(t.level));
+        }
+        lua_pushnumber(L, t.megapixelsPerSecond);
+        lua_setfield(L, -2, t.kernel);
+        lua_pop(L, 1);
+    }
+    return 1;
+}
+// PixelSearchBenchmark([width = 3840, height = 2160, threads, iterations = 10])
+// -> { { name, threads, mps }, ... }
+Lua_Function(PixelSearchBenchmark)
+{
+    int width = luaL_opt(L, checkPixelExtent, 1, 3840);
+    int height = luaL_opt(L, checkPixelExtent, 2, 2160);
+    int threads = (int)luaL_optinteger(L, 3, (lua_Integer)std::max(1u, std::thread::hardware_concurrency()));
+    int iterations = (int)luaL_optinteger(L, 4, 10);
+    luaL_argcheck(L, width >= 32 && height >= 32, 1, "frame must be at least 32x32");
+    luaL_argcheck(L, (int64_t)width * height <= PIXEL_MAX_PIXELS, 1, "invalid pixel buffer size");
+    luaL_argcheck(L, threads >= 1, 3, "threads must be positive");
+    luaL_argcheck(L, iterations >= 1, 4, "iterations must be positive");
+    // bad_alloc must not unwind through the Lua frames.
+    std::vector<PixelSearchTiming> timings;
+    bool allocated = true;
+    try
+    {
+        timings = pixelSearchBenchmark(width, height, threads, iterations);
+    }
+    catch (const std::bad_alloc&)
+    {
+        allocated = false;
+    }
+    if (!allocated)
+        luaL_error(L, "not enough memory for a %dx%d benchmark frame", width, height);
+    lua_createtable(L, (int)timings.size(), 0);
+    for (size_t i = 0; i < timings.size(); ++i)
+    {
+        lua_createtable(L, 0, 3);
+        lua_pushstring(L, timings[i].name.c_str());
+        lua_setfield(L, -2, "name");
+        lua_pushinteger(L, timings[i].threads);
+        lua_setfield(L, -2, "threads");
+        lua_pushnumber(L, timings[i].megapixelsPerSecond);
+        lua_setfield(L, -2, "mps");
+        lua_rawseti(L, -2, (lua_Integer)i + 1);
+    }
+    return 1;
+}
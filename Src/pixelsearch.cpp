@@ -0,0 +1,245 @@
+uint32_t pixelTolerance(int tolerance)
+{
+    return pixelTolerance(tolerance, tolerance, tolerance);
+}
+uint32_t pixelTolerance(int r, int g, int b)
+{
+    auto lane = [](int t) { return (uint32_t)std::clamp(t, 0, 255); };
+    return 0xFF000000 | (lane(r) << 16) | (lane(g) << 8) | lane(b);
+}
+// Bands of one search. The caller and the pool workers claim them from
+// next, so a search never waits for a band that nobody has started.
+struct SearchJob
+{
+    std::function<void(int)> band;
+    int bands = 0;
+    std::atomic<int> next{ 0 };
+    int done = 0;
+    std::mutex lock;
+    std::condition_variable finished;
+
+    void work()
+    {
+        for (int b; (b = next.fetch_add(1)) < bands;)
+        {
+            band(b);
+            std::lock_guard<std::mutex> guard(lock);
+            if (++done == bands)
+                finished.notify_all();
+        }
+    }
+};
+// One worker per hardware thread besides the caller, started on the first
+// threaded search and shared by every later one.
+class SearchPool
+{
+public:
+    static SearchPool& instance()
+    {
+        // Never destroyed, joining from a static destructor would run under
+        // the loader lock when the module is unloaded.
+        static SearchPool* pool = new SearchPool;
+        return *pool;
+    }
+    int threads() const { return (int)workers + 1; }
+    void run(int bands, std::function<void(int)> band)
+    {
+        auto job = std::make_shared<SearchJob>();
+        job->band = std::move(band);
+        job->bands = bands;
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            for (int i = 1; i < bands; ++i)
+                queue.push_back(job);
+        }
+        wake.notify_all();
+        job->work();
+        std::unique_lock<std::mutex> guard(job->lock);
+        job->finished.wait(guard, [&] { return job->done == job->bands; });
+    }
+
+private:
+    SearchPool() : workers(std::max(1u, std::thread::hardware_concurrency()) - 1)
+    {
+#ifdef GET_MODULE_HANDLE_EX_FLAG_PIN
+        // The workers are never stopped and run code of this module, so it is
+        // pinned in the process, FreeLibrary no longer unloads it. Only the
+        // Windows build sees windows.h.
+        HMODULE self;
+        GetModuleHandleExA(GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS | GET_MODULE_HANDLE_EX_FLAG_PIN, (LPCSTR)&pixelSearchBenchmark, &self);
+#endif
+        for (unsigned i = 0; i < workers; ++i)
+            std::thread([this] { loop(); }).detach();
+    }
+    void loop()
+    {
+        for (;;)
+        {
+            std::shared_ptr<SearchJob> job;
+            {
+                std::unique_lock<std::mutex> guard(lock);
+                wake.wait(guard, [&] { return !queue.empty(); });
+                job = std::move(queue.front());
+                queue.pop_front();
+            }
+            job->work();
+        }
+    }
+    unsigned workers;
+    std::mutex lock;
+    std::condition_variable wake;
+    std::deque<std::shared_ptr<SearchJob>> queue;
+};
+// Runs search(y) -> x or -1 over [y0, y1) and keeps the first match in row
+// major order. Bands below an already found match stop early.
+template<typename RowSearch>
+static bool searchRows(int y0, int y1, int threads, RowSearch search, PixelMatch* match)
+{
+    int rows = y1 - y0;
+    if (rows <= 0)
+        return false;
+    threads = std::min(threads, rows);
+    if (threads > 1)
+        threads = std::min(threads, SearchPool::instance().threads());
+    threads = std::max(threads, 1);
+    std::atomic<int64_t> best{ INT64_MAX };
+    auto band = [&](int b) {
+        int start = y0 + (int)((int64_t)rows * b / threads);
+        int end = y0 + (int)((int64_t)rows * (b + 1) / threads);
+        for (int y = start; y < end; ++y)
+        {
+            if (((int64_t)y << 32) > best.load(std::memory_order_relaxed))
+                return;
+            int x = search(y);
+            if (x < 0)
+                continue;
+            int64_t key = ((int64_t)y << 32) | (uint32_t)x;
+            int64_t current = best.load();
+            while (key < current && !best.compare_exchange_weak(current, key))
+                ;
+            return;
+        }
+    };
+    if (threads == 1)
+        band(0);
+    else
+        SearchPool::instance().run(threads, band);
+    int64_t found = best.load();
+    if (found == INT64_MAX)
+        return false;
+    match->x = (int)(uint32_t)found;
+    match->y = (int)(found >> 32);
+    return true;
+}
+bool pixelFindColor(const PixelView& v, PixelRect r, uint32_t color, uint32_t tol, int threads, PixelMatch* match)
+{
+    if (!pixelClipRect(v, r))
+        return false;
+    auto findColor = rasterKernels().findColor;
+    return searchRows(r.y, r.y + r.h, threads, [&](int y) {
+        int x = findColor(v.row(y) + r.x, r.w, color, tol);
+        return x < 0 ? -1 : r.x + x;
+    }, match);
+}
+size_t pixelFindAllColors(const PixelView& v, PixelRect r, uint32_t color, uint32_t tol, size_t limit, std::vector<PixelMatch>& out)
+{
+    if (!pixelClipRect(v, r))
+        return 0;
+    auto findColor = rasterKernels().findColor;
+    size_t found = 0;
+    for (int y = r.y; y < r.y + r.h && found < limit; ++y)
+    {
+        const uint32_t* row = v.row(y);
+        for (int x = r.x; x < r.x + r.w && found < limit;)
+        {
+            int hit = findColor(row + x, r.x + r.w - x, color, tol);
+            if (hit < 0)
+                break;
+            out.push_back({ x + hit, y });
+            ++found;
+            x += hit + 1;
+        }
+    }
+    return found;
+}
+// Candidates come from searching for the first pixel of the image, each one
+// is then verified row by row.
+bool pixelFindImage(const PixelView& v, PixelRect r, const PixelView& image, uint32_t tol, int threads, PixelMatch* match)
+{
+    if (image.width <= 0 || image.height <= 0 || !pixelClipRect(v, r) || r.w < image.width || r.h < image.height)
+        return false;
+    const RasterKernels& k = rasterKernels();
+    uint32_t first = image.pixels[0];
+    int lastX = r.x + r.w - image.width;
+    return searchRows(r.y, r.y + r.h - image.height + 1, threads, [&](int y) {
+        const uint32_t* row = v.row(y);
+        for (int x = r.x; x <= lastX;)
+        {
+            int hit = k.findColor(row + x, lastX - x + 1, first, tol);
+            if (hit < 0)
+                return -1;
+            x += hit;
+            bool same = true;
+            for (int iy = 0; iy < image.height && same; ++iy)
+                same = k.near(v.row(y + iy) + x, image.row(iy), image.width, tol);
+            if (same)
+                return x;
+            ++x;
+        }
+        return -1;
+    }, match);
+}
+
+std::vector<PixelSearchTiming> pixelSearchBenchmark(int width, int height, int threads, int iterations)
+{
+    std::vector<uint32_t> frame((size_t)width * height);
+    uint32_t seed = 0x9E3779B9;
+    for (uint32_t& p : frame)
+    {
+        seed ^= seed << 13;
+        seed ^= seed >> 17;
+        seed ^= seed << 5;
+        // Keep the noise away from the searched colors.
+        p = 0xFF000000 | (seed & 0x007F7F7F);
+    }
+    PixelView view{ frame.data(), width, height, width };
+    const int tw = std::min(32, width), th = std::min(32, height);
+    std::vector<uint32_t> tmpl((size_t)tw * th);
+    for (int y = 0; y < th; ++y)
+        for (int x = 0; x < tw; ++x)
+            tmpl[(size_t)y * tw + x] = 0xFF800000 | (uint32_t)(x * 4) << 8 | (uint32_t)(y * 4);
+    PixelView image{ tmpl.data(), tw, th, tw };
+    pixelCopyRect(view, width - tw, height - th, image, { 0, 0, tw, th });
+    PixelRect all{ 0, 0, width, height };
+
+    struct Case
+    {
+        const char* name;
+        std::function<void(int)> run;
+    };
+    PixelMatch m;
+    const Case cases[] = {
+        { "findColor", [&](int t) { pixelFindColor(view, all, 0xFFFFFFFF, pixelTolerance(0), t, &m); } },
+        { "findColorTolerant", [&](int t) { pixelFindColor(view, all, 0xFFFFFFFF, pixelTolerance(16), t, &m); } },
+        { "findImage", [&](int t) { pixelFindImage(view, all, image, pixelTolerance(0), t, &m); } },
+        { "findImageTolerant", [&](int t) { pixelFindImage(view, all, image, pixelTolerance(8), t, &m); } },
+    };
+    std::vector<PixelSearchTiming> timings;
+    for (const Case& c : cases)
+    {
+        std::vector<int> threadCounts = { 1 };
+        if (threads > 1)
+            threadCounts.push_back(threads);
+        for (int t : threadCounts)
+        {
+            c.run(t);
+            auto start = std::chrono::steady_clock::now();
+            for (int i = 0; i < iterations; ++i)
+                c.run(t);
+            double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            double pixels = (double)width * height * iterations;
+            timings.push_back({ c.name, t, seconds > 0 ? pixels / seconds / 1e6 : 0 });
+        }
+    }
+    return timings;
+}
@@ -0,0 +1,62 @@
+int pixelCoord(int64_t v)
+{
+    return (int)std::clamp(v, -PIXEL_COORD_LIMIT, PIXEL_COORD_LIMIT);
+}
+PixelRect pixelRect(int64_t x, int64_t y, int64_t w, int64_t h)
+{
+    // Far enough out that adding cannot overflow.
+    constexpr int64_t wide = (int64_t)1 << 61;
+    x = std::clamp(x, -wide, wide);
+    y = std::clamp(y, -wide, wide);
+    int x1 = pixelCoord(x + std::clamp(w, -wide, wide));
+    int y1 = pixelCoord(y + std::clamp(h, -wide, wide));
+    int x0 = pixelCoord(x), y0 = pixelCoord(y);
+    return { x0, y0, x1 - x0, y1 - y0 };
+}
+bool pixelClipRect(const PixelView& v, PixelRect& r)
+{
+    int64_t x0 = std::max<int64_t>(r.x, 0);
+    int64_t y0 = std::max<int64_t>(r.y, 0);
+    int64_t x1 = std::min<int64_t>((int64_t)r.x + r.w, v.width);
+    int64_t y1 = std::min<int64_t>((int64_t)r.y + r.h, v.height);
+    if (x1 <= x0 || y1 <= y0)
+        return false;
+    r = { (int)x0, (int)y0, (int)(x1 - x0), (int)(y1 - y0) };
+    return true;
+}
+void pixelFillRect(const PixelView& dst, PixelRect r, uint32_t color)
+{
+    if (!pixelClipRect(dst, r))
+        return;
+    auto fill = rasterKernels().fill;
+    for (int y = r.y; y < r.y + r.h; ++y)
+        fill(dst.row(y) + r.x, r.w, color);
+}
+bool pixelClipCopy(const PixelView& dst, int& dx, int& dy, const PixelView& src, PixelRect& sr)
+{
+    int64_t sx = sr.x, sy = sr.y, w = sr.w, h = sr.h, x = dx, y = dy;
+    if (sx < 0) { x -= sx; w += sx; sx = 0; }
+    if (sy < 0) { y -= sy; h += sy; sy = 0; }
+    if (x < 0) { sx -= x; w += x; x = 0; }
+    if (y < 0) { sy -= y; h += y; y = 0; }
+    w = std::min({ w, src.width - sx, dst.width - x });
+    h = std::min({ h, src.height - sy, dst.height - y });
+    if (w <= 0 || h <= 0)
+        return false;
+    dx = (int)x;
+    dy = (int)y;
+    sr = { (int)sx, (int)sy, (int)w, (int)h };
+    return true;
+}
+// Overlapping copies inside one buffer are allowed.
+void pixelCopyRect(const PixelView& dst, int dx, int dy, const PixelView& src, PixelRect sr)
+{
+    if (!pixelClipCopy(dst, dx, dy, src, sr))
+        return;
+    bool backwards = dst.pixels == src.pixels && dy > sr.y;
+    for (int i = 0; i < sr.h; ++i)
+    {
+        int r = backwards ? sr.h - 1 - i : i;
+        memmove(dst.row(dy + r) + dx, src.row(sr.y + r) + sr.x, (size_t)sr.w * sizeof(uint32_t));
+    }
+}
@@ -0,0 +1,408 @@
+#define PROCESSPOOLNAME "luibexwin.ProcessPool"
+// Command lines run at most concurrency at a time, every child in one job
+// object killed when the pool is closed or collected. Exits are watched by
+// thread pool waits (see spawn.cpp), so the number of running children is not
+// bound by MAXIMUM_WAIT_OBJECTS. Finished commands are reported to Lua in
+// batches, one scheduler task for everything that ended since the last one.
+struct PoolJob
+{
+    SpawnedProcess proc;
+    lua_Integer id = 0;
+    std::string command;
+    uint64_t queuedMs = 0;
+    DWORD error = 0;
+    bool cancelled = false;
+    ~PoolJob()
+    {
+        closeProcess(&proc);
+    }
+};
+struct ProcessPool
+{
+    HANDLE job = NULL;
+    Scheduler* scheduler = nullptr;
+    int selfRef = LUA_NOREF;
+    size_t concurrency = 1;
+    bool capture = true;
+    bool hasCwd = false;
+    std::string cwd;
+    DWORD flags = CREATE_NO_WINDOW;
+    lua_Integer completion = 0;
+    lua_Integer nextId = 1;
+    std::deque<std::unique_ptr<PoolJob>> queue;
+    std::vector<std::unique_ptr<PoolJob>> running;
+    std::vector<std::unique_ptr<PoolJob>> finished;
+    int outstanding = 0;
+    bool deliveryQueued = false;
+    bool closing = false;
+    ~ProcessPool()
+    {
+        // Closing the job kills the children, their pipes are drained after.
+        closing = true;
+        if (job)
+            CloseHandle(job);
+        queue.clear();
+        running.clear();
+        finished.clear();
+    }
+};
+static ProcessPool* checkProcessPool(lua_State* L, int idx)
+{
+    return luaL_checkobject(L, idx, ProcessPool, PROCESSPOOLNAME);
+}
+static void deliverPoolResults(lua_State* L, ProcessPool* pool);
+static void queuePoolDelivery(ProcessPool* pool)
+{
+    if (pool->deliveryQueued)
+        return;
+    pool->deliveryQueued = true;
+    postSchedulerTask(pool->scheduler, [pool](lua_State* L) { deliverPoolResults(L, pool); });
+}
+static void startQueuedJobs(ProcessPool* pool);
+// Completion routine context, see SpawnedProcess::onFinish.
+static void poolJobFinished(ProcessPool* pool, PoolJob* job)
+{
+    if (pool->closing)
+        return;
+    for (size_t i = 0; i < pool->running.size(); ++i)
+    {
+        if (pool->running[i].get() == job)
+        {
+            pool->finished.push_back(std::move(pool->running[i]));
+            pool->running.erase(pool->running.begin() + i);
+            break;
+        }
+    }
+    queuePoolDelivery(pool);
+    startQueuedJobs(pool);
+}
+static void startQueuedJobs(ProcessPool* pool)
+{
+    while (!pool->closing && pool->running.size() < pool->concurrency && !pool->queue.empty())
+    {
+        std::unique_ptr<PoolJob> job = std::move(pool->queue.front());
+        pool->queue.pop_front();
+        PoolJob* raw = job.get();
+        if (!pool->capture)
+            raw->proc.onOutput = [](SpawnedProcess*, SpawnStream& s, size_t) { s.data.clear(); };
+        raw->proc.onFinish = [pool, raw](SpawnedProcess*) { poolJobFinished(pool, raw); };
+        if (startProcess(&raw->proc, raw->command.c_str(), pool->hasCwd ? pool->cwd.c_str() : nullptr, pool->job, pool->flags))
+            pool->running.push_back(std::move(job));
+        else
+        {
+            raw->error = GetLastError();
+            pool->finished.push_back(std::move(job));
+            queuePoolDelivery(pool);
+        }
+    }
+}
+// { id, command, tag, exitCode, ms, queuedMs, stdout, stderr, error, cancelled }
+static void pushPoolResult(lua_State* L, int tags, PoolJob* job, bool capture)
+{
+    lua_createtable(L, 0, 8);
+    lua_pushinteger(L, job->id);
+    lua_setfield(L, -2, "id");
+    lua_pushlstring(L, job->command.data(), job->command.size());
+    lua_setfield(L, -2, "command");
+    lua_rawgeti(L, tags, job->id);
+    lua_setfield(L, -2, "tag");
+    lua_pushnil(L);
+    lua_rawseti(L, tags, job->id);
+    if (job->proc.exited)
+    {
+        lua_pushinteger(L, (lua_Integer)job->proc.exitCode);
+        lua_setfield(L, -2, "exitCode");
+    }
+    if (job->proc.startMs)
+    {
+        lua_pushinteger(L, (lua_Integer)(job->proc.endMs - job->proc.startMs));
+        lua_setfield(L, -2, "ms");
+        lua_pushinteger(L, (lua_Integer)(job->proc.startMs - job->queuedMs));
+        lua_setfield(L, -2, "queuedMs");
+    }
+    if (capture && job->proc.startMs)
+    {
+        lua_pushlstring(L, job->proc.out.data.data(), job->proc.out.data.size());
+        lua_setfield(L, -2, "stdout");
+        lua_pushlstring(L, job->proc.err.data.data(), job->proc.err.data.size());
+        lua_setfield(L, -2, "stderr");
+    }
+    if (job->error)
+    {
+        lua_pushinteger(L, (lua_Integer)job->error);
+        lua_setfield(L, -2, "error");
+    }
+    if (job->cancelled)
+    {
+        lua_pushboolean(L, 1);
+        lua_setfield(L, -2, "cancelled");
+    }
+}
+// The batch goes to onBatch(pool, results) and to coroutines in pool:await(),
+// with neither it is kept for pool:results().
+static void deliverPoolResults(lua_State* L, ProcessPool* pool)
+{
+    pool->deliveryQueued = false;
+    if (pool->finished.empty())
+        return;
+    std::vector<std::unique_ptr<PoolJob>> jobs;
+    jobs.swap(pool->finished);
+    lua_rawgeti(L, LUA_REGISTRYINDEX, pool->selfRef);
+    int self = lua_gettop(L);
+    lua_getuservalue(L, self);
+    int uv = self + 1;
+    lua_getfield(L, uv, "tags");
+    int tags = uv + 1;
+    lua_createtable(L, (int)jobs.size(), 0);
+    int batch = tags + 1;
+    for (size_t i = 0; i < jobs.size(); ++i)
+    {
+        pushPoolResult(L, tags, jobs[i].get(), pool->capture);
+        lua_rawseti(L, batch, (lua_Integer)i + 1);
+    }
+    int count = (int)jobs.size();
+    jobs.clear();
+
+    lua_pushvalue(L, batch);
+    int woken = signalSchedulerCompletion(L, pool->scheduler, pool->completion, 1);
+    lua_getfield(L, uv, "onBatch");
+    bool hasCallback = lua_isfunction(L, -1);
+    if (hasCallback)
+    {
+        lua_pushvalue(L, self);
+        lua_pushvalue(L, batch);
+        if (lua_pcall(L, 2, 0, 0) != LUA_OK)
+            reportSchedulerError(L, "ProcessPool onBatch");
+    }
+    else
+        lua_pop(L, 1);
+    if (!hasCallback && !woken)
+    {
+        lua_getfield(L, uv, "unread");
+        lua_Integer n = (lua_Integer)lua_rawlen(L, -1);
+        for (int i = 1; i <= count; ++i)
+        {
+            lua_rawgeti(L, batch, i);
+            lua_rawseti(L, -2, n + i);
+        }
+        lua_pop(L, 1);
+    }
+    lua_settop(L, self - 1);
+
+    pool->outstanding -= count;
+    if (pool->outstanding == 0 && pool->selfRef != LUA_NOREF)
+    {
+        luaL_unref(L, LUA_REGISTRYINDEX, pool->selfRef);
+        pool->selfRef = LUA_NOREF;
+        addSchedulerWork(pool->scheduler, -1);
+    }
+}
+// pool:submit(commandLine [, tag]) -> id
+static int processpool_submit(lua_State* L)
+{
+    ProcessPool* pool = checkProcessPool(L, 1);
+    size_t len;
+    const char* command = luaL_checklstring(L, 2, &len);
+    if (pool->closing)
+        return luaL_error(L, "process pool is closed");
+    auto job = std::make_unique<PoolJob>();
+    job->id = pool->nextId++;
+    job->command.assign(command, len);
+    job->queuedMs = TimerWheel::now();
+    if (!lua_isnoneornil(L, 3))
+    {
+        lua_getuservalue(L, 1);
+        lua_getfield(L, -1, "tags");
+        lua_pushvalue(L, 3);
+        lua_rawseti(L, -2, job->id);
+        lua_pop(L, 2);
+    }
+    // Anchored while anything is queued, running or undelivered.
+    if (pool->outstanding++ == 0)
+    {
+        lua_pushvalue(L, 1);
+        pool->selfRef = luaL_ref(L, LUA_REGISTRYINDEX);
+        addSchedulerWork(pool->scheduler, 1);
+    }
+    lua_Integer id = job->id;
+    pool->queue.push_back(std::move(job));
+    startQueuedJobs(pool);
+    lua_pushinteger(L, id);
+    return 1;
+}
+// pool:counts() -> queued, running, finished but not yet delivered
+static int processpool_counts(lua_State* L)
+{
+    ProcessPool* pool = checkProcessPool(L, 1);
+    lua_pushinteger(L, (lua_Integer)pool->queue.size());
+    lua_pushinteger(L, (lua_Integer)pool->running.size());
+    lua_pushinteger(L, (lua_Integer)pool->finished.size());
+    return 3;
+}
+// pool:results() -> results kept because nobody received their batch
+static int processpool_results(lua_State* L)
+{
+    checkProcessPool(L, 1);
+    lua_getuservalue(L, 1);
+    lua_getfield(L, -1, "unread");
+    lua_newtable(L);
+    lua_setfield(L, -3, "unread");
+    return 1;
+}
+// pool:wait([ms]) -> true once every submitted command was delivered. Blocks
+// in an alertable wait, for scripts without RunScheduler.
+static int processpool_wait(lua_State* L)
+{
+    ProcessPool* pool = checkProcessPool(L, 1);
+    lua_Integer ms = luaL_optinteger(L, 2, -1);
+    uint64_t deadline = TimerWheel::now() + (uint64_t)(ms < 0 ? 0 : ms);
+    while (pool->outstanding > 0 && !pool->closing)
+    {
+        runSchedulerTasks(L, pool->scheduler);
+        if (pool->outstanding == 0)
+            break;
+        uint64_t now = TimerWheel::now();
+        if (ms >= 0 && now >= deadline)
+            break;
+        SleepEx(ms < 0 ? INFINITE : (DWORD)(deadline - now), TRUE);
+    }
+    lua_pushboolean(L, pool->outstanding == 0);
+    return 1;
+}
+// pool:await() -> next batch, from a scheduler coroutine
+static int processpool_await(lua_State* L)
+{
+    ProcessPool* pool = checkProcessPool(L, 1);
+    lua_settop(L, 0);
+    lua_pushinteger(L, pool->completion);
+    return ll_AwaitCompletion(L);
+}
+// pool:cancel([exitCode = 1]) drops the queue and kills the running children,
+// everything still comes back as results.
+static int processpool_cancel(lua_State* L)
+{
+    ProcessPool* pool = checkProcessPool(L, 1);
+    UINT code = (UINT)luaL_optinteger(L, 2, 1);
+    while (!pool->queue.empty())
+    {
+        pool->queue.front()->cancelled = true;
+        pool->finished.push_back(std::move(pool->queue.front()));
+        pool->queue.pop_front();
+    }
+    if (!pool->finished.empty())
+        queuePoolDelivery(pool);
+    TerminateJobObject(pool->job, code);
+    return 0;
+}
+// pool:setConcurrency(n)
+static int processpool_setconcurrency(lua_State* L)
+{
+    ProcessPool* pool = checkProcessPool(L, 1);
+    lua_Integer n = luaL_checkinteger(L, 2);
+    luaL_argcheck(L, n >= 1, 2, "concurrency must be at least 1");
+    pool->concurrency = (size_t)n;
+    startQueuedJobs(pool);
+    return 0;
+}
+// pool:job() -> job object HANDLE, owned by the pool
+static int processpool_job(lua_State* L)
+{
+    pushWindowStruct(L, HANDLE, checkProcessPool(L, 1)->job);
+    return 1;
+}
+static const luaL_Reg processpool_methods[] = {
+    {"submit", processpool_submit},
+    {"counts", processpool_counts},
+    {"results", processpool_results},
+    {"wait", processpool_wait},
+    {"await", processpool_await},
+    {"cancel", processpool_cancel},
+    {"setConcurrency", processpool_setconcurrency},
+    {"job", processpool_job},
+    {NULL, NULL}
+};
+static lua_Integer optPoolField(lua_State* L, int idx, const char* name, lua_Integer def)
+{
+    if (lua_isnoneornil(L, idx))
+        return def;
+    lua_getfield(L, idx, name);
+    lua_Integer v = luaL_optinteger(L, -1, def);
+    lua_pop(L, 1);
+    return v;
+}
+// CreateProcessPool([options]) -> ProcessPool
+// options: concurrency (default the processor count), cwd, flags (creation
+// flags, default CREATE_NO_WINDOW), capture (default true), onBatch(pool,
+// results), completion (AwaitCompletion key of the batches) and the job
+// limits processMemory, jobMemory (bytes) and processTime (CPU ms).
+Lua_Function(CreateProcessPool)
+{
+    if (!lua_isnoneornil(L, 1))
+        luaL_checktype(L, 1, LUA_TTABLE);
+    lua_Integer concurrency = optPoolField(L, 1, "concurrency", (lua_Integer)std::max(1u, std::thread::hardware_concurrency()));
+    luaL_argcheck(L, concurrency >= 1, 1, "concurrency must be at least 1");
+    lua_Integer processMemory = optPoolField(L, 1, "processMemory", 0);
+    lua_Integer jobMemory = optPoolField(L, 1, "jobMemory", 0);
+    lua_Integer processTime = optPoolField(L, 1, "processTime", 0);
+
+    HANDLE job = CreateJobObjectA(NULL, NULL);
+    if (!job)
+        return luaL_error(L, "CreateJobObject failed (%d)", (int)GetLastError());
+    JOBOBJECT_EXTENDED_LIMIT_INFORMATION limits;
+    ZeroMemory(&limits, sizeof(limits));
+    limits.BasicLimitInformation.LimitFlags = JOB_OBJECT_LIMIT_KILL_ON_JOB_CLOSE | JOB_OBJECT_LIMIT_DIE_ON_UNHANDLED_EXCEPTION;
+    if (processMemory > 0)
+    {
+        limits.BasicLimitInformation.LimitFlags |= JOB_OBJECT_LIMIT_PROCESS_MEMORY;
+        limits.ProcessMemoryLimit = (SIZE_T)processMemory;
+    }
+    if (jobMemory > 0)
+    {
+        limits.BasicLimitInformation.LimitFlags |= JOB_OBJECT_LIMIT_JOB_MEMORY;
+        limits.JobMemoryLimit = (SIZE_T)jobMemory;
+    }
+    if (processTime > 0)
+    {
+        limits.BasicLimitInformation.LimitFlags |= JOB_OBJECT_LIMIT_PROCESS_TIME;
+        limits.BasicLimitInformation.PerProcessUserTimeLimit.QuadPart = processTime * 10000;
+    }
+    if (!SetInformationJobObject(job, JobObjectExtendedLimitInformation, &limits, sizeof(limits)))
+    {
+        DWORD error = GetLastError();
+        CloseHandle(job);
+        return luaL_error(L, "SetInformationJobObject failed (%d)", (int)error);
+    }
+
+    // Created first so it is finalized after the pool on lua_close.
+    Scheduler* scheduler = getScheduler(L);
+    ProcessPool* pool = newLuaObject<ProcessPool>(L, PROCESSPOOLNAME, processpool_methods, nullptr);
+    int self = lua_gettop(L);
+    pool->job = job;
+    pool->scheduler = scheduler;
+    pool->concurrency = (size_t)concurrency;
+    pool->completion = (lua_Integer)(intptr_t)pool;
+    lua_createtable(L, 0, 3);
+    lua_newtable(L);
+    lua_setfield(L, -2, "tags");
+    lua_newtable(L);
+    lua_setfield(L, -2, "unread");
+    if (!lua_isnoneornil(L, 1))
+    {
+        pool->flags = (DWORD)optPoolField(L, 1, "flags", pool->flags);
+        pool->completion = optPoolField(L, 1, "completion", pool->completion);
+        lua_getfield(L, 1, "capture");
+        pool->capture = lua_isnil(L, -1) || lua_toboolean(L, -1);
+        lua_pop(L, 1);
+        lua_getfield(L, 1, "cwd");
+        if (const char* cwd = luaL_optstring(L, -1, nullptr))
+        {
+            pool->hasCwd = true;
+            pool->cwd = cwd;
+        }
+        lua_pop(L, 1);
+        lua_getfield(L, 1, "onBatch");
+        lua_setfield(L, -2, "onBatch");
+    }
+    lua_setuservalue(L, self);
+    return 1;
+}
@@ -18,93 +18,96 @@ static void getLProcTable(lua_State* L, const std::string& regName)
     }
 }
 
-static bool hasEqualFunction(lua_State* L, int funcIndex, int tableIndex, size_t tableLen, size_t& equalFunci)
+// Slot allocator for the functions stored in each registry table: freed
+// slots are reused through a free list and equal functions share a slot.
+struct ProcSlots
 {
-    funcIndex = lua_absindex(L, funcIndex);
-    tableIndex = lua_absindex(L, tableIndex);
+    std::vector<int> refcounts{ 0 };
+    std::vector<const void*> keys{ nullptr };
+    std::vector<int> freeSlots;
+    std::unordered_map<const void*, int> byFunction;
+};
+struct ProcSlotTables
+{
+    std::unordered_map<std::string, ProcSlots> tables;
+};
+static ProcSlots& getProcSlots(lua_State* L, const std::string& regName)
+{
+    return getRegistryObject<ProcSlotTables>(L, "luibexwin.ProcSlots")->tables[regName];
+}
 
-    for (size_t i = 1; i <= tableLen; ++i)
+int addLWinProc(lua_State* L, int index, const std::string& regName)
+{
+    int funcIndex = lua_absindex(L, index);
+    ProcSlots& slots = getProcSlots(L, regName);
+    const void* key = lua_topointer(L, funcIndex);
+    if (key)
     {
-        lua_geti(L, tableIndex, i);
-        bool isEqual = lua_rawequal(L, funcIndex, -1);
-        lua_pop(L, 1);
-        if (isEqual)
+        auto it = slots.byFunction.find(key);
+        if (it != slots.byFunction.end())
         {
-            equalFunci = i;
-            return true;
+            ++slots.refcounts[it->second];
+            return it->second;
         }
     }
-    return false;
-}
-
-static void pushTheFunction(lua_State* L, int funcIndex, int tableIndex)
-{
-    tableIndex = lua_absindex(L, tableIndex);
-    funcIndex = lua_absindex(L, funcIndex);
-
-    size_t equalFunc;
-    if (hasEqualFunction(L, funcIndex, tableIndex, (size_t)lua_rawlen(L, tableIndex), equalFunc))
+    int slot;
+    if (!slots.freeSlots.empty())
     {
-        lua_pushinteger(L, (lua_Integer)equalFunc);
+        slot = slots.freeSlots.back();
+        slots.freeSlots.pop_back();
     }
     else
     {
-        lua_pushvalue(L, funcIndex);
+        slot = (int)slots.refcounts.size();
+        slots.refcounts.push_back(0);
+        slots.keys.push_back(nullptr);
     }
-}
+    slots.refcounts[slot] = 1;
+    slots.keys[slot] = key;
+    if (key)
+        slots.byFunction[key] = slot;
 
-int addLWinProc(lua_State* L, int index, const std::string& regName)
-{
-    int funcIndex = lua_absindex(L, index);
     getLProcTable(L, regName);
-    int luaTable = lua_absindex(L, -1);
-
-    pushTheFunction(L, funcIndex, luaTable);
-
-    int newIndex = (int)lua_rawlen(L, luaTable) + 1;
-    lua_seti(L, luaTable, newIndex);
+    lua_pushvalue(L, funcIndex);
+    lua_rawseti(L, -2, slot);
     lua_pop(L, 1);
-    return newIndex;
+    return slot;
 }
 
+// Pushes whatever was stored in the slot: functions for callbacks, tables for
+// the user data kept next to them.
 bool getLWinProci(lua_State* L, lua_Integer i, const std::string& regName)
 {
     getLProcTable(L, regName);
     int tableIndex = lua_absindex(L, -1);
 
-    lua_geti(L, tableIndex, i);
-    if (!lua_isfunction(L, -1) && !lua_isinteger(L, -1))
+    if (lua_rawgeti(L, tableIndex, i) == LUA_TNIL)
     {
-        lua_pop(L, 1);
+        lua_pop(L, 2);
         return false;
     }
 
-    if (lua_isinteger(L, -1))
-    {
-        lua_Integer newi = lua_tointeger(L, -1);
-        lua_pop(L, 1);
-        return getLWinProci(L, newi, regName);
-    }
-
     lua_remove(L, tableIndex);
     return true;
 }
 
 bool removeLWinProc(lua_State* L, lua_Integer i, const std::string& regName)
 {
-    getLProcTable(L, regName);
-    int tableIndex = lua_absindex(L, -1);
-
-    size_t len = lua_rawlen(L, tableIndex);
-    if (i < 1 || i >(lua_Integer)len)
-    {
-        lua_pop(L, 1);
+    ProcSlots& slots = getProcSlots(L, regName);
+    if (i < 1 || i >= (lua_Integer)slots.refcounts.size() || slots.refcounts[(size_t)i] == 0)
         return false;
-    }
+    int slot = (int)i;
+    if (--slots.refcounts[slot] > 0)
+        return true;
 
-    lua_pushnil(L);
-    lua_seti(L, tableIndex, i);
+    if (slots.keys[slot])
+        slots.byFunction.erase(slots.keys[slot]);
+    slots.keys[slot] = nullptr;
+    slots.freeSlots.push_back(slot);
 
+    getLProcTable(L, regName);
+    lua_pushnil(L);
+    lua_rawseti(L, -2, slot);
     lua_pop(L, 1);
     return true;
-}
+}
\ No newline at end of file
@@ -0,0 +1,216 @@
+#define PROFILERNAME "luibexwin.profiler"
+// Log-linear histogram: 8 sub-buckets per power of two of the tick count.
+constexpr int PROFILE_SUBBITS = 3;
+constexpr int PROFILE_BUCKETS = 64 << PROFILE_SUBBITS;
+struct ProfileSeries
+{
+    std::string name;
+    uint64_t count = 0;
+    uint64_t total = 0;
+    uint64_t minTicks = UINT64_MAX;
+    uint64_t maxTicks = 0;
+    std::vector<uint32_t> histogram = std::vector<uint32_t>(PROFILE_BUCKETS);
+};
+struct ProfileNameHash
+{
+    using is_transparent = void;
+    size_t operator()(std::string_view s) const { return std::hash<std::string_view>{}(s); }
+};
+struct Profiler
+{
+    std::vector<ProfileSeries> series;
+    std::unordered_map<std::string, int, ProfileNameHash, std::equal_to<>> ids;
+    std::vector<std::pair<int, uint64_t>> open;
+};
+static uint64_t qpcTicks()
+{
+    LARGE_INTEGER counter;
+    QueryPerformanceCounter(&counter);
+    return (uint64_t)counter.QuadPart;
+}
+static uint64_t qpcFrequency()
+{
+    static const uint64_t freq = [] { LARGE_INTEGER f; QueryPerformanceFrequency(&f); return (uint64_t)f.QuadPart; }();
+    return freq;
+}
+static int profileBucket(uint64_t ticks)
+{
+    if (ticks < (1ull << PROFILE_SUBBITS))
+        return (int)ticks;
+    int msb = 63 - std::countl_zero(ticks);
+    int sub = (int)((ticks >> (msb - PROFILE_SUBBITS)) & ((1 << PROFILE_SUBBITS) - 1));
+    return ((msb - PROFILE_SUBBITS + 1) << PROFILE_SUBBITS) + sub;
+}
+static uint64_t profileBucketLow(int bucket)
+{
+    if (bucket < (1 << PROFILE_SUBBITS))
+        return (uint64_t)bucket;
+    int msb = (bucket >> PROFILE_SUBBITS) + PROFILE_SUBBITS - 1;
+    uint64_t sub = (uint64_t)(bucket & ((1 << PROFILE_SUBBITS) - 1));
+    return (1ull << msb) | (sub << (msb - PROFILE_SUBBITS));
+}
+static void recordSample(ProfileSeries& ps, uint64_t ticks)
+{
+    ++ps.count;
+    ps.total += ticks;
+    if (ticks < ps.minTicks) ps.minTicks = ticks;
+    if (ticks > ps.maxTicks) ps.maxTicks = ticks;
+    ++ps.histogram[profileBucket(ticks)];
+}
+static uint64_t percentileTicks(const ProfileSeries& ps, double p)
+{
+    uint64_t rank = (uint64_t)(p * (double)ps.count);
+    if (rank >= ps.count)
+        rank = ps.count - 1;
+    uint64_t seen = 0;
+    for (int b = 0; b < PROFILE_BUCKETS; ++b)
+    {
+        seen += ps.histogram[b];
+        if (seen > rank)
+        {
+            uint64_t v = profileBucketLow(b);
+            return v < ps.minTicks ? ps.minTicks : (v > ps.maxTicks ? ps.maxTicks : v);
+        }
+    }
+    return ps.maxTicks;
+}
+static Profiler* getProfiler(lua_State* L)
+{
+    return getRegistryObject<Profiler>(L, PROFILERNAME);
+}
+static int internLabel(Profiler* p, std::string_view name)
+{
+    auto it = p->ids.find(name);
+    if (it != p->ids.end())
+        return it->second;
+    int id = (int)p->series.size() + 1;
+    p->series.emplace_back().name = name;
+    p->ids.emplace(std::string(name), id);
+    return id;
+}
+// Labels are interned ids or names, looking a name up does not allocate.
+// Only intern creates a series for a new name, a lookup that misses raises
+// like an unknown id.
+static int checkLabel(lua_State* L, Profiler* p, int idx, bool intern)
+{
+    if (lua_type(L, idx) == LUA_TSTRING)
+    {
+        size_t len;
+        const char* name = lua_tolstring(L, idx, &len);
+        if (intern)
+            return internLabel(p, std::string_view(name, len));
+        auto it = p->ids.find(std::string_view(name, len));
+        luaL_argcheck(L, it != p->ids.end(), idx, "unknown profile label");
+        return it->second;
+    }
+    lua_Integer id = luaL_checkinteger(L, idx);
+    luaL_argcheck(L, id >= 1 && id <= (lua_Integer)p->series.size(), idx, "unknown profile label");
+    return (int)id;
+}
+static double ticksToMicros(uint64_t ticks)
+{
+    return (double)ticks * 1e6 / (double)qpcFrequency();
+}
+static void pushSeriesStats(lua_State* L, const ProfileSeries& ps)
+{
+    lua_newtable(L);
+    lua_pushinteger(L, (lua_Integer)ps.count);
+    lua_setfield(L, -2, "count");
+    if (ps.count == 0)
+        return;
+    lua_pushnumber(L, ticksToMicros(ps.minTicks));
+    lua_setfield(L, -2, "min");
+    lua_pushnumber(L, ticksToMicros(ps.maxTicks));
+    lua_setfield(L, -2, "max");
+    lua_pushnumber(L, ticksToMicros(ps.total) / (double)ps.count);
+    lua_setfield(L, -2, "mean");
+    lua_pushnumber(L, ticksToMicros(ps.total));
+    lua_setfield(L, -2, "total");
+    lua_pushnumber(L, ticksToMicros(percentileTicks(ps, 0.50)));
+    lua_setfield(L, -2, "p50");
+    lua_pushnumber(L, ticksToMicros(percentileTicks(ps, 0.90)));
+    lua_setfield(L, -2, "p90");
+    lua_pushnumber(L, ticksToMicros(percentileTicks(ps, 0.99)));
+    lua_setfield(L, -2, "p99");
+}
+Lua_Function(QueryPerformanceCounter)
+{
+    lua_pushinteger(L, (lua_Integer)qpcTicks());
+    return 1;
+}
+Lua_Function(QueryPerformanceFrequency)
+{
+    lua_pushinteger(L, (lua_Integer)qpcFrequency());
+    return 1;
+}
+Lua_Function(ProfileLabel)
+{
+    size_t len;
+    const char* name = luaL_checklstring(L, 1, &len);
+    lua_pushinteger(L, internLabel(getProfiler(L), std::string_view(name, len)));
+    return 1;
+}
+Lua_Function(ProfileBegin)
+{
+    Profiler* p = getProfiler(L);
+    int id = checkLabel(L, p, 1, true);
+    p->open.emplace_back(id, qpcTicks());
+    return 0;
+}
+Lua_Function(ProfileEnd)
+{
+    uint64_t now = qpcTicks();
+    Profiler* p = getProfiler(L);
+    int id = checkLabel(L, p, 1, false);
+    if (p->open.empty() || p->open.back().first != id)
+        return luaL_error(L, "ProfileEnd: '%s' is not the innermost open scope", p->series[id - 1].name.c_str());
+    uint64_t ticks = now - p->open.back().second;
+    p->open.pop_back();
+    recordSample(p->series[id - 1], ticks);
+    lua_pushinteger(L, (lua_Integer)ticks);
+    return 1;
+}
+Lua_Function(ProfileRecord)
+{
+    Profiler* p = getProfiler(L);
+    int id = checkLabel(L, p, 1, true);
+    lua_Integer ticks = luaL_checkinteger(L, 2);
+    recordSample(p->series[id - 1], ticks < 0 ? 0 : (uint64_t)ticks);
+    return 0;
+}
+Lua_Function(ProfileStats)
+{
+    Profiler* p = getProfiler(L);
+    if (!lua_isnoneornil(L, 1))
+    {
+        pushSeriesStats(L, p->series[checkLabel(L, p, 1, false) - 1]);
+        return 1;
+    }
+    lua_createtable(L, 0, (int)p->series.size());
+    for (const ProfileSeries& ps : p->series)
+    {
+        pushSeriesStats(L, ps);
+        lua_setfield(L, -2, ps.name.c_str());
+    }
+    return 1;
+}
+Lua_Function(ProfileReset)
+{
+    Profiler* p = getProfiler(L);
+    if (!lua_isnoneornil(L, 1))
+    {
+        ProfileSeries& ps = p->series[checkLabel(L, p, 1, false) - 1];
+        std::string name = std::move(ps.name);
+        ps = ProfileSeries();
+        ps.name = std::move(name);
+        return 0;
+    }
+    for (ProfileSeries& ps : p->series)
+    {
+        std::string name = std::move(ps.name);
+        ps = ProfileSeries();
+        ps.name = std::move(name);
+    }
+    p->open.clear();
+    return 0;
+}
@@ -0,0 +1,717 @@
+#if defined(_M_X64) || defined(_M_IX86)
+#define RASTER_X86 1
+// MSVC emits any intrinsic without /arch.
+#define RASTER_TARGET(isa)
+#elif defined(__x86_64__) || defined(__i386__)
+#define RASTER_X86 1
+// GCC and Clang only emit intrinsics of an instruction set enabled for the
+// function.
+#define RASTER_TARGET(isa) __attribute__((target(isa)))
+#endif
+
+// x * a / 255 rounded, exact for all 8 bit inputs.
+static inline uint32_t mulDiv255(uint32_t x, uint32_t a)
+{
+    uint32_t t = x * a + 128;
+    return (t + (t >> 8)) >> 8;
+}
+static inline uint32_t premultiply(uint32_t c)
+{
+    uint32_t a = c >> 24;
+    return (a << 24) | (mulDiv255((c >> 16) & 0xFF, a) << 16) | (mulDiv255((c >> 8) & 0xFF, a) << 8) | mulDiv255(c & 0xFF, a);
+}
+// s + d * (255 - sa) / 255 on all four channels, two at a time. A channel
+// of s above its alpha wraps within its byte, as the SIMD adds do.
+static inline uint32_t overPixel(uint32_t s, uint32_t d)
+{
+    uint32_t ia = 255 - (s >> 24);
+    uint32_t rb = (d & 0x00FF00FF) * ia + 0x00800080;
+    rb = ((rb + ((rb >> 8) & 0x00FF00FF)) >> 8) & 0x00FF00FF;
+    uint32_t ag = ((d >> 8) & 0x00FF00FF) * ia + 0x00800080;
+    ag = (ag + ((ag >> 8) & 0x00FF00FF)) & 0xFF00FF00;
+    return (((s & 0x00FF00FF) + rb) & 0x00FF00FF) | (((s & 0xFF00FF00) + ag) & 0xFF00FF00);
+}
+static inline uint32_t lerp7(uint32_t a, uint32_t b, uint32_t w)
+{
+    return (a * (128 - w) + b * w + 64) >> 7;
+}
+static inline uint32_t bilinearPixel(uint32_t p00, uint32_t p01, uint32_t p10, uint32_t p11, uint32_t fx, uint32_t fy)
+{
+    uint32_t out = 0;
+    for (int shift = 0; shift < 32; shift += 8)
+    {
+        uint32_t left = lerp7((p00 >> shift) & 0xFF, (p10 >> shift) & 0xFF, fy);
+        uint32_t right = lerp7((p01 >> shift) & 0xFF, (p11 >> shift) & 0xFF, fy);
+        out |= lerp7(left, right, fx) << shift;
+    }
+    return out;
+}
+
+static void scalarFill(uint32_t* dst, int count, uint32_t color)
+{
+    std::fill_n(dst, count, color);
+}
+static void scalarBlend(uint32_t* dst, int count, uint32_t color)
+{
+    uint32_t s = premultiply(color);
+    for (int i = 0; i < count; ++i)
+        dst[i] = overPixel(s, dst[i]);
+}
+static void scalarOver(uint32_t* dst, const uint32_t* src, int count)
+{
+    for (int i = 0; i < count; ++i)
+        dst[i] = overPixel(src[i], dst[i]);
+}
+static void scalarColorKey(uint32_t* dst, const uint32_t* src, int count, uint32_t key)
+{
+    key &= 0x00FFFFFF;
+    for (int i = 0; i < count; ++i)
+        if ((src[i] & 0x00FFFFFF) != key)
+            dst[i] = src[i];
+}
+static void scalarSwizzle(uint32_t* dst, const uint32_t* src, int count)
+{
+    for (int i = 0; i < count; ++i)
+    {
+        uint32_t c = src[i];
+        dst[i] = (c & 0xFF00FF00) | ((c >> 16) & 0xFF) | ((c & 0xFF) << 16);
+    }
+}
+static void scalarBilinear(uint32_t* dst, const uint32_t* row0, const uint32_t* row1, const int64_t* xs, int count, int fy, int maxX)
+{
+    for (int i = 0; i < count; ++i)
+    {
+        int x0 = (int)(xs[i] >> 16);
+        int x1 = x0 < maxX ? x0 + 1 : maxX;
+        dst[i] = bilinearPixel(row0[x0], row0[x1], row1[x0], row1[x1], (int)(xs[i] >> 9) & 127, fy);
+    }
+}
+static bool scalarEqual(const uint32_t* a, const uint32_t* b, int count)
+{
+    return memcmp(a, b, (size_t)count * sizeof(uint32_t)) == 0;
+}
+static inline bool nearPixel(uint32_t a, uint32_t b, uint32_t tol)
+{
+    for (int shift = 0; shift < 32; shift += 8)
+    {
+        int d = (int)((a >> shift) & 0xFF) - (int)((b >> shift) & 0xFF);
+        if ((uint32_t)std::abs(d) > ((tol >> shift) & 0xFF))
+            return false;
+    }
+    return true;
+}
+static int scalarFindColor(const uint32_t* row, int count, uint32_t color, uint32_t tol)
+{
+    for (int i = 0; i < count; ++i)
+        if (nearPixel(row[i], color, tol))
+            return i;
+    return -1;
+}
+static bool scalarNear(const uint32_t* a, const uint32_t* b, int count, uint32_t tol)
+{
+    for (int i = 0; i < count; ++i)
+        if (!nearPixel(a[i], b[i], tol))
+            return false;
+    return true;
+}
+static void scalarPremultiply(uint32_t* dst, const uint32_t* src, int count)
+{
+    for (int i = 0; i < count; ++i)
+        dst[i] = premultiply(src[i]);
+}
+
+#ifdef RASTER_X86
+RASTER_TARGET("sse2") static inline __m128i overSSE2(__m128i s, __m128i d)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i bias = _mm_set1_epi16(128);
+    __m128i ia = _mm_sub_epi32(_mm_set1_epi32(255), _mm_srli_epi32(s, 24));
+    ia = _mm_or_si128(ia, _mm_slli_epi32(ia, 16));
+    __m128i lo = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(d, zero), _mm_unpacklo_epi32(ia, ia)), bias);
+    __m128i hi = _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(d, zero), _mm_unpackhi_epi32(ia, ia)), bias);
+    lo = _mm_srli_epi16(_mm_add_epi16(lo, _mm_srli_epi16(lo, 8)), 8);
+    hi = _mm_srli_epi16(_mm_add_epi16(hi, _mm_srli_epi16(hi, 8)), 8);
+    return _mm_add_epi8(s, _mm_packus_epi16(lo, hi));
+}
+RASTER_TARGET("sse2") static void sse2Fill(uint32_t* dst, int count, uint32_t color)
+{
+    __m128i c = _mm_set1_epi32((int)color);
+    int i = 0;
+    for (; i + 4 <= count; i += 4)
+        _mm_storeu_si128((__m128i*)(dst + i), c);
+    scalarFill(dst + i, count - i, color);
+}
+RASTER_TARGET("sse2") static void sse2Blend(uint32_t* dst, int count, uint32_t color)
+{
+    __m128i s = _mm_set1_epi32((int)premultiply(color));
+    int i = 0;
+    for (; i + 4 <= count; i += 4)
+        _mm_storeu_si128((__m128i*)(dst + i), overSSE2(s, _mm_loadu_si128((const __m128i*)(dst + i))));
+    scalarBlend(dst + i, count - i, color);
+}
+RASTER_TARGET("sse2") static void sse2Over(uint32_t* dst, const uint32_t* src, int count)
+{
+    int i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128i s = _mm_loadu_si128((const __m128i*)(src + i));
+        __m128i d = _mm_loadu_si128((const __m128i*)(dst + i));
+        _mm_storeu_si128((__m128i*)(dst + i), overSSE2(s, d));
+    }
+    scalarOver(dst + i, src + i, count - i);
+}
+RASTER_TARGET("sse2") static void sse2ColorKey(uint32_t* dst, const uint32_t* src, int count, uint32_t key)
+{
+    const __m128i rgb = _mm_set1_epi32(0x00FFFFFF);
+    const __m128i k = _mm_set1_epi32((int)(key & 0x00FFFFFF));
+    int i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128i s = _mm_loadu_si128((const __m128i*)(src + i));
+        __m128i d = _mm_loadu_si128((const __m128i*)(dst + i));
+        __m128i m = _mm_cmpeq_epi32(_mm_and_si128(s, rgb), k);
+        _mm_storeu_si128((__m128i*)(dst + i), _mm_or_si128(_mm_and_si128(m, d), _mm_andnot_si128(m, s)));
+    }
+    scalarColorKey(dst + i, src + i, count - i, key);
+}
+RASTER_TARGET("sse2") static void sse2Swizzle(uint32_t* dst, const uint32_t* src, int count)
+{
+    const __m128i rbMask = _mm_set1_epi32(0x00FF00FF);
+    int i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128i s = _mm_loadu_si128((const __m128i*)(src + i));
+        __m128i rb = _mm_and_si128(s, rbMask);
+        rb = _mm_shufflehi_epi16(_mm_shufflelo_epi16(rb, _MM_SHUFFLE(2, 3, 0, 1)), _MM_SHUFFLE(2, 3, 0, 1));
+        _mm_storeu_si128((__m128i*)(dst + i), _mm_or_si128(_mm_andnot_si128(rbMask, s), rb));
+    }
+    scalarSwizzle(dst + i, src + i, count - i);
+}
+// One pixel per step: both taps of both rows fit in one register as 16 bit lanes.
+RASTER_TARGET("sse2") static void sse2Bilinear(uint32_t* dst, const uint32_t* row0, const uint32_t* row1, const int64_t* xs, int count, int fy, int maxX)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i round = _mm_set1_epi16(64);
+    const __m128i wy0 = _mm_set1_epi16((short)(128 - fy));
+    const __m128i wy1 = _mm_set1_epi16((short)fy);
+    for (int i = 0; i < count; ++i)
+    {
+        int x0 = (int)(xs[i] >> 16);
+        int x1 = x0 < maxX ? x0 + 1 : maxX;
+        int fx = (int)(xs[i] >> 9) & 127;
+        __m128i top = _mm_unpacklo_epi8(_mm_unpacklo_epi32(_mm_cvtsi32_si128((int)row0[x0]), _mm_cvtsi32_si128((int)row0[x1])), zero);
+        __m128i bottom = _mm_unpacklo_epi8(_mm_unpacklo_epi32(_mm_cvtsi32_si128((int)row1[x0]), _mm_cvtsi32_si128((int)row1[x1])), zero);
+        __m128i v = _mm_add_epi16(_mm_mullo_epi16(top, wy0), _mm_mullo_epi16(bottom, wy1));
+        v = _mm_srli_epi16(_mm_add_epi16(v, round), 7);
+        __m128i wx = _mm_unpacklo_epi64(_mm_set1_epi16((short)(128 - fx)), _mm_set1_epi16((short)fx));
+        __m128i h = _mm_mullo_epi16(v, wx);
+        h = _mm_add_epi16(h, _mm_srli_si128(h, 8));
+        h = _mm_srli_epi16(_mm_add_epi16(h, round), 7);
+        dst[i] = (uint32_t)_mm_cvtsi128_si32(_mm_packus_epi16(h, zero));
+    }
+}
+RASTER_TARGET("sse2") static bool sse2Equal(const uint32_t* a, const uint32_t* b, int count)
+{
+    int i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128i eq = _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i*)(a + i)), _mm_loadu_si128((const __m128i*)(b + i)));
+        if (_mm_movemask_epi8(eq) != 0xFFFF)
+            return false;
+    }
+    return scalarEqual(a + i, b + i, count - i);
+}
+// Saturating differences both ways give |a - b| per byte, anything left after
+// subtracting the tolerance is out of range.
+RASTER_TARGET("sse2") static inline __m128i outOfToleranceSSE2(__m128i a, __m128i b, __m128i tol)
+{
+    __m128i d = _mm_or_si128(_mm_subs_epu8(a, b), _mm_subs_epu8(b, a));
+    return _mm_subs_epu8(d, tol);
+}
+RASTER_TARGET("sse2") static int sse2FindColor(const uint32_t* row, int count, uint32_t color, uint32_t tol)
+{
+    const __m128i c = _mm_set1_epi32((int)color);
+    const __m128i t = _mm_set1_epi32((int)tol);
+    const __m128i zero = _mm_setzero_si128();
+    int i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128i over = outOfToleranceSSE2(_mm_loadu_si128((const __m128i*)(row + i)), c, t);
+        int hits = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(over, zero)));
+        if (hits)
+            return i + std::countr_zero((unsigned)hits);
+    }
+    int rest = scalarFindColor(row + i, count - i, color, tol);
+    return rest < 0 ? -1 : i + rest;
+}
+RASTER_TARGET("sse2") static bool sse2Near(const uint32_t* a, const uint32_t* b, int count, uint32_t tol)
+{
+    const __m128i t = _mm_set1_epi32((int)tol);
+    const __m128i zero = _mm_setzero_si128();
+    int i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128i over = outOfToleranceSSE2(_mm_loadu_si128((const __m128i*)(a + i)), _mm_loadu_si128((const __m128i*)(b + i)), t);
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(over, zero)) != 0xFFFF)
+            return false;
+    }
+    return scalarNear(a + i, b + i, count - i, tol);
+}
+RASTER_TARGET("sse2") static void sse2Premultiply(uint32_t* dst, const uint32_t* src, int count)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i bias = _mm_set1_epi16(128);
+    const __m128i alphaMask = _mm_set1_epi32((int)0xFF000000);
+    int i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128i s = _mm_loadu_si128((const __m128i*)(src + i));
+        __m128i lo = _mm_unpacklo_epi8(s, zero);
+        __m128i hi = _mm_unpackhi_epi8(s, zero);
+        __m128i alo = _mm_shufflehi_epi16(_mm_shufflelo_epi16(lo, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+        __m128i ahi = _mm_shufflehi_epi16(_mm_shufflelo_epi16(hi, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+        lo = _mm_add_epi16(_mm_mullo_epi16(lo, alo), bias);
+        hi = _mm_add_epi16(_mm_mullo_epi16(hi, ahi), bias);
+        lo = _mm_srli_epi16(_mm_add_epi16(lo, _mm_srli_epi16(lo, 8)), 8);
+        hi = _mm_srli_epi16(_mm_add_epi16(hi, _mm_srli_epi16(hi, 8)), 8);
+        __m128i rgb = _mm_andnot_si128(alphaMask, _mm_packus_epi16(lo, hi));
+        _mm_storeu_si128((__m128i*)(dst + i), _mm_or_si128(rgb, _mm_and_si128(s, alphaMask)));
+    }
+    scalarPremultiply(dst + i, src + i, count - i);
+}
+
+// These only run after the CPU check.
+RASTER_TARGET("avx2") static inline __m256i overAVX2(__m256i s, __m256i d)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i bias = _mm256_set1_epi16(128);
+    __m256i ia = _mm256_sub_epi32(_mm256_set1_epi32(255), _mm256_srli_epi32(s, 24));
+    ia = _mm256_or_si256(ia, _mm256_slli_epi32(ia, 16));
+    __m256i lo = _mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpacklo_epi8(d, zero), _mm256_unpacklo_epi32(ia, ia)), bias);
+    __m256i hi = _mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpackhi_epi8(d, zero), _mm256_unpackhi_epi32(ia, ia)), bias);
+    lo = _mm256_srli_epi16(_mm256_add_epi16(lo, _mm256_srli_epi16(lo, 8)), 8);
+    hi = _mm256_srli_epi16(_mm256_add_epi16(hi, _mm256_srli_epi16(hi, 8)), 8);
+    return _mm256_add_epi8(s, _mm256_packus_epi16(lo, hi));
+}
+RASTER_TARGET("avx2") static void avx2Fill(uint32_t* dst, int count, uint32_t color)
+{
+    __m256i c = _mm256_set1_epi32((int)color);
+    int i = 0;
+    for (; i + 8 <= count; i += 8)
+        _mm256_storeu_si256((__m256i*)(dst + i), c);
+    sse2Fill(dst + i, count - i, color);
+}
+RASTER_TARGET("avx2") static void avx2Blend(uint32_t* dst, int count, uint32_t color)
+{
+    __m256i s = _mm256_set1_epi32((int)premultiply(color));
+    int i = 0;
+    for (; i + 8 <= count; i += 8)
+        _mm256_storeu_si256((__m256i*)(dst + i), overAVX2(s, _mm256_loadu_si256((const __m256i*)(dst + i))));
+    sse2Blend(dst + i, count - i, color);
+}
+RASTER_TARGET("avx2") static void avx2Over(uint32_t* dst, const uint32_t* src, int count)
+{
+    int i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        __m256i s = _mm256_loadu_si256((const __m256i*)(src + i));
+        __m256i d = _mm256_loadu_si256((const __m256i*)(dst + i));
+        _mm256_storeu_si256((__m256i*)(dst + i), overAVX2(s, d));
+    }
+    sse2Over(dst + i, src + i, count - i);
+}
+RASTER_TARGET("avx2") static void avx2ColorKey(uint32_t* dst, const uint32_t* src, int count, uint32_t key)
+{
+    const __m256i rgb = _mm256_set1_epi32(0x00FFFFFF);
+    const __m256i k = _mm256_set1_epi32((int)(key & 0x00FFFFFF));
+    int i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        __m256i s = _mm256_loadu_si256((const __m256i*)(src + i));
+        __m256i d = _mm256_loadu_si256((const __m256i*)(dst + i));
+        __m256i m = _mm256_cmpeq_epi32(_mm256_and_si256(s, rgb), k);
+        _mm256_storeu_si256((__m256i*)(dst + i), _mm256_blendv_epi8(s, d, m));
+    }
+    sse2ColorKey(dst + i, src + i, count - i, key);
+}
+RASTER_TARGET("avx2") static void avx2Swizzle(uint32_t* dst, const uint32_t* src, int count)
+{
+    const __m256i order = _mm256_setr_epi8(2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15,
+        2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15);
+    int i = 0;
+    for (; i + 8 <= count; i += 8)
+        _mm256_storeu_si256((__m256i*)(dst + i), _mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i*)(src + i)), order));
+    sse2Swizzle(dst + i, src + i, count - i);
+}
+RASTER_TARGET("avx2") static bool avx2Equal(const uint32_t* a, const uint32_t* b, int count)
+{
+    int i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        __m256i x = _mm256_xor_si256(_mm256_loadu_si256((const __m256i*)(a + i)), _mm256_loadu_si256((const __m256i*)(b + i)));
+        if (!_mm256_testz_si256(x, x))
+            return false;
+    }
+    return sse2Equal(a + i, b + i, count - i);
+}
+RASTER_TARGET("avx2") static inline __m256i outOfToleranceAVX2(__m256i a, __m256i b, __m256i tol)
+{
+    __m256i d = _mm256_or_si256(_mm256_subs_epu8(a, b), _mm256_subs_epu8(b, a));
+    return _mm256_subs_epu8(d, tol);
+}
+RASTER_TARGET("avx2") static int avx2FindColor(const uint32_t* row, int count, uint32_t color, uint32_t tol)
+{
+    const __m256i c = _mm256_set1_epi32((int)color);
+    const __m256i t = _mm256_set1_epi32((int)tol);
+    const __m256i zero = _mm256_setzero_si256();
+    int i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        __m256i over = outOfToleranceAVX2(_mm256_loadu_si256((const __m256i*)(row + i)), c, t);
+        int hits = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(over, zero)));
+        if (hits)
+            return i + std::countr_zero((unsigned)hits);
+    }
+    int rest = sse2FindColor(row + i, count - i, color, tol);
+    return rest < 0 ? -1 : i + rest;
+}
+RASTER_TARGET("avx2") static bool avx2Near(const uint32_t* a, const uint32_t* b, int count, uint32_t tol)
+{
+    const __m256i t = _mm256_set1_epi32((int)tol);
+    int i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        __m256i over = outOfToleranceAVX2(_mm256_loadu_si256((const __m256i*)(a + i)), _mm256_loadu_si256((const __m256i*)(b + i)), t);
+        if (!_mm256_testz_si256(over, over))
+            return false;
+    }
+    return sse2Near(a + i, b + i, count - i, tol);
+}
+
+#ifdef _MSC_VER
+static int detectRasterLevel()
+{
+    int info[4];
+    __cpuid(info, 0);
+    int maxLeaf = info[0];
+    __cpuid(info, 1);
+    bool sse2 = (info[3] & (1 << 26)) != 0;
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    bool avx = (info[2] & (1 << 28)) != 0;
+    if (maxLeaf >= 7 && osxsave && avx && (_xgetbv(0) & 6) == 6)
+    {
+        __cpuidex(info, 7, 0);
+        if (info[1] & (1 << 5))
+            return RASTER_AVX2;
+    }
+    return sse2 ? RASTER_SSE2 : RASTER_SCALAR;
+}
+#else
+// Checks the OS saves the AVX state as well.
+static int detectRasterLevel()
+{
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+        return RASTER_AVX2;
+    return __builtin_cpu_supports("sse2") ? RASTER_SSE2 : RASTER_SCALAR;
+}
+#endif
+#else
+static int detectRasterLevel()
+{
+    return RASTER_SCALAR;
+}
+#endif
+
+static const RasterKernels rasterTables[RASTER_LEVELS] = {
+    { "scalar", scalarFill, scalarBlend, scalarOver, scalarColorKey, scalarSwizzle, scalarBilinear, scalarEqual, scalarFindColor, scalarNear, scalarPremultiply },
+#ifdef RASTER_X86
+    { "sse2", sse2Fill, sse2Blend, sse2Over, sse2ColorKey, sse2Swizzle, sse2Bilinear, sse2Equal, sse2FindColor, sse2Near, sse2Premultiply },
+    { "avx2", avx2Fill, avx2Blend, avx2Over, avx2ColorKey, avx2Swizzle, sse2Bilinear, avx2Equal, avx2FindColor, avx2Near, sse2Premultiply },
+#else
+    { "sse2", scalarFill, scalarBlend, scalarOver, scalarColorKey, scalarSwizzle, scalarBilinear, scalarEqual, scalarFindColor, scalarNear, scalarPremultiply },
+    { "avx2", scalarFill, scalarBlend, scalarOver, scalarColorKey, scalarSwizzle, scalarBilinear, scalarEqual, scalarFindColor, scalarNear, scalarPremultiply },
+#endif
+};
+static std::atomic<int> rasterLevel{ -1 };
+
+RasterLevel rasterSupportedLevel()
+{
+    static const RasterLevel supported = (RasterLevel)detectRasterLevel();
+    return supported;
+}
+RasterLevel rasterActiveLevel()
+{
+    int level = rasterLevel.load(std::memory_order_relaxed);
+    return level < 0 ? rasterSupportedLevel() : (RasterLevel)level;
+}
+void rasterSetLevel(RasterLevel level)
+{
+    rasterLevel.store(std::min(level, rasterSupportedLevel()), std::memory_order_relaxed);
+}
+const RasterKernels& rasterKernels()
+{
+    return rasterTables[rasterActiveLevel()];
+}
+
+void pixelBlendRect(const PixelView& dst, PixelRect r, uint32_t color)
+{
+    if ((color >> 24) == 0xFF)
+        return pixelFillRect(dst, r, color);
+    if ((color >> 24) == 0 || !pixelClipRect(dst, r))
+        return;
+    auto blend = rasterKernels().blend;
+    for (int y = r.y; y < r.y + r.h; ++y)
+        blend(dst.row(y) + r.x, r.w, color);
+}
+void pixelCompositeRect(const PixelView& dst, int dx, int dy, const PixelView& src, PixelRect sr)
+{
+    if (!pixelClipCopy(dst, dx, dy, src, sr))
+        return;
+    auto over = rasterKernels().over;
+    for (int y = 0; y < sr.h; ++y)
+        over(dst.row(dy + y) + dx, src.row(sr.y + y) + sr.x, sr.w);
+}
+void pixelColorKeyRect(const PixelView& dst, int dx, int dy, const PixelView& src, PixelRect sr, uint32_t key)
+{
+    if (!pixelClipCopy(dst, dx, dy, src, sr))
+        return;
+    auto colorKey = rasterKernels().colorKey;
+    for (int y = 0; y < sr.h; ++y)
+        colorKey(dst.row(dy + y) + dx, src.row(sr.y + y) + sr.x, sr.w, key);
+}
+void pixelSwizzleRect(const PixelView& dst, PixelRect r)
+{
+    if (!pixelClipRect(dst, r))
+        return;
+    auto swizzle = rasterKernels().swizzle;
+    for (int y = r.y; y < r.y + r.h; ++y)
+        swizzle(dst.row(y) + r.x, dst.row(y) + r.x, r.w);
+}
+void pixelPremultiplyRect(const PixelView& dst, PixelRect r)
+{
+    if (!pixelClipRect(dst, r))
+        return;
+    auto premultiply = rasterKernels().premultiply;
+    for (int y = r.y; y < r.y + r.h; ++y)
+        premultiply(dst.row(y) + r.x, dst.row(y) + r.x, r.w);
+}
+// Samples at destination pixel centres, dr may lie partly outside dst.
+void pixelScaleRect(const PixelView& dst, PixelRect dr, const PixelView& src, PixelRect sr, bool bilinear)
+{
+    if (dr.w <= 0 || dr.h <= 0 || !pixelClipRect(src, sr))
+        return;
+    PixelRect clip = dr;
+    if (!pixelClipRect(dst, clip))
+        return;
+    int64_t stepX = ((int64_t)sr.w << 16) / dr.w;
+    int64_t stepY = ((int64_t)sr.h << 16) / dr.h;
+    int64_t bias = bilinear ? 0x8000 : 0;
+    // 16.16 positions in 64 bits, sources may be wider than 32767 pixels.
+    auto sample = [&](int64_t step, int64_t i, int extent) {
+        int64_t pos = step * i + step / 2 - bias;
+        return std::clamp<int64_t>(pos, 0, ((int64_t)extent << 16) - (bilinear ? 0x10000 : 1));
+    };
+    std::vector<int64_t> xs(clip.w);
+    for (int i = 0; i < clip.w; ++i)
+        xs[i] = sample(stepX, (int64_t)clip.x - dr.x + i, sr.w) + ((int64_t)sr.x << 16);
+    if (!bilinear)
+    {
+        for (int y = 0; y < clip.h; ++y)
+        {
+            const uint32_t* in = src.row(sr.y + (int)(sample(stepY, (int64_t)clip.y - dr.y + y, sr.h) >> 16));
+            uint32_t* out = dst.row(clip.y + y) + clip.x;
+            for (int i = 0; i < clip.w; ++i)
+                out[i] = in[xs[i] >> 16];
+        }
+        return;
+    }
+    auto kernel = rasterKernels().bilinear;
+    int maxX = sr.x + sr.w - 1;
+    for (int y = 0; y < clip.h; ++y)
+    {
+        int64_t sy = sample(stepY, (int64_t)clip.y - dr.y + y, sr.h);
+        int y0 = (int)(sy >> 16);
+        int y1 = y0 + 1 < sr.h ? y0 + 1 : y0;
+        kernel(dst.row(clip.y + y) + clip.x, src.row(sr.y + y0), src.row(sr.y + y1), xs.data(), clip.w, (int)(sy >> 9) & 127, maxX);
+    }
+}
+// Nearest integer to num / den, den != 0.
+static int64_t divRound(int64_t num, int64_t den)
+{
+    if (den < 0)
+    {
+        num = -num;
+        den = -den;
+    }
+    return num >= 0 ? (num + den / 2) / den : -((den / 2 - num) / den);
+}
+// Cohen-Sutherland against the pixel centers of the view. Intersections are
+// taken on the original segment so rounding does not accumulate, endpoints
+// inside the view are kept as they are.
+static bool clipLine(const PixelView& v, int64_t& x0, int64_t& y0, int64_t& x1, int64_t& y1)
+{
+    if ((x0 < 0 && x1 < 0) || (y0 < 0 && y1 < 0) || (x0 >= v.width && x1 >= v.width) || (y0 >= v.height && y1 >= v.height))
+        return false;
+    // Far endpoints are first pulled in along the line in double precision,
+    // the exact pass below needs products of coordinates to fit in 64 bits.
+    auto far = [](int64_t c) { return c < -PIXEL_COORD_LIMIT || c > PIXEL_COORD_LIMIT; };
+    if (far(x0) || far(y0) || far(x1) || far(y1))
+    {
+        const double bound = PIXEL_COORD_LIMIT / 2;
+        double fx = (double)x0, fy = (double)y0;
+        double dx = (double)x1 - fx, dy = (double)y1 - fy;
+        double t0 = 0, t1 = 1;
+        auto edge = [&](double p, double q) {
+            if (p == 0)
+                return q >= 0;
+            if (p < 0)
+                t0 = std::max(t0, q / p);
+            else
+                t1 = std::min(t1, q / p);
+            return t0 <= t1;
+        };
+        if (!edge(-dx, fx + bound) || !edge(dx, bound - fx) || !edge(-dy, fy + bound) || !edge(dy, bound - fy))
+            return false;
+        x0 = std::llround(fx + t0 * dx);
+        y0 = std::llround(fy + t0 * dy);
+        x1 = std::llround(fx + t1 * dx);
+        y1 = std::llround(fy + t1 * dy);
+    }
+    const int64_t ox = x0, oy = y0, dx = x1 - x0, dy = y1 - y0;
+    const int64_t right = v.width - 1, bottom = v.height - 1;
+    auto outcode = [&](int64_t x, int64_t y) { return (x < 0) | (x > right) << 1 | (y < 0) << 2 | (y > bottom) << 3; };
+    int c0 = outcode(x0, y0), c1 = outcode(x1, y1);
+    // Each endpoint meets at most two edges, a fifth round is a line that
+    // only grazes a corner once rounded.
+    for (int round = 0; c0 | c1; ++round)
+    {
+        if ((c0 & c1) || round == 4)
+            return false;
+        int c = c0 ? c0 : c1;
+        int64_t x, y;
+        if (c & 12)
+        {
+            y = c & 4 ? 0 : bottom;
+            x = ox + divRound(dx * (y - oy), dy);
+        }
+        else
+        {
+            x = c & 1 ? 0 : right;
+            y = oy + divRound(dy * (x - ox), dx);
+        }
+        if (c == c0)
+        {
+            x0 = x;
+            y0 = y;
+            c0 = outcode(x, y);
+        }
+        else
+        {
+            x1 = x;
+            y1 = y;
+            c1 = outcode(x, y);
+        }
+    }
+    return true;
+}
+// Bresenham over the clipped segment, translucent colors are blended per
+// pixel.
+void pixelDrawLine(const PixelView& dst, int64_t x0, int64_t y0, int64_t x1, int64_t y1, uint32_t color)
+{
+    uint32_t alpha = color >> 24;
+    if (alpha == 0 || !clipLine(dst, x0, y0, x1, y1))
+        return;
+    uint32_t s = premultiply(color);
+    int x = (int)x0, y = (int)y0;
+    int dx = std::abs((int)x1 - x), sx = x < x1 ? 1 : -1;
+    int dy = -std::abs((int)y1 - y), sy = y < y1 ? 1 : -1;
+    int err = dx + dy;
+    for (;;)
+    {
+        uint32_t* p = dst.row(y) + x;
+        *p = alpha == 0xFF ? color : overPixel(s, *p);
+        if (x == x1 && y == y1)
+            break;
+        int e2 = 2 * err;
+        if (e2 >= dy) { err += dy; x += sx; }
+        if (e2 <= dx) { err += dx; y += sy; }
+    }
+}
+int pixelDiffTiles(const PixelView& a, const PixelView& b, int tileSize, uint8_t* mask)
+{
+    auto equal = rasterKernels().equal;
+    int cols = (a.width + tileSize - 1) / tileSize;
+    int rows = (a.height + tileSize - 1) / tileSize;
+    int changed = 0;
+    for (int ty = 0; ty < rows; ++ty)
+    {
+        int y0 = ty * tileSize;
+        int y1 = std::min(y0 + tileSize, a.height);
+        for (int tx = 0; tx < cols; ++tx)
+        {
+            int x = tx * tileSize;
+            int w = std::min(tileSize, a.width - x);
+            bool same = true;
+            for (int y = y0; y < y1 && same; ++y)
+                same = equal(a.row(y) + x, b.row(y) + x, w);
+            mask[ty * cols + tx] = !same;
+            changed += !same;
+        }
+    }
+    return changed;
+}
+
+const char* rasterLevelName(RasterLevel level)
+{
+    return rasterTables[level].name;
+}
+std::vector<RasterTiming> rasterBenchmark(int width, int height, int iterations)
+{
+    std::vector<uint32_t> a((size_t)width * height), b((size_t)width * height);
+    for (size_t i = 0; i < a.size(); ++i)
+    {
+        a[i] = (uint32_t)(i * 2654435761u);
+        b[i] = premultiply((uint32_t)(i * 40503u) | 0x40000000);
+    }
+    PixelView va{ a.data(), width, height, width };
+    PixelView vb{ b.data(), width, height, width };
+    PixelRect all{ 0, 0, width, height };
+    PixelRect half{ 0, 0, width / 2 > 0 ? width / 2 : 1, height / 2 > 0 ? height / 2 : 1 };
+    std::vector<uint8_t> tileMask((size_t)((width + 31) / 32) * ((height + 31) / 32));
+    struct Case
+    {
+        const char* name;
+        std::function<void()> run;
+    };
+    const Case cases[] = {
+        { "fill", [&] { pixelFillRect(va, all, 0xFF336699); } },
+        { "blend", [&] { pixelBlendRect(va, all, 0x80336699); } },
+        { "composite", [&] { pixelCompositeRect(va, 0, 0, vb, all); } },
+        { "colorKey", [&] { pixelColorKeyRect(va, 0, 0, vb, all, 0x00FF00FF); } },
+        { "swizzle", [&] { pixelSwizzleRect(va, all); } },
+        { "premultiply", [&] { pixelPremultiplyRect(va, all); } },
+        { "nearest", [&] { pixelScaleRect(va, all, vb, half, false); } },
+        { "bilinear", [&] { pixelScaleRect(va, all, vb, half, true); } },
+        { "tileDiff", [&] { pixelDiffTiles(vb, vb, 32, tileMask.data()); } },
+        { "line", [&] { for (int y = 0; y < height; ++y) pixelDrawLine(va, 0, y, width - 1, height - 1 - y, 0xFF00FF00); } },
+    };
+    std::vector<RasterTiming> timings;
+    int previous = rasterLevel.load();
+    for (int level = RASTER_SCALAR; level <= rasterSupportedLevel(); ++level)
+    {
+        rasterLevel.store(level);
+        for (const Case& c : cases)
+        {
+            c.run();
+            auto start = std::chrono::steady_clock::now();
+            for (int i = 0; i < iterations; ++i)
+                c.run();
+            double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            double pixels = (double)width * height * iterations;
+            timings.push_back({ (RasterLevel)level, c.name, seconds > 0 ? pixels / seconds / 1e6 : 0 });
+        }
+    }
+    rasterLevel.store(previous);
+    return timings;
+}
@@ -93,8 +93,12 @@ Lua_Function(SelectObject)
 Lua_Function(DeleteObject)
 {
     HGDIOBJ hObj = luaL_wingetbycheckudata(L, 1, HGDIOBJ);
-    BOOL result = DeleteObject(hObj);
-    lua_pushboolean(L, result);
+    // A cached object deleted here is gone for every holder, so the cache
+    // stops handing it out.
+    gdiCacheForget(hObj);
+    if (GetObjectType(hObj) == OBJ_FONT)
+        textMeasureForgetFont(hObj);
+    lua_pushboolean(L, DeleteObject(hObj));
     return 1;
 }
 Lua_Function(BitBlt)
@@ -207,24 +211,122 @@ static LPPAINTSTRUCT table_to_PAINTSTRUCT(lua_State* L, int index)
     lua_pop(L, 1);
 	return ps;
 }
+// Native PAINTSTRUCT reused across paints, rcPaint is a view into it kept
+// in the session's uservalue so reading it allocates nothing.
+#define PAINTSESSIONNAME "luibexwin.PaintSession"
+#define PAINTRECTNAME "luibexwin.PaintRect"
+struct PaintSession
+{
+    PAINTSTRUCT ps;
+    HWND hwnd;
+};
+struct PaintRect
+{
+    RECT* rect;
+};
+static LONG* paintRectField(RECT* rect, const char* key)
+{
+    if (strcmp(key, "left") == 0) return &rect->left;
+    if (strcmp(key, "top") == 0) return &rect->top;
+    if (strcmp(key, "right") == 0) return &rect->right;
+    if (strcmp(key, "bottom") == 0) return &rect->bottom;
+    return nullptr;
+}
+static int paintrect_index(lua_State* L)
+{
+    PaintRect* pr = luaL_checkobject(L, 1, PaintRect, PAINTRECTNAME);
+    LONG* field = paintRectField(pr->rect, luaL_checkstring(L, 2));
+    if (!field)
+        return 0;
+    lua_pushinteger(L, *field);
+    return 1;
+}
+static int paintrect_newindex(lua_State* L)
+{
+    PaintRect* pr = luaL_checkobject(L, 1, PaintRect, PAINTRECTNAME);
+    LONG* field = paintRectField(pr->rect, luaL_checkstring(L, 2));
+    luaL_argcheck(L, field, 2, "not a RECT field");
+    *field = (LONG)luaL_checkinteger(L, 3);
+    return 0;
+}
+static const luaL_Reg paintrect_metamethods[] = {
+    {"__index", paintrect_index},
+    {"__newindex", paintrect_newindex},
+    {NULL, NULL}
+};
+static int paintsession_index(lua_State* L)
+{
+    PaintSession* session = luaL_checkobject(L, 1, PaintSession, PAINTSESSIONNAME);
+    const char* key = luaL_checkstring(L, 2);
+    if (strcmp(key, "hdc") == 0)
+        pushWindowStruct(L, HDC, session->ps.hdc);
+    else if (strcmp(key, "rcPaint") == 0)
+        lua_getuservalue(L, 1);
+    else if (strcmp(key, "fErase") == 0)
+        lua_pushboolean(L, session->ps.fErase);
+    else if (strcmp(key, "fRestore") == 0)
+        lua_pushboolean(L, session->ps.fRestore);
+    else if (strcmp(key, "fIncUpdate") == 0)
+        lua_pushboolean(L, session->ps.fIncUpdate);
+    else if (strcmp(key, "hwnd") == 0)
+        pushWindowStruct(L, HWND, session->hwnd);
+    else if (strcmp(key, "p") == 0)
+        lua_pushlightuserdata(L, &session->ps);
+    else
+        return 0;
+    return 1;
+}
+static const luaL_Reg paintsession_metamethods[] = {
+    {"__index", paintsession_index},
+    {NULL, NULL}
+};
+static PaintSession* newPaintSession(lua_State* L)
+{
+    PaintSession* session = newLuaObject<PaintSession>(L, PAINTSESSIONNAME, nullptr, paintsession_metamethods);
+    PaintRect* pr = newLuaObject<PaintRect>(L, PAINTRECTNAME, nullptr, paintrect_metamethods);
+    pr->rect = &session->ps.rcPaint;
+    lua_pushvalue(L, -2);
+    lua_setuservalue(L, -2);
+    lua_setuservalue(L, -2);
+    return session;
+}
+// BeginPaint(hwnd, table) fills the table as before. BeginPaint(hwnd [, session])
+// returns hdc, session and reuses the session when one is passed.
 Lua_Function(BeginPaint)
 {
 	HWND hwnd = luaL_wingetbycheckudata(L, 1, HWND);
-    luaL_checktype(L, 2, LUA_TTABLE);
-	LPPAINTSTRUCT lpps = (LPPAINTSTRUCT)lua_newuserdata(L, sizeof(PAINTSTRUCT));
-	lua_setfield(L, 2, "p");
-	HDC hdc = BeginPaint(hwnd, lpps);
-	PAINTSTRUCT_to_table(L, lpps, 2);
-	pushWindowStruct(L, HDC, hdc);
-    return 1;
+    if (lua_istable(L, 2))
+    {
+        LPPAINTSTRUCT lpps = (LPPAINTSTRUCT)lua_newuserdata(L, sizeof(PAINTSTRUCT));
+        lua_setfield(L, 2, "p");
+        HDC hdc = doubleBufferBeginPaint(hwnd, lpps);
+        PAINTSTRUCT_to_table(L, lpps, 2);
+        pushWindowStruct(L, HDC, hdc);
+        return 1;
+    }
+    PaintSession* session;
+    if (lua_isnoneornil(L, 2))
+        session = newPaintSession(L);
+    else
+    {
+        session = luaL_checkobject(L, 2, PaintSession, PAINTSESSIONNAME);
+        lua_pushvalue(L, 2);
+    }
+    session->hwnd = hwnd;
+    HDC hdc = doubleBufferBeginPaint(hwnd, &session->ps);
+    pushWindowStruct(L, HDC, hdc);
+    lua_insert(L, -2);
+    return 2;
 }
 Lua_Function(EndPaint)
 {
     HWND hwnd = luaL_wingetbycheckudata(L, 1, HWND);
-    
-    luaL_checktype(L, 2, LUA_TTABLE);
-    LPPAINTSTRUCT lpps = table_to_PAINTSTRUCT(L, 2);
-    BOOL result = EndPaint(hwnd, lpps);
+    LPPAINTSTRUCT lpps;
+    if (lua_istable(L, 2))
+        lpps = table_to_PAINTSTRUCT(L, 2);
+    else
+        lpps = &luaL_checkobject(L, 2, PaintSession, PAINTSESSIONNAME)->ps;
+    BOOL result = doubleBufferEndPaint(hwnd, lpps);
     lua_pushboolean(L, result);
 	return 1;
 }
@@ -239,29 +341,8 @@ Lua_Function(InvalidateRect)
 		rectPtr = &rect;
     }
     BOOL erase = (BOOL)lua_toboolean(L, 3);
+    doubleBufferInvalidate(hwnd, rectPtr);
     BOOL result = InvalidateRect(hwnd, rectPtr, erase);
     lua_pushboolean(L, result);
     return 1;
-}
-void register_render(lua_State* L)
-{
-    REGIMACRO(SRCCOPY)
-    REGIMACRO(SRCPAINT)
-    REGIMACRO(SRCAND)
-    REGIMACRO(SRCINVERT)
-    REGIMACRO(SRCERASE)
-    REGIMACRO(NOTSRCCOPY)
-    REGIMACRO(NOTSRCERASE)
-    REGIMACRO(MERGECOPY)
-    REGIMACRO(MERGEPAINT)
-    REGIMACRO(PATCOPY)
-    REGIMACRO(PATPAINT)
-    REGIMACRO(PATINVERT)
-    REGIMACRO(DSTINVERT)
-    REGIMACRO(BLACKNESS)
-    REGIMACRO(WHITENESS)
-    // background modes
-	REGIMACRO(TRANSPARENT)
-    REGIMACRO(OPAQUE)
-    REGIMACRO(BKMODE_LAST)
 }
\ No newline at end of file
@@ -0,0 +1,372 @@
+#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+#endif
+WaitableTimerWheel::WaitableTimerWheel()
+{
+    // High resolution timers need Windows 10 1803, older systems get a regular one.
+    timer = CreateWaitableTimerExW(NULL, NULL, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+    if (!timer)
+        timer = CreateWaitableTimerExW(NULL, NULL, 0, TIMER_ALL_ACCESS);
+}
+WaitableTimerWheel::~WaitableTimerWheel()
+{
+    if (timer)
+        CloseHandle(timer);
+}
+void WaitableTimerWheel::arm()
+{
+    if (!timer)
+        return;
+    // Set every time: the signal may have been consumed, or have come early
+    // against the steady clock, without the earliest expiry changing.
+    uint64_t next = nextExpiry();
+    if (next == UINT64_MAX)
+    {
+        CancelWaitableTimer(timer);
+        return;
+    }
+    uint64_t t = clockNow();
+    LARGE_INTEGER due;
+    due.QuadPart = next > t ? -(LONGLONG)((next - t) * 10000) : -1;
+    SetWaitableTimerEx(timer, &due, 0, NULL, NULL, NULL, 0);
+}
+#define SCHEDNAME "luibexwin.scheduler"
+// Coroutines suspended in Await* are only referenced here, what they wait for
+// is kept by SchedulerWaits. Handles are waited on by the thread pool (see
+// handlewaits.h), so only the timer wheel and the message queue are handed to
+// MsgWaitForMultipleObjectsEx.
+struct Scheduler
+{
+    std::deque<std::pair<int, int>> ready; // thread ref, nargs
+    WaitableTimerWheel timers;
+    HandleWaits handleWaits;
+    SchedulerWaits waits{ timers, handleWaits, threadPoolWaitBackend() };
+    std::vector<SchedulerWake> wakes;
+    std::vector<int> woken;
+    std::vector<std::function<void(lua_State*)>> tasks;
+    int pendingWork = 0;
+    bool awaiting = false;
+    bool stopRequested = false;
+    bool running = false;
+};
+Scheduler* getScheduler(lua_State* L)
+{
+    return getRegistryObject<Scheduler>(L, SCHEDNAME);
+}
+void postSchedulerTask(Scheduler* s, std::function<void(lua_State*)> task)
+{
+    s->tasks.push_back(std::move(task));
+}
+void addSchedulerWork(Scheduler* s, int delta)
+{
+    s->pendingWork += delta;
+}
+static int callPrint(lua_State* L)
+{
+    lua_getglobal(L, "print");
+    lua_insert(L, 1);
+    lua_call(L, 1, 0);
+    return 0;
+}
+// Prints and pops the message on top of L.
+static void printSchedulerMessage(lua_State* L)
+{
+    const char* msg = lua_tostring(L, -1);
+    lua_pushcfunction(L, callPrint);
+    lua_pushvalue(L, -2);
+    if (lua_pcall(L, 1, 0, 0) != LUA_OK)
+    {
+        lua_writestringerror("%s\n", msg);
+        lua_pop(L, 1);
+    }
+    lua_pop(L, 1);
+}
+void reportSchedulerError(lua_State* L, const char* what)
+{
+    const char* err = lua_tostring(L, -1);
+    lua_pushfstring(L, "%s failed: %s", what, err ? err : "(error object is not a string)");
+    printSchedulerMessage(L);
+    lua_pop(L, 1);
+}
+static int runSchedulerTask(lua_State* L)
+{
+    (*(std::function<void(lua_State*)>*)lua_touserdata(L, 1))(L);
+    return 0;
+}
+// Each task runs protected, one that raises is reported and the rest of the
+// round still runs.
+void runSchedulerTasks(lua_State* L, Scheduler* s)
+{
+    // Tasks may post more tasks, those run on the next round.
+    std::vector<std::function<void(lua_State*)>> tasks;
+    tasks.swap(s->tasks);
+    for (auto& task : tasks)
+    {
+        lua_pushcfunction(L, runSchedulerTask);
+        lua_pushlightuserdata(L, &task);
+        if (lua_pcall(L, 1, 0, 0) != LUA_OK)
+            reportSchedulerError(L, "Scheduler task");
+    }
+}
+static int resumeThread(lua_State* co, lua_State* from, int nargs, int* nres)
+{
+#if LUA_VERSION_NUM >= 504
+    return lua_resume(co, from, nargs, nres);
+#else
+    int status = lua_resume(co, from, nargs);
+    *nres = lua_gettop(co);
+    return status;
+#endif
+}
+static int refAwaitingThread(lua_State* L, const char* funcName)
+{
+    if (!lua_isyieldable(L))
+        luaL_error(L, "%s must be called from a coroutine run by the scheduler", funcName);
+    lua_pushthread(L);
+    return luaL_ref(L, LUA_REGISTRYINDEX);
+}
+// Moves the nvalues on top of L to the suspended thread and queues it.
+// Its wait is already removed.
+static void wakeThread(lua_State* L, Scheduler* s, int ref, int nvalues)
+{
+    lua_rawgeti(L, LUA_REGISTRYINDEX, ref);
+    lua_State* co = lua_tothread(L, -1);
+    lua_pop(L, 1);
+    lua_xmove(L, co, nvalues);
+    s->ready.emplace_back(ref, nvalues);
+}
+static void reportThreadError(lua_State* L, lua_State* co)
+{
+    const char* err = lua_tostring(co, -1);
+    luaL_traceback(L, co, err ? err : "(error object is not a string)", 0);
+    printSchedulerMessage(L);
+}
+static void resumeReady(lua_State* L, Scheduler* s)
+{
+    // Only what is ready now, a coroutine that yields plainly runs again next round.
+    size_t count = s->ready.size();
+    while (count-- > 0 && !s->ready.empty())
+    {
+        auto [ref, nargs] = s->ready.front();
+        s->ready.pop_front();
+        lua_rawgeti(L, LUA_REGISTRYINDEX, ref);
+        lua_State* co = lua_tothread(L, -1);
+        luaL_unref(L, LUA_REGISTRYINDEX, ref);
+        s->awaiting = false;
+        int nres = 0;
+        int status = resumeThread(co, L, nargs, &nres);
+        if (status == LUA_YIELD)
+        {
+            lua_pop(co, nres);
+            if (!s->awaiting)
+            {
+                lua_pushvalue(L, -1);
+                s->ready.emplace_back(luaL_ref(L, LUA_REGISTRYINDEX), 0);
+            }
+        }
+        else if (status != LUA_OK)
+        {
+            reportThreadError(L, co);
+        }
+        lua_pop(L, 1);
+    }
+}
+static void wakeAll(lua_State* L, Scheduler* s)
+{
+    for (const SchedulerWake& w : s->wakes)
+    {
+        if (w.handle)
+            lua_pushboolean(L, w.signaled);
+        wakeThread(L, s, w.ref, w.handle ? 1 : 0);
+    }
+    s->wakes.clear();
+}
+static void wakeFiredHandles(lua_State* L, Scheduler* s)
+{
+    s->waits.takeFiredHandles(s->wakes);
+    wakeAll(L, s);
+}
+static void expireTimers(lua_State* L, Scheduler* s)
+{
+    s->waits.takeExpired(s->wakes);
+    wakeAll(L, s);
+}
+static void deliverMessage(lua_State* L, Scheduler* s, const MSG& msg)
+{
+    s->woken.clear();
+    s->waits.takeMessageWaiters(msg.hwnd, msg.message, s->woken);
+    for (int ref : s->woken)
+    {
+        pushWindowStruct(L, HWND, msg.hwnd);
+        lua_pushinteger(L, msg.message);
+        lua_pushinteger(L, (lua_Integer)msg.wParam);
+        lua_pushinteger(L, (lua_Integer)msg.lParam);
+        wakeThread(L, s, ref, 4);
+    }
+}
+Lua_Function(SpawnCoroutine)
+{
+    luaL_checktype(L, 1, LUA_TFUNCTION);
+    int n = lua_gettop(L);
+    Scheduler* s = getScheduler(L);
+    lua_State* co = lua_newthread(L);
+    lua_pushvalue(L, -1);
+    int ref = luaL_ref(L, LUA_REGISTRYINDEX);
+    for (int i = 1; i <= n; ++i)
+        lua_pushvalue(L, i);
+    lua_xmove(L, co, n);
+    s->ready.emplace_back(ref, n - 1);
+    return 1;
+}
+Lua_Function(AwaitTimeout)
+{
+    lua_Integer ms = luaL_checkinteger(L, 1);
+    Scheduler* s = getScheduler(L);
+    int ref = refAwaitingThread(L, "AwaitTimeout");
+    s->waits.addTimeout(ref, ms);
+    s->awaiting = true;
+    return lua_yield(L, 0);
+}
+// The handle is duplicated for the thread pool wait, one that cannot be
+// waited on returns false at once.
+Lua_Function(AwaitHandle)
+{
+    HANDLE h = luaL_wingetbycheckudata(L, 1, HANDLE);
+    lua_Integer ms = luaL_optinteger(L, 2, -1);
+    Scheduler* s = getScheduler(L);
+    int ref = refAwaitingThread(L, "AwaitHandle");
+    if (!s->waits.addHandle(ref, h, ms))
+    {
+        luaL_unref(L, LUA_REGISTRYINDEX, ref);
+        lua_pushboolean(L, 0);
+        return 1;
+    }
+    s->awaiting = true;
+    return lua_yield(L, 0);
+}
+Lua_Function(AwaitMessage)
+{
+    HWND hwnd = luaL_wingetbyudata(L, 1, HWND);
+    UINT msgMin = (UINT)luaL_optinteger(L, 2, 0);
+    UINT msgMax = (UINT)luaL_optinteger(L, 3, msgMin);
+    Scheduler* s = getScheduler(L);
+    int ref = refAwaitingThread(L, "AwaitMessage");
+    s->waits.addMessage(ref, hwnd, msgMin, msgMax);
+    s->awaiting = true;
+    return lua_yield(L, 0);
+}
+Lua_Function(AwaitCompletion)
+{
+    lua_Integer key = luaL_checkinteger(L, 1);
+    Scheduler* s = getScheduler(L);
+    int ref = refAwaitingThread(L, "AwaitCompletion");
+    s->waits.addCompletion(ref, key);
+    s->awaiting = true;
+    return lua_yield(L, 0);
+}
+int signalSchedulerCompletion(lua_State* L, Scheduler* s, lua_Integer key, int nvalues)
+{
+    int first = lua_gettop(L) - nvalues + 1;
+    std::vector<int> refs;
+    s->waits.takeCompletionWaiters(key, refs);
+    for (int ref : refs)
+    {
+        for (int i = 0; i < nvalues; ++i)
+            lua_pushvalue(L, first + i);
+        wakeThread(L, s, ref, nvalues);
+    }
+    lua_pop(L, nvalues);
+    return (int)refs.size();
+}
+Lua_Function(SignalCompletion)
+{
+    lua_Integer key = luaL_checkinteger(L, 1);
+    int nvalues = lua_gettop(L) - 1;
+    int woken = signalSchedulerCompletion(L, getScheduler(L), key, nvalues);
+    lua_pushinteger(L, woken);
+    return 1;
+}
+Lua_Function(StopScheduler)
+{
+    getScheduler(L)->stopRequested = true;
+    return 0;
+}
+static int schedulerLoop(lua_State* L)
+{
+    Scheduler* s = (Scheduler*)lua_touserdata(L, 1);
+    bool untilIdle = lua_toboolean(L, 2);
+    bool quit = false;
+    WPARAM exitCode = 0;
+    while (!s->stopRequested && !quit)
+    {
+        runSchedulerTasks(L, s);
+        resumeReady(L, s);
+        expireTimers(L, s);
+        if (s->stopRequested)
+            break;
+        if (untilIdle && s->ready.empty() && s->waits.empty() && s->tasks.empty() && !s->pendingWork)
+            break;
+
+        // Drained right before the wait, a handle signaled after this queues
+        // an APC that ends it.
+        wakeFiredHandles(L, s);
+        s->timers.arm();
+        HANDLE timer = s->timers.size() ? s->timers.handle() : NULL;
+        DWORD count = timer ? 1 : 0;
+
+        DWORD timeout = INFINITE;
+        if (!s->ready.empty() || !s->tasks.empty())
+            timeout = 0;
+        else if (s->timers.size())
+        {
+            uint64_t now = s->timers.clockNow();
+            uint64_t deadline = s->timers.nextExpiry();
+            timeout = deadline <= now ? 0 : (DWORD)min(deadline - now, (uint64_t)(INFINITE - 1));
+        }
+
+        DWORD r = MsgWaitForMultipleObjectsEx(count, &timer, timeout, QS_ALLINPUT,
+            MWMO_ALERTABLE | MWMO_INPUTAVAILABLE);
+        if (r == WAIT_OBJECT_0 + count)
+        {
+            MSG msg;
+            while (PeekMessageA(&msg, NULL, 0, 0, PM_REMOVE))
+            {
+                if (msg.message == WM_QUIT)
+                {
+                    quit = true;
+                    exitCode = msg.wParam;
+                    break;
+                }
+                TranslateMessage(&msg);
+                DispatchMessageA(&msg);
+                deliverMessage(L, s, msg);
+            }
+        }
+    }
+    if (quit)
+    {
+        lua_pushinteger(L, (lua_Integer)exitCode);
+        return 1;
+    }
+    return 0;
+}
+// The loop runs protected: a window procedure or callback that raises still
+// leaves the scheduler runnable, the error is rethrown after.
+Lua_Function(RunScheduler)
+{
+    bool untilIdle = lua_toboolean(L, 1);
+    Scheduler* s = getScheduler(L);
+    if (s->running)
+        return luaL_error(L, "RunScheduler is already running");
+    s->running = true;
+    s->stopRequested = false;
+    int base = lua_gettop(L);
+    lua_pushcfunction(L, schedulerLoop);
+    lua_pushlightuserdata(L, s);
+    lua_pushboolean(L, untilIdle);
+    int status = lua_pcall(L, 2, LUA_MULTRET, 0);
+    s->running = false;
+    if (status != LUA_OK)
+        return lua_error(L);
+    return lua_gettop(L) - base;
+}
@@ -0,0 +1,172 @@
+SchedulerWaits::SchedulerWaits(TimerWheel& timers, HandleWaits& handles, HandleWaitBackend* backend)
+    : timers(timers), handles(handles), backend(backend)
+{
+}
+SchedulerWaits::~SchedulerWaits()
+{
+    for (auto& entry : handleWaiters)
+        if (entry.second.wait)
+            closeHandleWait(&handles, std::move(entry.second.wait));
+    handleWaiters.clear();
+    if (handles.backend)
+        closeHandleWaits(&handles);
+}
+void SchedulerWaits::addDeadline(int ref, Wait& wait, int64_t ms)
+{
+    if (ms < 0)
+        return;
+    wait.hasDeadline = true;
+    wait.timerId = timers.add((uint64_t)ms, 0, ref);
+}
+void SchedulerWaits::addTimeout(int ref, int64_t ms)
+{
+    addDeadline(ref, waits[ref], ms < 0 ? 0 : ms);
+}
+bool SchedulerWaits::addHandle(int ref, HANDLE h, int64_t ms)
+{
+    HandleWaiters& waiters = handleWaiters[h];
+    if (!waiters.wait)
+    {
+        if (!handles.backend)
+            openHandleWaits(&handles, backend, nullptr, nullptr);
+        if (handles.backend)
+            waiters.wait = openHandleWait(&handles, h, INFINITE, (uintptr_t)h);
+        if (!waiters.wait)
+        {
+            handleWaiters.erase(h);
+            return false;
+        }
+    }
+    waiters.refs.push_back(ref);
+    Wait& wait = waits[ref];
+    wait.handle = h;
+    addDeadline(ref, wait, ms);
+    return true;
+}
+void SchedulerWaits::addMessage(int ref, void* hwnd, unsigned msgMin, unsigned msgMax)
+{
+    Wait& wait = waits[ref];
+    wait.forMessage = true;
+    wait.msgHwnd = hwnd;
+    wait.msgMin = msgMin;
+    wait.msgMax = msgMax;
+    messageWaiters.push_back(ref);
+}
+void SchedulerWaits::addCompletion(int ref, int64_t key)
+{
+    Wait& wait = waits[ref];
+    wait.forCompletion = true;
+    wait.completion = key;
+    completionWaiters[key].push_back(ref);
+}
+static void eraseRef(std::vector<int>& refs, int ref)
+{
+    for (size_t i = 0; i < refs.size(); ++i)
+    {
+        if (refs[i] == ref)
+        {
+            refs.erase(refs.begin() + i);
+            return;
+        }
+    }
+}
+void SchedulerWaits::remove(int ref)
+{
+    auto it = waits.find(ref);
+    if (it == waits.end())
+        return;
+    Wait& wait = it->second;
+    if (wait.hasDeadline)
+        timers.cancel(wait.timerId);
+    if (wait.handle)
+    {
+        auto hit = handleWaiters.find(wait.handle);
+        if (hit != handleWaiters.end())
+        {
+            eraseRef(hit->second.refs, ref);
+            if (hit->second.refs.empty())
+            {
+                closeHandleWait(&handles, std::move(hit->second.wait));
+                handleWaiters.erase(hit);
+            }
+        }
+    }
+    if (wait.forMessage)
+        eraseRef(messageWaiters, ref);
+    if (wait.forCompletion)
+    {
+        auto cit = completionWaiters.find(wait.completion);
+        if (cit != completionWaiters.end())
+        {
+            eraseRef(cit->second, ref);
+            if (cit->second.empty())
+                completionWaiters.erase(cit);
+        }
+    }
+    waits.erase(it);
+}
+void SchedulerWaits::takeExpired(std::vector<SchedulerWake>& out)
+{
+    expired.clear();
+    timers.advance(timers.clockNow(), expired);
+    for (const TimerWheel::Expired& e : expired)
+    {
+        int ref = (int)e.cookie;
+        auto it = waits.find(ref);
+        if (it == waits.end() || it->second.timerId != e.id)
+            continue;
+        bool handle = it->second.handle != NULL;
+        remove(ref);
+        out.push_back({ ref, handle, false });
+    }
+}
+// Waking the last waiter of a handle closes its entry, so the cookie is read
+// first.
+void SchedulerWaits::takeFiredHandles(std::vector<SchedulerWake>& out)
+{
+    fired.clear();
+    if (handles.backend)
+        drainHandleWaits(&handles, fired);
+    for (HandleWait* e : fired)
+    {
+        HANDLE h = (HANDLE)e->cookie;
+        bool signaled = !e->timedOut;
+        auto it = handleWaiters.find(h);
+        if (it == handleWaiters.end())
+            continue;
+        std::vector<int> refs = it->second.refs;
+        for (int ref : refs)
+        {
+            remove(ref);
+            out.push_back({ ref, true, signaled });
+        }
+    }
+}
+void SchedulerWaits::takeMessageWaiters(void* hwnd, unsigned message, std::vector<int>& out)
+{
+    if (messageWaiters.empty())
+        return;
+    std::vector<int> refs = messageWaiters;
+    for (int ref : refs)
+    {
+        const Wait& wait = waits[ref];
+        if (wait.msgHwnd && wait.msgHwnd != hwnd)
+            continue;
+        if ((wait.msgMin || wait.msgMax) && (message < wait.msgMin || message > wait.msgMax))
+            continue;
+        remove(ref);
+        out.push_back(ref);
+    }
+}
+void SchedulerWaits::takeCompletionWaiters(int64_t key, std::vector<int>& out)
+{
+    auto it = completionWaiters.find(key);
+    if (it == completionWaiters.end())
+        return;
+    std::vector<int> refs = it->second;
+    for (int ref : refs)
+    {
+        remove(ref);
+        out.push_back(ref);
+    }
+}
@@ -21,22 +21,4 @@ Lua_Function(PlaySound)
     UINT flags = (UINT)luaL_optinteger(L, 3, SND_FILENAME | SND_ASYNC);
     ::PlaySoundA(filename, mod, flags);
     return 0;
-}
-void register_sound(lua_State* L)
-{
-    REGIMACRO(SND_SYNC)
-    REGIMACRO(SND_ASYNC)
-    REGIMACRO(SND_NODEFAULT)
-    REGIMACRO(SND_MEMORY)
-    REGIMACRO(SND_LOOP)
-    REGIMACRO(SND_NOSTOP)
-    REGIMACRO(SND_NOWAIT)
-    REGIMACRO(SND_ALIAS)
-    REGIMACRO(SND_ALIAS_ID)
-    REGIMACRO(SND_FILENAME)
-    REGIMACRO(SND_RESOURCE)
-    REGIMACRO(SND_PURGE)
-    REGIMACRO(SND_APPLICATION)
-    REGIMACRO(SND_SYSTEM)
-    REGIMACRO(SND_RING)
 }
\ No newline at end of file
@@ -0,0 +1,486 @@
+#define PROCESSNAME "luibexwin.Process"
+static void finishIfDone(SpawnedProcess* p)
+{
+    if (p->finished || !p->exited || p->out.open || p->err.open)
+        return;
+    p->finished = true;
+    p->endMs = TimerWheel::now();
+    if (!p->closing && p->onFinish)
+        p->onFinish(p);
+}
+static void closeStream(SpawnStream* s)
+{
+    if (s->pipe)
+        CloseHandle(s->pipe);
+    s->pipe = NULL;
+    s->open = false;
+}
+static void CALLBACK readCompleted(DWORD error, DWORD bytes, LPOVERLAPPED ov);
+static bool readNext(SpawnStream* s)
+{
+    ZeroMemory(&s->ov, sizeof(s->ov));
+    if (!ReadFileEx(s->pipe, s->chunk, sizeof(s->chunk), &s->ov, readCompleted))
+        return false;
+    ++s->owner->pending;
+    return true;
+}
+// Broken pipe is the normal end of a stream, aborted means closeProcess.
+static void CALLBACK readCompleted(DWORD error, DWORD bytes, LPOVERLAPPED ov)
+{
+    SpawnStream* s = CONTAINING_RECORD(ov, SpawnStream, ov);
+    SpawnedProcess* p = s->owner;
+    --p->pending;
+    if (error == ERROR_SUCCESS && !p->closing)
+    {
+        if (bytes)
+        {
+            s->data.append(s->chunk, bytes);
+            if (p->onOutput)
+                p->onOutput(p, *s, bytes);
+        }
+        if (readNext(s))
+            return;
+    }
+    closeStream(s);
+    finishIfDone(p);
+}
+static void CALLBACK exitApc(ULONG_PTR param)
+{
+    SpawnedProcess* p = (SpawnedProcess*)param;
+    --p->pending;
+    p->exited = true;
+    GetExitCodeProcess(p->process, &p->exitCode);
+    finishIfDone(p);
+}
+// Thread pool callback, the exit is handed to the starting thread.
+static void CALLBACK processExited(void* param, BOOLEAN)
+{
+    SpawnedProcess* p = (SpawnedProcess*)param;
+    p->exitQueued = true;
+    QueueUserAPC(exitApc, p->thread, (ULONG_PTR)p);
+}
+static bool createOutputPipe(SpawnStream& s, HANDLE& child)
+{
+    static std::atomic<uint32_t> serial = 0;
+    char name[64];
+    snprintf(name, sizeof(name), "\\\\.\\pipe\\luibexwin.%lu.%lu", GetCurrentProcessId(), (unsigned long)++serial);
+    HANDLE pipe = CreateNamedPipeA(name, PIPE_ACCESS_INBOUND | FILE_FLAG_OVERLAPPED | FILE_FLAG_FIRST_PIPE_INSTANCE,
+        PIPE_TYPE_BYTE | PIPE_READMODE_BYTE | PIPE_WAIT | PIPE_REJECT_REMOTE_CLIENTS, 1, 0, 65536, 0, NULL);
+    if (pipe == INVALID_HANDLE_VALUE)
+        return false;
+    SECURITY_ATTRIBUTES sa = { sizeof(sa), NULL, TRUE };
+    child = CreateFileA(name, GENERIC_WRITE, 0, &sa, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (child == INVALID_HANDLE_VALUE)
+    {
+        child = NULL;
+        CloseHandle(pipe);
+        return false;
+    }
+    s.pipe = pipe;
+    return true;
+}
+// Only the three standard handles are inherited, so a child never holds the
+// write end of another child's pipe and delays its end of stream.
+static BOOL createChild(char* commandLine, const char* cwd, DWORD flags, HANDLE* handles, PROCESS_INFORMATION* pi)
+{
+    SIZE_T size = 0;
+    InitializeProcThreadAttributeList(NULL, 1, 0, &size);
+    std::vector<char> storage(size);
+    auto attributes = (LPPROC_THREAD_ATTRIBUTE_LIST)storage.data();
+    if (!InitializeProcThreadAttributeList(attributes, 1, 0, &size))
+        return FALSE;
+    BOOL ok = UpdateProcThreadAttribute(attributes, 0, PROC_THREAD_ATTRIBUTE_HANDLE_LIST, handles, 3 * sizeof(HANDLE), NULL, NULL);
+    if (ok)
+    {
+        STARTUPINFOEXA si;
+        ZeroMemory(&si, sizeof(si));
+        si.StartupInfo.cb = sizeof(si);
+        si.StartupInfo.dwFlags = STARTF_USESTDHANDLES;
+        si.StartupInfo.hStdInput = handles[0];
+        si.StartupInfo.hStdOutput = handles[1];
+        si.StartupInfo.hStdError = handles[2];
+        si.lpAttributeList = attributes;
+        ok = CreateProcessA(NULL, commandLine, NULL, NULL, TRUE, flags | EXTENDED_STARTUPINFO_PRESENT, NULL, cwd, &si.StartupInfo, pi);
+    }
+    DWORD error = GetLastError();
+    DeleteProcThreadAttributeList(attributes);
+    SetLastError(error);
+    return ok;
+}
+bool startProcess(SpawnedProcess* p, const char* commandLine, const char* cwd, HANDLE job, DWORD flags)
+{
+    p->out.owner = p;
+    p->err.owner = p;
+    HANDLE handles[3] = {};
+    SECURITY_ATTRIBUTES sa = { sizeof(sa), NULL, TRUE };
+    handles[0] = CreateFileA("NUL", GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, &sa, OPEN_EXISTING, 0, NULL);
+    if (handles[0] == INVALID_HANDLE_VALUE)
+        handles[0] = NULL;
+    BOOL ok = handles[0] && createOutputPipe(p->out, handles[1]) && createOutputPipe(p->err, handles[2]);
+    PROCESS_INFORMATION pi = {};
+    if (ok)
+    {
+        std::string command(commandLine);
+        ok = createChild(command.data(), cwd, flags | (job ? CREATE_SUSPENDED : 0), handles, &pi);
+    }
+    DWORD error = GetLastError();
+    for (HANDLE h : handles)
+        if (h)
+            CloseHandle(h);
+    if (!ok)
+    {
+        closeStream(&p->out);
+        closeStream(&p->err);
+        SetLastError(error);
+        return false;
+    }
+    if (job)
+    {
+        // A parent job without breakaway refuses nested assignment on old
+        // systems, the child then runs outside the job.
+        AssignProcessToJobObject(job, pi.hProcess);
+        ResumeThread(pi.hThread);
+    }
+    CloseHandle(pi.hThread);
+    p->process = pi.hProcess;
+    p->pid = pi.dwProcessId;
+    p->startMs = TimerWheel::now();
+    DuplicateHandle(GetCurrentProcess(), GetCurrentThread(), GetCurrentProcess(), &p->thread, 0, FALSE, DUPLICATE_SAME_ACCESS);
+    for (SpawnStream* s : { &p->out, &p->err })
+    {
+        s->open = readNext(s);
+        if (!s->open)
+            closeStream(s);
+    }
+    ++p->pending;
+    if (!RegisterWaitForSingleObject(&p->wait, p->process, processExited, p, INFINITE, WT_EXECUTEONLYONCE))
+    {
+        error = GetLastError();
+        --p->pending;
+        p->wait = NULL;
+        TerminateProcess(p->process, 1);
+        closeProcess(p);
+        SetLastError(error);
+        return false;
+    }
+    return true;
+}
+void closeProcess(SpawnedProcess* p)
+{
+    p->closing = true;
+    if (p->wait)
+    {
+        UnregisterWaitEx(p->wait, INVALID_HANDLE_VALUE);
+        p->wait = NULL;
+        if (!p->exitQueued)
+            --p->pending;
+    }
+    for (SpawnStream* s : { &p->out, &p->err })
+        if (s->pipe)
+            CancelIoEx(s->pipe, NULL);
+    while (p->pending > 0)
+        SleepEx(INFINITE, TRUE);
+    closeStream(&p->out);
+    closeStream(&p->err);
+    if (p->process)
+        CloseHandle(p->process);
+    if (p->thread)
+        CloseHandle(p->thread);
+    p->process = NULL;
+    p->thread = NULL;
+}
+
+// Process userdata. While the child runs it is anchored in the registry and
+// its events reach Lua as scheduler tasks, the callbacks live in the
+// uservalue table.
+struct LuaProcess
+{
+    SpawnedProcess proc;
+    Scheduler* scheduler = nullptr;
+    int selfRef = LUA_NOREF;
+    lua_Integer completion = 0;
+    bool capture = true;
+    bool hasOutputCallback = false;
+    bool outputQueued = false;
+    bool finishQueued = false;
+    size_t delivered[2] = {};
+    ~LuaProcess()
+    {
+        closeProcess(&proc);
+    }
+};
+static LuaProcess* checkProcess(lua_State* L, int idx)
+{
+    return luaL_checkobject(L, idx, LuaProcess, PROCESSNAME);
+}
+static void callProcessCallback(lua_State* L, int nargs)
+{
+    if (lua_pcall(L, nargs, 0, 0) != LUA_OK)
+        reportSchedulerError(L, "Process callback");
+}
+static void deliverOutput(lua_State* L, LuaProcess* lp)
+{
+    lp->outputQueued = false;
+    lua_rawgeti(L, LUA_REGISTRYINDEX, lp->selfRef);
+    int self = lua_gettop(L);
+    lua_getuservalue(L, self);
+    lua_getfield(L, -1, "onOutput");
+    int callback = lua_gettop(L);
+    static const char* const names[2] = { "stdout", "stderr" };
+    for (int i = 0; i < 2; ++i)
+    {
+        SpawnStream& s = i ? lp->proc.err : lp->proc.out;
+        if (s.data.size() <= lp->delivered[i])
+            continue;
+        if (lua_isfunction(L, callback))
+        {
+            lua_pushvalue(L, callback);
+            lua_pushvalue(L, self);
+            lua_pushstring(L, names[i]);
+            lua_pushlstring(L, s.data.data() + lp->delivered[i], s.data.size() - lp->delivered[i]);
+            callProcessCallback(L, 3);
+        }
+        if (lp->capture)
+            lp->delivered[i] = s.data.size();
+        else
+        {
+            s.data.clear();
+            lp->delivered[i] = 0;
+        }
+    }
+    lua_settop(L, self - 1);
+}
+static void pushProcessResults(lua_State* L, LuaProcess* lp)
+{
+    if (lp->proc.exited)
+        lua_pushinteger(L, (lua_Integer)lp->proc.exitCode);
+    else
+        lua_pushnil(L);
+    if (lp->capture)
+    {
+        lua_pushlstring(L, lp->proc.out.data.data(), lp->proc.out.data.size());
+        lua_pushlstring(L, lp->proc.err.data.data(), lp->proc.err.data.size());
+    }
+    else
+    {
+        lua_pushnil(L);
+        lua_pushnil(L);
+    }
+}
+// Last event of a process: remaining output, onExit, the completion and the
+// registry anchor is dropped.
+static void finishLuaProcess(lua_State* L, LuaProcess* lp)
+{
+    deliverOutput(L, lp);
+    lua_rawgeti(L, LUA_REGISTRYINDEX, lp->selfRef);
+    int self = lua_gettop(L);
+    lua_getuservalue(L, self);
+    lua_getfield(L, -1, "onExit");
+    if (lua_isfunction(L, -1))
+    {
+        lua_pushvalue(L, self);
+        if (lp->proc.exited)
+            lua_pushinteger(L, (lua_Integer)lp->proc.exitCode);
+        else
+            lua_pushnil(L);
+        callProcessCallback(L, 2);
+    }
+    else
+        lua_pop(L, 1);
+    pushProcessResults(L, lp);
+    signalSchedulerCompletion(L, lp->scheduler, lp->completion, 3);
+    lua_settop(L, self - 1);
+    luaL_unref(L, LUA_REGISTRYINDEX, lp->selfRef);
+    lp->selfRef = LUA_NOREF;
+    addSchedulerWork(lp->scheduler, -1);
+}
+static void queueFinish(LuaProcess* lp)
+{
+    if (lp->finishQueued)
+        return;
+    lp->finishQueued = true;
+    postSchedulerTask(lp->scheduler, [lp](lua_State* L) { finishLuaProcess(L, lp); });
+}
+// proc:pid() -> process id
+static int process_pid(lua_State* L)
+{
+    lua_pushinteger(L, (lua_Integer)checkProcess(L, 1)->proc.pid);
+    return 1;
+}
+// proc:handle() -> process HANDLE, owned by proc
+static int process_handle(lua_State* L)
+{
+    pushWindowStruct(L, HANDLE, checkProcess(L, 1)->proc.process);
+    return 1;
+}
+// proc:running() -> true until the child exited and its pipes are drained
+static int process_running(lua_State* L)
+{
+    lua_pushboolean(L, !checkProcess(L, 1)->proc.finished);
+    return 1;
+}
+// proc:exitCode() -> exit code, nil while running
+static int process_exitcode(lua_State* L)
+{
+    LuaProcess* lp = checkProcess(L, 1);
+    if (!lp->proc.exited)
+        return 0;
+    lua_pushinteger(L, (lua_Integer)lp->proc.exitCode);
+    return 1;
+}
+// proc:stdout() / proc:stderr() -> everything captured so far
+static int process_stdout(lua_State* L)
+{
+    const std::string& data = checkProcess(L, 1)->proc.out.data;
+    lua_pushlstring(L, data.data(), data.size());
+    return 1;
+}
+static int process_stderr(lua_State* L)
+{
+    const std::string& data = checkProcess(L, 1)->proc.err.data;
+    lua_pushlstring(L, data.data(), data.size());
+    return 1;
+}
+// proc:elapsed() -> milliseconds since the start, up to the exit once finished
+static int process_elapsed(lua_State* L)
+{
+    LuaProcess* lp = checkProcess(L, 1);
+    uint64_t end = lp->proc.finished ? lp->proc.endMs : TimerWheel::now();
+    lua_pushinteger(L, (lua_Integer)(end - lp->proc.startMs));
+    return 1;
+}
+// proc:wait([ms]) -> exitCode, stdout, stderr or nothing on timeout. Blocks in
+// an alertable wait and runs the pending callbacks, for scripts without
+// RunScheduler.
+static int process_wait(lua_State* L)
+{
+    LuaProcess* lp = checkProcess(L, 1);
+    lua_Integer ms = luaL_optinteger(L, 2, -1);
+    uint64_t deadline = TimerWheel::now() + (uint64_t)(ms < 0 ? 0 : ms);
+    while (!lp->proc.finished && !lp->proc.closing)
+    {
+        uint64_t now = TimerWheel::now();
+        if (ms >= 0 && now >= deadline)
+            break;
+        SleepEx(ms < 0 ? INFINITE : (DWORD)(deadline - now), TRUE);
+    }
+    runSchedulerTasks(L, lp->scheduler);
+    if (!lp->proc.finished)
+        return 0;
+    pushProcessResults(L, lp);
+    return 3;
+}
+// proc:await() -> exitCode, stdout, stderr, from a scheduler coroutine
+static int process_await(lua_State* L)
+{
+    LuaProcess* lp = checkProcess(L, 1);
+    if (lp->selfRef == LUA_NOREF)
+    {
+        pushProcessResults(L, lp);
+        return 3;
+    }
+    lua_settop(L, 0);
+    lua_pushinteger(L, lp->completion);
+    return ll_AwaitCompletion(L);
+}
+// proc:terminate([exitCode = 1]) -> boolean
+static int process_terminate(lua_State* L)
+{
+    LuaProcess* lp = checkProcess(L, 1);
+    UINT code = (UINT)luaL_optinteger(L, 2, 1);
+    lua_pushboolean(L, lp->proc.process && !lp->proc.exited && TerminateProcess(lp->proc.process, code));
+    return 1;
+}
+// proc:close() stops reading, the child keeps running. onExit still runs,
+// with a nil exit code if the child had not exited.
+static int process_close(lua_State* L)
+{
+    LuaProcess* lp = checkProcess(L, 1);
+    if (lp->proc.closing)
+        return 0;
+    closeProcess(&lp->proc);
+    queueFinish(lp);
+    return 0;
+}
+static const luaL_Reg process_methods[] = {
+    {"pid", process_pid},
+    {"handle", process_handle},
+    {"running", process_running},
+    {"exitCode", process_exitcode},
+    {"stdout", process_stdout},
+    {"stderr", process_stderr},
+    {"elapsed", process_elapsed},
+    {"wait", process_wait},
+    {"await", process_await},
+    {"terminate", process_terminate},
+    {"close", process_close},
+    {NULL, NULL}
+};
+// SpawnProcess(commandLine [, options]) -> Process or nil, error code
+// options: cwd, flags (creation flags, default CREATE_NO_WINDOW), capture
+// (default true, false keeps only what onOutput has not seen yet),
+// onOutput(proc, "stdout" | "stderr", chunk), onExit(proc, exitCode) and
+// completion, a key for AwaitCompletion resumed with exitCode, stdout, stderr.
+Lua_Function(SpawnProcess)
+{
+    const char* commandLine = luaL_checkstring(L, 1);
+    bool hasOptions = !lua_isnoneornil(L, 2);
+    if (hasOptions)
+        luaL_checktype(L, 2, LUA_TTABLE);
+    // Created first so it is finalized after every process on lua_close.
+    Scheduler* scheduler = getScheduler(L);
+    LuaProcess* lp = newLuaObject<LuaProcess>(L, PROCESSNAME, process_methods, nullptr);
+    int self = lua_gettop(L);
+    lp->scheduler = scheduler;
+    lp->completion = (lua_Integer)(intptr_t)lp;
+    lua_createtable(L, 0, 2);
+    const char* cwd = nullptr;
+    DWORD flags = CREATE_NO_WINDOW;
+    if (hasOptions)
+    {
+        lua_getfield(L, 2, "cwd");
+        cwd = luaL_optstring(L, -1, nullptr);
+        lua_getfield(L, 2, "flags");
+        flags = (DWORD)luaL_optinteger(L, -1, flags);
+        lua_getfield(L, 2, "capture");
+        lp->capture = lua_isnil(L, -1) || lua_toboolean(L, -1);
+        lua_getfield(L, 2, "completion");
+        lp->completion = luaL_optinteger(L, -1, lp->completion);
+        // cwd stays anchored by the options table.
+        lua_pop(L, 4);
+        lua_getfield(L, 2, "onOutput");
+        lp->hasOutputCallback = lua_isfunction(L, -1);
+        lua_setfield(L, self + 1, "onOutput");
+        lua_getfield(L, 2, "onExit");
+        lua_setfield(L, self + 1, "onExit");
+    }
+    lua_setuservalue(L, self);
+    lp->proc.onOutput = [lp](SpawnedProcess*, SpawnStream& s, size_t) {
+        if (!lp->hasOutputCallback)
+        {
+            if (!lp->capture)
+                s.data.clear();
+            return;
+        }
+        if (!lp->outputQueued)
+        {
+            lp->outputQueued = true;
+            postSchedulerTask(lp->scheduler, [lp](lua_State* L) {
+                if (!lp->finishQueued)
+                    deliverOutput(L, lp);
+            });
+        }
+    };
+    lp->proc.onFinish = [lp](SpawnedProcess*) { queueFinish(lp); };
+    if (!startProcess(&lp->proc, commandLine, cwd, NULL, flags))
+    {
+        lua_pushnil(L);
+        lua_pushinteger(L, (lua_Integer)GetLastError());
+        return 2;
+    }
+    lua_pushvalue(L, self);
+    lp->selfRef = luaL_ref(L, LUA_REGISTRYINDEX);
+    addSchedulerWork(scheduler, 1);
+    lua_settop(L, self);
+    return 1;
+}
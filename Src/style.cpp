@@ -1,15 +0,0 @@
-void register_style(lua_State* L) {
-	REGIMACRO(CS_VREDRAW)
-	REGIMACRO(CS_HREDRAW)
-	REGIMACRO(CS_OWNDC)
-	REGIMACRO(CS_CLASSDC)
-	REGIMACRO(CS_PARENTDC)
-	REGIMACRO(CS_NOCLOSE)
-	REGIMACRO(CS_SAVEBITS)
-	REGIMACRO(CS_BYTEALIGNCLIENT)
-	REGIMACRO(CS_BYTEALIGNWINDOW)
-	REGIMACRO(CS_GLOBALCLASS)
-	REGIMACRO(CS_DBLCLKS)
-	REGIMACRO(CS_IME)
-	REGIMACRO(CS_DROPSHADOW)
-}
\ No newline at end of file
@@ -59,14 +59,14 @@ Lua_Function(GetTextExtentPoint32)
 	HDC hdc = luaL_wingetbycheckudata(L, 1, HDC);
 	size_t len = 0;
 	const char* str = luaL_checklstring(L, 2, &len);
-	LPSIZE lpSize = (LPSIZE)lua_newuserdata(L, sizeof(SIZE));
-	BOOL result = GetTextExtentPoint32A(hdc, str, (int)len, lpSize);
+	SIZE size;
+	BOOL result = GetTextExtentPoint32A(hdc, str, (int)len, &size);
 	lua_pushboolean(L, result);
 	if (result) {
-		lua_newtable(L);
-		lua_pushinteger(L, lpSize->cx);
+		lua_createtable(L, 0, 2);
+		lua_pushinteger(L, size.cx);
 		lua_setfield(L, -2, "cx");
-		lua_pushinteger(L, lpSize->cy);
+		lua_pushinteger(L, size.cy);
 		lua_setfield(L, -2, "cy");
 	} else {
 		lua_pushnil(L);
@@ -0,0 +1,128 @@
+// Entries are dropped all at once when the cache is full, layouts measure the
+// same few labels over and over so it refills quickly.
+constexpr size_t TEXTMEASURE_LIMIT = 8192;
+// The DC state that changes the extent of a string in a given font.
+struct TextDcState
+{
+    int dpi;
+    int charExtra;
+    bool operator==(const TextDcState&) const = default;
+};
+struct TextKeyView
+{
+    HGDIOBJ font;
+    TextDcState dc;
+    std::string_view text;
+};
+struct TextKey
+{
+    HGDIOBJ font;
+    TextDcState dc;
+    std::string text;
+};
+struct TextKeyHash
+{
+    using is_transparent = void;
+    size_t operator()(const TextKeyView& k) const
+    {
+        // FNV-1a over the bytes, seeded with the font handle and DC state.
+        uint64_t h = 14695981039346656037ull ^ (uint64_t)(uintptr_t)k.font;
+        h = (h ^ (uint64_t)(uint32_t)k.dc.dpi) * 1099511628211ull;
+        h = (h ^ (uint64_t)(uint32_t)k.dc.charExtra) * 1099511628211ull;
+        for (unsigned char c : k.text)
+            h = (h ^ c) * 1099511628211ull;
+        return (size_t)h;
+    }
+    size_t operator()(const TextKey& k) const { return (*this)(TextKeyView{ k.font, k.dc, k.text }); }
+};
+struct TextKeyEqual
+{
+    using is_transparent = void;
+    static TextKeyView view(const TextKeyView& k) { return k; }
+    static TextKeyView view(const TextKey& k) { return { k.font, k.dc, k.text }; }
+    template<typename A, typename B>
+    bool operator()(const A& a, const B& b) const
+    {
+        TextKeyView va = view(a), vb = view(b);
+        return va.font == vb.font && va.dc == vb.dc && va.text == vb.text;
+    }
+};
+// Fonts are forgotten from whichever thread deletes them.
+static std::mutex textExtentsLock;
+static std::unordered_map<TextKey, SIZE, TextKeyHash, TextKeyEqual> textExtents;
+
+bool measureTextCached(HDC hdc, const char* text, size_t len, SIZE* size)
+{
+    // Scaled or transformed DCs are rare enough to not be worth a key.
+    if (GetMapMode(hdc) != MM_TEXT || GetGraphicsMode(hdc) != GM_COMPATIBLE)
+        return GetTextExtentPoint32A(hdc, text, (int)len, size) != FALSE;
+    HGDIOBJ font = GetCurrentObject(hdc, OBJ_FONT);
+    TextDcState dc{ GetDeviceCaps(hdc, LOGPIXELSY), GetTextCharacterExtra(hdc) };
+    TextKeyView key{ font, dc, std::string_view(text, len) };
+    {
+        std::lock_guard<std::mutex> guard(textExtentsLock);
+        auto it = textExtents.find(key);
+        if (it != textExtents.end())
+        {
+            *size = it->second;
+            return true;
+        }
+    }
+    if (!GetTextExtentPoint32A(hdc, text, (int)len, size))
+        return false;
+    std::lock_guard<std::mutex> guard(textExtentsLock);
+    if (textExtents.size() >= TEXTMEASURE_LIMIT)
+        textExtents.clear();
+    textExtents.emplace(TextKey{ font, dc, std::string(text, len) }, *size);
+    return true;
+}
+// A deleted font handle can be handed out again for a different font.
+void textMeasureForgetFont(HGDIOBJ font)
+{
+    std::lock_guard<std::mutex> guard(textExtentsLock);
+    std::erase_if(textExtents, [font](const auto& entry) { return entry.first.font == font; });
+}
+
+// MeasureText(hdc, text) -> cx, cy
+Lua_Function(MeasureText)
+{
+    HDC hdc = luaL_wingetbycheckudata(L, 1, HDC);
+    size_t len;
+    const char* text = luaL_checklstring(L, 2, &len);
+    SIZE size;
+    if (!measureTextCached(hdc, text, len, &size))
+        return 0;
+    lua_pushinteger(L, size.cx);
+    lua_pushinteger(L, size.cy);
+    return 2;
+}
+// MeasureTextBatch(hdc, strings) -> IntArray of widths, tallest height
+Lua_Function(MeasureTextBatch)
+{
+    HDC hdc = luaL_wingetbycheckudata(L, 1, HDC);
+    luaL_checktype(L, 2, LUA_TTABLE);
+    size_t count = (size_t)luaL_len(L, 2);
+    IntArray* widths = newIntArray(L, count);
+    LONG height = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        lua_rawgeti(L, 2, (lua_Integer)i + 1);
+        size_t len;
+        const char* text = lua_tolstring(L, -1, &len);
+        SIZE size = { 0, 0 };
+        if (text)
+            measureTextCached(hdc, text, len, &size);
+        lua_pop(L, 1);
+        widths->values[i] = size.cx;
+        if (size.cy > height)
+            height = size.cy;
+    }
+    lua_pushinteger(L, height);
+    return 2;
+}
+Lua_Function(ClearTextMeasureCache)
+{
+    std::lock_guard<std::mutex> guard(textExtentsLock);
+    textExtents.clear();
+    return 0;
+}
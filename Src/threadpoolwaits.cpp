@@ -0,0 +1,59 @@
+// HandleWaitBackend over RegisterWaitForSingleObject, waking the owner with
+// an APC to its thread.
+static void CALLBACK threadPoolWaitFired(void* param, BOOLEAN timedOut)
+{
+    handleWaitFired((HandleWait*)param, timedOut != FALSE);
+}
+// The APC owns a reference to the wake. One still queued when the owning
+// thread exits is dropped by Windows with that small allocation.
+static void CALLBACK handleWakeApc(ULONG_PTR param)
+{
+    std::unique_ptr<std::shared_ptr<HandleWake>> wake((std::shared_ptr<HandleWake>*)param);
+    runHandleWake(*wake);
+}
+struct ThreadPoolWaitBackend : HandleWaitBackend
+{
+    bool openOwner(HandleWaits* w) override
+    {
+        return DuplicateHandle(GetCurrentProcess(), GetCurrentThread(), GetCurrentProcess(), &w->thread, 0, FALSE, DUPLICATE_SAME_ACCESS) != FALSE;
+    }
+    void closeOwner(HandleWaits* w) override
+    {
+        if (w->thread)
+            CloseHandle(w->thread);
+        w->thread = NULL;
+    }
+    bool duplicate(HandleWait* e, HANDLE h) override
+    {
+        return DuplicateHandle(GetCurrentProcess(), h, GetCurrentProcess(), &e->handle, 0, FALSE, DUPLICATE_SAME_ACCESS) != FALSE;
+    }
+    void closeDuplicate(HandleWait* e) override
+    {
+        DWORD error = GetLastError();
+        CloseHandle(e->handle);
+        e->handle = NULL;
+        SetLastError(error);
+    }
+    bool arm(HandleWait* e) override
+    {
+        return RegisterWaitForSingleObject(&e->wait, e->handle, threadPoolWaitFired, e, e->timeout, WT_EXECUTEONLYONCE) != FALSE;
+    }
+    void disarm(HandleWait* e) override
+    {
+        UnregisterWaitEx(e->wait, INVALID_HANDLE_VALUE);
+    }
+    void queueWake(HandleWaits* w, std::shared_ptr<HandleWake> wake) override
+    {
+        auto* param = new std::shared_ptr<HandleWake>(std::move(wake));
+        if (!QueueUserAPC(handleWakeApc, w->thread, (ULONG_PTR)param))
+        {
+            delete param;
+            w->wakeQueued = false;
+        }
+    }
+};
+HandleWaitBackend* threadPoolWaitBackend()
+{
+    static ThreadPoolWaitBackend backend;
+    return &backend;
+}
@@ -62,6 +62,15 @@ static TIMERPROCfn makeLambda(lua_State* L, int findex, UINT_PTR nIDEvent)
 		}
 		};
 }
+static bool releaseTimerProc(lua_State* L, UINT_PTR nIDEvent)
+{
+	auto it = timerproc_luarefs.find(nIDEvent);
+	if (it == timerproc_luarefs.end())
+		return true;
+	bool res = removeLWinProc(L, it->second, REGNAME);
+	timerproc_luarefs.erase(it);
+	return res;
+}
 Lua_Function(SetTimer)
 {
 	HWND hWnd = luaL_wingetbyudata(L, 1, HWND);
@@ -74,7 +83,14 @@ Lua_Function(SetTimer)
 		lpTimerFunc = trampoline;
 	}
 	UINT_PTR result = SetTimer(hWnd, nIDEvent, uElapse, lpTimerFunc);
-	timerproc_callbacks[result] = makeLambda(L, 4, result);
+	if (result) {
+		// Replacing the timer replaces its callback, Lua or not.
+		releaseTimerProc(L, result);
+		if (lpTimerFunc == trampoline)
+			timerproc_callbacks[result] = makeLambda(L, 4, result);
+		else
+			timerproc_callbacks.erase(result);
+	}
 	lua_pushinteger(L, (lua_Integer)result);
 	return 1;
 }
@@ -84,8 +100,93 @@ Lua_Function(KillTimer)
 	UINT_PTR nIDEvent = (UINT_PTR)luaL_checkinteger(L, 2);
 	bool res = KillTimer(hWnd, nIDEvent);
 	timerproc_callbacks.erase(nIDEvent);
-	bool res2 = removeLWinProc(L, timerproc_luarefs[nIDEvent], REGNAME);
-	timerproc_luarefs.erase(nIDEvent);
-	lua_pushboolean(L, res && res2);
+	lua_pushboolean(L, res && releaseTimerProc(L, nIDEvent));
+	return 1;
+}
+#define TIMERWHEELNAME "luibexwin.TimerWheel"
+static WaitableTimerWheel* checkTimerWheel(lua_State* L)
+{
+	return luaL_checkobject(L, 1, WaitableTimerWheel, TIMERWHEELNAME);
+}
+static int timerwheel_add(lua_State* L)
+{
+	WaitableTimerWheel* wheel = checkTimerWheel(L);
+	lua_Integer delay = luaL_checkinteger(L, 2);
+	lua_Integer period = luaL_optinteger(L, 3, 0);
+	uint64_t id = wheel->add(delay < 0 ? 0 : (uint64_t)delay, period < 0 ? 0 : (uint64_t)period);
+	wheel->arm();
+	lua_pushinteger(L, (lua_Integer)id);
+	return 1;
+}
+static int timerwheel_cancel(lua_State* L)
+{
+	WaitableTimerWheel* wheel = checkTimerWheel(L);
+	bool res = wheel->cancel((uint64_t)luaL_checkinteger(L, 2));
+	wheel->arm();
+	lua_pushboolean(L, res);
+	return 1;
+}
+// Every expired id goes into one table, reused when passed back in.
+static int timerwheel_poll(lua_State* L)
+{
+	WaitableTimerWheel* wheel = checkTimerWheel(L);
+	if (lua_istable(L, 2))
+		lua_settop(L, 2);
+	else
+	{
+		lua_settop(L, 1);
+		lua_newtable(L);
+	}
+	static thread_local std::vector<TimerWheel::Expired> fired;
+	fired.clear();
+	wheel->advance(TimerWheel::now(), fired);
+	wheel->arm();
+	lua_Integer n = (lua_Integer)fired.size();
+	for (lua_Integer i = 0; i < n; ++i)
+	{
+		lua_pushinteger(L, (lua_Integer)fired[(size_t)i].id);
+		lua_rawseti(L, 2, i + 1);
+	}
+	for (lua_Integer i = n + 1; lua_rawgeti(L, 2, i) != LUA_TNIL; ++i)
+	{
+		lua_pop(L, 1);
+		lua_pushnil(L);
+		lua_rawseti(L, 2, i);
+	}
+	lua_pop(L, 1);
+	lua_pushinteger(L, n);
+	return 2;
+}
+static int timerwheel_handle(lua_State* L)
+{
+	pushWindowStruct(L, HANDLE, checkTimerWheel(L)->handle());
+	return 1;
+}
+static int timerwheel_pending(lua_State* L)
+{
+	lua_pushinteger(L, (lua_Integer)checkTimerWheel(L)->size());
+	return 1;
+}
+static int timerwheel_nextdue(lua_State* L)
+{
+	uint64_t next = checkTimerWheel(L)->nextExpiry();
+	if (next == UINT64_MAX)
+		return 0;
+	uint64_t t = TimerWheel::now();
+	lua_pushinteger(L, next > t ? (lua_Integer)(next - t) : 0);
 	return 1;
-}
\ No newline at end of file
+}
+static const luaL_Reg timerwheel_methods[] = {
+	{"add", timerwheel_add},
+	{"cancel", timerwheel_cancel},
+	{"poll", timerwheel_poll},
+	{"handle", timerwheel_handle},
+	{"pending", timerwheel_pending},
+	{"nextDue", timerwheel_nextdue},
+	{NULL, NULL}
+};
+Lua_Function(CreateTimerWheel)
+{
+	newLuaObject<WaitableTimerWheel>(L, TIMERWHEELNAME, timerwheel_methods, nullptr);
+	return 1;
+}
@@ -0,0 +1,177 @@
+uint64_t TimerWheel::now()
+{
+    return (uint64_t)std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+TimerWheel::TimerWheel(uint64_t (*clock)())
+    : clock(clock)
+{
+    for (int32_t& head : heads)
+        head = -1;
+    for (uint64_t& mask : occupied)
+        mask = 0;
+    current = clock();
+}
+void TimerWheel::link(uint32_t index)
+{
+    Node& n = nodes[index];
+    uint64_t delta = n.expires > current ? n.expires - current : 0;
+    uint64_t e = current + delta;
+    int level = 0;
+    while (level < LEVELS - 1 && delta >= (1ull << (BITS * (level + 1))))
+        ++level;
+    if (delta >= (1ull << (BITS * LEVELS)))
+        e = current + (1ull << (BITS * LEVELS)) - 1;
+    int s = (int)((e >> (BITS * level)) & (SLOTS - 1));
+    int32_t slot = level * SLOTS + s;
+    n.slot = slot;
+    n.prev = -1;
+    n.next = heads[slot];
+    if (n.next >= 0)
+        nodes[n.next].prev = (int32_t)index;
+    heads[slot] = (int32_t)index;
+    occupied[level] |= 1ull << s;
+}
+void TimerWheel::unlink(uint32_t index)
+{
+    Node& n = nodes[index];
+    if (n.prev >= 0)
+        nodes[n.prev].next = n.next;
+    else
+        heads[n.slot] = n.next;
+    if (n.next >= 0)
+        nodes[n.next].prev = n.prev;
+    if (heads[n.slot] < 0)
+        occupied[n.slot / SLOTS] &= ~(1ull << (n.slot % SLOTS));
+    n.prev = n.next = n.slot = -1;
+}
+int32_t TimerWheel::detach(int slot)
+{
+    int32_t head = heads[slot];
+    heads[slot] = -1;
+    occupied[slot / SLOTS] &= ~(1ull << (slot % SLOTS));
+    return head;
+}
+void TimerWheel::release(uint32_t index)
+{
+    Node& n = nodes[index];
+    n.slot = -1;
+    ++n.generation;
+    freeNodes.push_back(index);
+    --active;
+}
+uint64_t TimerWheel::add(uint64_t delayMs, uint64_t periodMs, int64_t cookie)
+{
+    if (active == 0)
+        current = clock();
+    uint32_t index;
+    if (!freeNodes.empty())
+    {
+        index = freeNodes.back();
+        freeNodes.pop_back();
+    }
+    else
+    {
+        index = (uint32_t)nodes.size();
+        nodes.emplace_back();
+    }
+    Node& n = nodes[index];
+    n.expires = clock() + delayMs;
+    n.period = periodMs;
+    n.cookie = cookie;
+    ++active;
+    link(index);
+    return ((uint64_t)n.generation << 32) | index;
+}
+bool TimerWheel::cancel(uint64_t id)
+{
+    uint32_t index = (uint32_t)id;
+    if (index >= nodes.size())
+        return false;
+    Node& n = nodes[index];
+    if (n.generation != (uint32_t)(id >> 32) || n.slot < 0)
+        return false;
+    unlink(index);
+    release(index);
+    return true;
+}
+size_t TimerWheel::advance(uint64_t nowMs, std::vector<Expired>& fired)
+{
+    size_t count = 0;
+    while (current <= nowMs)
+    {
+        if (active == 0)
+        {
+            current = nowMs + 1;
+            break;
+        }
+        // Cascade from the highest level whose lower bits all wrapped.
+        int top = 0;
+        while (top < LEVELS - 1 && (current & ((1ull << (BITS * (top + 1))) - 1)) == 0)
+            ++top;
+        for (int level = top; level >= 1; --level)
+        {
+            int32_t i = detach(level * SLOTS + (int)((current >> (BITS * level)) & (SLOTS - 1)));
+            while (i >= 0)
+            {
+                int32_t next = nodes[i].next;
+                link((uint32_t)i);
+                i = next;
+            }
+        }
+        int32_t i = detach((int)(current & (SLOTS - 1)));
+        while (i >= 0)
+        {
+            int32_t next = nodes[i].next;
+            Node& n = nodes[i];
+            fired.push_back({ ((uint64_t)n.generation << 32) | (uint32_t)i, n.cookie });
+            ++count;
+            if (n.period)
+            {
+                n.expires += n.period;
+                if (n.expires <= current)
+                    n.expires = current + n.period;
+                link((uint32_t)i);
+            }
+            else
+            {
+                release((uint32_t)i);
+            }
+            i = next;
+        }
+        ++current;
+        // Nothing due at level 0, jump to the next boundary that can cascade.
+        if (occupied[0] == 0 && active > 0)
+        {
+            int level = 1;
+            while (level < LEVELS - 1 && occupied[level] == 0)
+                ++level;
+            uint64_t step = 1ull << (BITS * level);
+            uint64_t boundary = (current + step - 1) & ~(step - 1);
+            current = boundary < nowMs + 1 ? boundary : nowMs + 1;
+        }
+    }
+    return count;
+}
+// Exact for level 0, higher levels give the tick at which they cascade.
+uint64_t TimerWheel::nextExpiry() const
+{
+    if (active == 0)
+        return UINT64_MAX;
+    uint64_t next = UINT64_MAX;
+    if (occupied[0])
+        next = current + std::countr_zero(std::rotr(occupied[0], (int)(current & (SLOTS - 1))));
+    for (int level = 1; level < LEVELS; ++level)
+    {
+        if (!occupied[level])
+            continue;
+        // The current block still cascades if its boundary was not processed yet.
+        uint64_t block = current >> (BITS * level);
+        if (current & ((1ull << (BITS * level)) - 1))
+            ++block;
+        int k = std::countr_zero(std::rotr(occupied[level], (int)(block & (SLOTS - 1))));
+        uint64_t due = (block + k) << (BITS * level);
+        if (due < next)
+            next = due;
+    }
+    return next;
+}
@@ -0,0 +1,301 @@
+#define SNAPSHOTNAME "luibexwin.Snapshot"
+// Toolhelp snapshot kept as native columns sorted by the first one, Lua only
+// gets IntArray columns, single names or diffs when it asks for them.
+//   processes: pid, parent, threads, priority; name
+//   threads:   tid, pid, priority
+//   modules:   base, size, pid; name, path
+// Rows are the same entry in two snapshots when the first two columns and the
+// name match, so a reused pid with another parent or image counts as new.
+enum SnapshotKind
+{
+    SNAPSHOT_PROCESSES,
+    SNAPSHOT_THREADS,
+    SNAPSHOT_MODULES,
+};
+static const char* const snapshotKinds[] = { "processes", "threads", "modules", NULL };
+static const char* const snapshotColumns[][4] = {
+    { "pid", "parent", "threads", "priority" },
+    { "tid", "pid", "priority", NULL },
+    { "base", "size", "pid", NULL },
+};
+struct SnapshotRow
+{
+    lua_Integer values[4];
+    uint32_t name;
+    uint32_t path;
+};
+struct Snapshot
+{
+    SnapshotKind kind = SNAPSHOT_PROCESSES;
+    DWORD pid = 0;
+    std::vector<SnapshotRow> rows;
+    // Names and paths of every row, NUL separated.
+    std::string strings;
+};
+static Snapshot* checkSnapshot(lua_State* L, int idx)
+{
+    return luaL_checkobject(L, idx, Snapshot, SNAPSHOTNAME);
+}
+static uint32_t addSnapshotString(Snapshot* snap, const char* s)
+{
+    uint32_t offset = (uint32_t)snap->strings.size();
+    snap->strings.append(s);
+    snap->strings.push_back('\0');
+    return offset;
+}
+static bool sameSnapshotRow(const Snapshot* a, const SnapshotRow& x, const Snapshot* b, const SnapshotRow& y)
+{
+    if (x.values[0] != y.values[0] || x.values[1] != y.values[1])
+        return false;
+    if (a->kind == SNAPSHOT_THREADS)
+        return true;
+    return !strcmp(a->strings.c_str() + x.name, b->strings.c_str() + y.name);
+}
+// Refills snap. The rows are collected apart and swapped in, so on failure
+// snap keeps its previous rows and false is returned with the last error set.
+static bool takeSnapshot(Snapshot* snap)
+{
+    static const DWORD flags[] = { TH32CS_SNAPPROCESS, TH32CS_SNAPTHREAD, TH32CS_SNAPMODULE | TH32CS_SNAPMODULE32 };
+    HANDLE h = CreateToolhelp32Snapshot(flags[snap->kind], snap->kind == SNAPSHOT_MODULES ? snap->pid : 0);
+    // Modules of a process that is still starting fail with ERROR_BAD_LENGTH
+    // until its loader data is ready.
+    for (int retry = 0; h == INVALID_HANDLE_VALUE && GetLastError() == ERROR_BAD_LENGTH && retry < 8; ++retry)
+    {
+        Sleep(10);
+        h = CreateToolhelp32Snapshot(flags[snap->kind], snap->pid);
+    }
+    if (h == INVALID_HANDLE_VALUE)
+        return false;
+    Snapshot next;
+    next.kind = snap->kind;
+    next.pid = snap->pid;
+    next.rows.reserve(snap->rows.size());
+    next.strings.reserve(snap->strings.size());
+    SnapshotRow row = {};
+    switch (snap->kind)
+    {
+    case SNAPSHOT_PROCESSES:
+    {
+        PROCESSENTRY32 e = { sizeof(e) };
+        for (BOOL ok = Process32First(h, &e); ok; ok = Process32Next(h, &e))
+        {
+            row.values[0] = e.th32ProcessID;
+            row.values[1] = e.th32ParentProcessID;
+            row.values[2] = e.cntThreads;
+            row.values[3] = e.pcPriClassBase;
+            row.name = addSnapshotString(&next, e.szExeFile);
+            next.rows.push_back(row);
+        }
+        break;
+    }
+    case SNAPSHOT_THREADS:
+    {
+        THREADENTRY32 e = { sizeof(e) };
+        for (BOOL ok = Thread32First(h, &e); ok; ok = Thread32Next(h, &e))
+        {
+            if (next.pid && e.th32OwnerProcessID != next.pid)
+                continue;
+            row.values[0] = e.th32ThreadID;
+            row.values[1] = e.th32OwnerProcessID;
+            row.values[2] = e.tpBasePri;
+            next.rows.push_back(row);
+        }
+        break;
+    }
+    case SNAPSHOT_MODULES:
+    {
+        MODULEENTRY32 e = { sizeof(e) };
+        for (BOOL ok = Module32First(h, &e); ok; ok = Module32Next(h, &e))
+        {
+            row.values[0] = (lua_Integer)(uintptr_t)e.modBaseAddr;
+            row.values[1] = e.modBaseSize;
+            row.values[2] = e.th32ProcessID;
+            row.name = addSnapshotString(&next, e.szModule);
+            row.path = addSnapshotString(&next, e.szExePath);
+            next.rows.push_back(row);
+        }
+        break;
+    }
+    }
+    CloseHandle(h);
+    std::sort(next.rows.begin(), next.rows.end(), [](const SnapshotRow& a, const SnapshotRow& b) {
+        return a.values[0] < b.values[0];
+    });
+    snap->rows.swap(next.rows);
+    snap->strings.swap(next.strings);
+    return true;
+}
+static int checkSnapshotColumn(lua_State* L, const Snapshot* snap, int idx)
+{
+    const char* name = luaL_checkstring(L, idx);
+    for (int i = 0; i < 4 && snapshotColumns[snap->kind][i]; ++i)
+        if (!strcmp(name, snapshotColumns[snap->kind][i]))
+            return i;
+    return luaL_argerror(L, idx, lua_pushfstring(L, "no column '%s' in a %s snapshot", name, snapshotKinds[snap->kind]));
+}
+static size_t checkSnapshotRow(lua_State* L, const Snapshot* snap, int idx)
+{
+    lua_Integer i = luaL_checkinteger(L, idx);
+    luaL_argcheck(L, i >= 1 && (size_t)i <= snap->rows.size(), idx, "row out of range");
+    return (size_t)i - 1;
+}
+// snap:count() -> number of rows
+static int snapshot_count(lua_State* L)
+{
+    lua_pushinteger(L, (lua_Integer)checkSnapshot(L, 1)->rows.size());
+    return 1;
+}
+// snap:kind() -> "processes", "threads" or "modules"
+static int snapshot_kind(lua_State* L)
+{
+    lua_pushstring(L, snapshotKinds[checkSnapshot(L, 1)->kind]);
+    return 1;
+}
+// snap:column(name) -> IntArray of that column, in row order
+static int snapshot_column(lua_State* L)
+{
+    Snapshot* snap = checkSnapshot(L, 1);
+    int column = checkSnapshotColumn(L, snap, 2);
+    IntArray* out = newIntArray(L, snap->rows.size());
+    for (size_t i = 0; i < snap->rows.size(); ++i)
+        out->values[i] = snap->rows[i].values[column];
+    return 1;
+}
+// snap:get(row, column) -> value
+static int snapshot_get(lua_State* L)
+{
+    Snapshot* snap = checkSnapshot(L, 1);
+    size_t row = checkSnapshotRow(L, snap, 2);
+    int column = checkSnapshotColumn(L, snap, 3);
+    lua_pushinteger(L, snap->rows[row].values[column]);
+    return 1;
+}
+// snap:name(row) / snap:path(row) -> image or module name, module path
+static int snapshot_name(lua_State* L)
+{
+    Snapshot* snap = checkSnapshot(L, 1);
+    size_t row = checkSnapshotRow(L, snap, 2);
+    if (snap->kind == SNAPSHOT_THREADS)
+        return 0;
+    lua_pushstring(L, snap->strings.c_str() + snap->rows[row].name);
+    return 1;
+}
+static int snapshot_path(lua_State* L)
+{
+    Snapshot* snap = checkSnapshot(L, 1);
+    size_t row = checkSnapshotRow(L, snap, 2);
+    if (snap->kind != SNAPSHOT_MODULES)
+        return 0;
+    lua_pushstring(L, snap->strings.c_str() + snap->rows[row].path);
+    return 1;
+}
+// snap:names() -> { name, ... } in row order
+static int snapshot_names(lua_State* L)
+{
+    Snapshot* snap = checkSnapshot(L, 1);
+    if (snap->kind == SNAPSHOT_THREADS)
+        return 0;
+    lua_createtable(L, (int)snap->rows.size(), 0);
+    for (size_t i = 0; i < snap->rows.size(); ++i)
+    {
+        lua_pushstring(L, snap->strings.c_str() + snap->rows[i].name);
+        lua_rawseti(L, -2, (lua_Integer)i + 1);
+    }
+    return 1;
+}
+// snap:find(key) -> row whose first column is key (pid, tid or base), or nil
+static int snapshot_find(lua_State* L)
+{
+    Snapshot* snap = checkSnapshot(L, 1);
+    lua_Integer key = luaL_checkinteger(L, 2);
+    auto it = std::lower_bound(snap->rows.begin(), snap->rows.end(), key, [](const SnapshotRow& r, lua_Integer k) {
+        return r.values[0] < k;
+    });
+    if (it == snap->rows.end() || it->values[0] != key)
+        return 0;
+    lua_pushinteger(L, (lua_Integer)(it - snap->rows.begin()) + 1);
+    return 1;
+}
+// snap:refresh() -> true, or false and the error code. Takes the snapshot
+// again, a failed refresh keeps the previous rows.
+static int snapshot_refresh(lua_State* L)
+{
+    Snapshot* snap = checkSnapshot(L, 1);
+    bool ok = takeSnapshot(snap);
+    lua_pushboolean(L, ok);
+    if (ok)
+        return 1;
+    lua_pushinteger(L, (lua_Integer)GetLastError());
+    return 2;
+}
+static int snapshot_len(lua_State* L)
+{
+    return snapshot_count(L);
+}
+static const luaL_Reg snapshot_methods[] = {
+    {"count", snapshot_count},
+    {"kind", snapshot_kind},
+    {"column", snapshot_column},
+    {"get", snapshot_get},
+    {"name", snapshot_name},
+    {"path", snapshot_path},
+    {"names", snapshot_names},
+    {"find", snapshot_find},
+    {"refresh", snapshot_refresh},
+    {NULL, NULL}
+};
+static const luaL_Reg snapshot_metamethods[] = {
+    {"__len", snapshot_len},
+    {NULL, NULL}
+};
+// CreateSnapshot("processes" | "threads" | "modules" [, pid]) -> Snapshot or
+// nil, error code. pid selects the process of a module snapshot (0 is the
+// current one) and filters a thread snapshot.
+Lua_Function(CreateSnapshot)
+{
+    SnapshotKind kind = (SnapshotKind)luaL_checkoption(L, 1, "processes", snapshotKinds);
+    DWORD pid = (DWORD)luaL_optinteger(L, 2, 0);
+    Snapshot* snap = newLuaObject<Snapshot>(L, SNAPSHOTNAME, snapshot_methods, snapshot_metamethods);
+    snap->kind = kind;
+    snap->pid = pid;
+    if (!takeSnapshot(snap))
+    {
+        lua_pushnil(L);
+        lua_pushinteger(L, (lua_Integer)GetLastError());
+        return 2;
+    }
+    return 1;
+}
+// DiffSnapshots(old, new) -> started, ended: IntArrays of rows in new that
+// are not in old and rows of old missing from new. Both snapshots are sorted
+// so this is one merge pass.
+Lua_Function(DiffSnapshots)
+{
+    Snapshot* a = checkSnapshot(L, 1);
+    Snapshot* b = checkSnapshot(L, 2);
+    luaL_argcheck(L, a->kind == b->kind, 2, "snapshots of different kinds");
+    std::vector<lua_Integer> started, ended;
+    size_t i = 0, j = 0;
+    while (i < a->rows.size() || j < b->rows.size())
+    {
+        if (j == b->rows.size() || (i < a->rows.size() && a->rows[i].values[0] < b->rows[j].values[0]))
+            ended.push_back((lua_Integer)++i);
+        else if (i == a->rows.size() || b->rows[j].values[0] < a->rows[i].values[0])
+            started.push_back((lua_Integer)++j);
+        else
+        {
+            if (!sameSnapshotRow(a, a->rows[i], b, b->rows[j]))
+            {
+                ended.push_back((lua_Integer)i + 1);
+                started.push_back((lua_Integer)j + 1);
+            }
+            ++i;
+            ++j;
+        }
+    }
+    IntArray* out = newIntArray(L, started.size());
+    std::copy(started.begin(), started.end(), out->values);
+    out = newIntArray(L, ended.size());
+    std::copy(ended.begin(), ended.end(), out->values);
+    return 2;
+}
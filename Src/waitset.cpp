@@ -0,0 +1,336 @@
+#define WAITSETNAME "luibexwin.WaitSet"
+// Any number of waitable handles watched through the HandleWaits core, see
+// handlewaits.h, so nothing polls and no slot limit applies. The APC on the
+// thread that created the set posts one scheduler task that drains it.
+// Everything else, Lua included, runs on that thread.
+struct WaitEntry
+{
+    std::unique_ptr<HandleWait> wait;
+    bool repeat = false;
+    // Reported and waiting for set:rearm(id).
+    bool parked = false;
+};
+struct WaitSet
+{
+    HandleWaits waits;
+    std::unordered_map<lua_Integer, WaitEntry> entries;
+    std::vector<HandleWait*> fired;
+    // Entries that can still fire, parked ones do not count.
+    size_t armed = 0;
+    Scheduler* scheduler = nullptr;
+    int selfRef = LUA_NOREF;
+    lua_Integer nextId = 1;
+    lua_Integer completion = 0;
+    // Drained but not yet delivered: id and whether it was signaled.
+    std::vector<std::pair<lua_Integer, bool>> ready;
+    bool taskQueued = false;
+    bool closing = false;
+    ~WaitSet();
+};
+static WaitSet* checkWaitSet(lua_State* L, int idx)
+{
+    return luaL_checkobject(L, idx, WaitSet, WAITSETNAME);
+}
+static void deliverWaitSet(lua_State* L, WaitSet* set);
+// onWake of the HandleWaits, runs in its APC.
+static void wakeWaitSet(void* param)
+{
+    WaitSet* set = (WaitSet*)param;
+    if (set->closing || set->taskQueued)
+        return;
+    set->taskQueued = true;
+    postSchedulerTask(set->scheduler, [set](lua_State* L) {
+        set->taskQueued = false;
+        deliverWaitSet(L, set);
+    });
+}
+// Moves what the pool queued to set->ready, oldest first. One-shot entries
+// are closed, repeating ones stay disarmed until set:rearm(id), so a handle
+// that stays signaled is reported once per rearm instead of in a busy loop.
+static void drainWaitSet(WaitSet* set)
+{
+    drainHandleWaits(&set->waits, set->fired);
+    for (HandleWait* w : set->fired)
+    {
+        lua_Integer id = (lua_Integer)w->cookie;
+        set->ready.emplace_back(id, !w->timedOut);
+        auto it = set->entries.find(id);
+        --set->armed;
+        if (it->second.repeat)
+            it->second.parked = true;
+        else
+        {
+            closeHandleWait(&set->waits, std::move(it->second.wait));
+            set->entries.erase(it);
+        }
+    }
+    set->fired.clear();
+}
+// Anchored in the registry, counting as scheduler work, while an entry is
+// armed or a wake is on its way. Parked entries do not keep RunScheduler up.
+static void updateWaitSetAnchor(lua_State* L, WaitSet* set, int idx)
+{
+    bool busy = set->armed || set->taskQueued || set->waits.wakeQueued;
+    if (busy && set->selfRef == LUA_NOREF)
+    {
+        lua_pushvalue(L, idx);
+        set->selfRef = luaL_ref(L, LUA_REGISTRYINDEX);
+        addSchedulerWork(set->scheduler, 1);
+    }
+    else if (!busy && set->selfRef != LUA_NOREF)
+    {
+        luaL_unref(L, LUA_REGISTRYINDEX, set->selfRef);
+        set->selfRef = LUA_NOREF;
+        addSchedulerWork(set->scheduler, -1);
+    }
+}
+// signaled, timedOut: IntArrays of ids, set->ready is left as is.
+static void pushWaitResults(lua_State* L, const WaitSet* set)
+{
+    size_t signaled = 0;
+    for (const auto& r : set->ready)
+        signaled += r.second;
+    IntArray* hits = newIntArray(L, signaled);
+    IntArray* misses = newIntArray(L, set->ready.size() - signaled);
+    size_t h = 0, m = 0;
+    for (const auto& r : set->ready)
+    {
+        if (r.second)
+            hits->values[h++] = r.first;
+        else
+            misses->values[m++] = r.first;
+    }
+}
+// The batch goes to onSignal(set, signaled, timedOut) and to coroutines in
+// set:await(), with neither it is kept for set:poll().
+static void deliverWaitSet(lua_State* L, WaitSet* set)
+{
+    drainWaitSet(set);
+    lua_rawgeti(L, LUA_REGISTRYINDEX, set->selfRef);
+    int self = lua_gettop(L);
+    if (!set->ready.empty())
+    {
+        pushWaitResults(L, set);
+        int results = self + 1;
+        lua_pushvalue(L, results);
+        lua_pushvalue(L, results + 1);
+        int woken = signalSchedulerCompletion(L, set->scheduler, set->completion, 2);
+        lua_getuservalue(L, self);
+        lua_getfield(L, -1, "onSignal");
+        bool hasCallback = lua_isfunction(L, -1);
+        if (hasCallback || woken)
+            set->ready.clear();
+        if (hasCallback)
+        {
+            lua_pushvalue(L, self);
+            lua_pushvalue(L, results);
+            lua_pushvalue(L, results + 1);
+            if (lua_pcall(L, 3, 0, 0) != LUA_OK)
+                reportSchedulerError(L, "WaitSet onSignal");
+        }
+    }
+    updateWaitSetAnchor(L, set, self);
+    lua_settop(L, self - 1);
+}
+// Safe on any thread, a wake still queued finds the set gone.
+static void closeWaitSet(WaitSet* set)
+{
+    set->closing = true;
+    for (auto& entry : set->entries)
+        closeHandleWait(&set->waits, std::move(entry.second.wait));
+    set->entries.clear();
+    set->armed = 0;
+    closeHandleWaits(&set->waits);
+    set->ready.clear();
+}
+WaitSet::~WaitSet()
+{
+    closeWaitSet(this);
+}
+// set:add(handle [, ms [, repeat]]) -> id, or nil and the error code. The
+// handle is duplicated, the caller may close its own. ms bounds the wait (the
+// id is reported as timed out). A repeating entry stays registered after a
+// report but is only watched again after set:rearm(id).
+static int waitset_add(lua_State* L)
+{
+    WaitSet* set = checkWaitSet(L, 1);
+    HANDLE h = luaL_wingetbycheckudata(L, 2, HANDLE);
+    lua_Integer ms = luaL_optinteger(L, 3, -1);
+    bool repeat = lua_toboolean(L, 4);
+    if (set->closing)
+        return luaL_error(L, "WaitSet is closed");
+    lua_Integer id = set->nextId;
+    std::unique_ptr<HandleWait> wait = openHandleWait(&set->waits, h, ms < 0 ? INFINITE : (DWORD)ms, (uintptr_t)id);
+    if (!wait)
+    {
+        lua_pushnil(L);
+        lua_pushinteger(L, (lua_Integer)GetLastError());
+        return 2;
+    }
+    ++set->nextId;
+    WaitEntry& e = set->entries[id];
+    e.wait = std::move(wait);
+    e.repeat = repeat;
+    ++set->armed;
+    updateWaitSetAnchor(L, set, 1);
+    lua_pushinteger(L, id);
+    return 1;
+}
+// set:rearm(id) -> true, or false and the error code. Watches a reported
+// repeating entry again, true as well when it is still armed.
+static int waitset_rearm(lua_State* L)
+{
+    WaitSet* set = checkWaitSet(L, 1);
+    lua_Integer id = luaL_checkinteger(L, 2);
+    auto it = set->entries.find(id);
+    luaL_argcheck(L, it != set->entries.end(), 2, "no such entry");
+    WaitEntry& e = it->second;
+    if (e.parked)
+    {
+        if (!armHandleWait(e.wait.get()))
+        {
+            lua_pushboolean(L, 0);
+            lua_pushinteger(L, (lua_Integer)GetLastError());
+            return 2;
+        }
+        e.parked = false;
+        ++set->armed;
+        updateWaitSetAnchor(L, set, 1);
+    }
+    lua_pushboolean(L, 1);
+    return 1;
+}
+// set:remove(id) -> true if id was registered. It is not reported afterwards.
+static int waitset_remove(lua_State* L)
+{
+    WaitSet* set = checkWaitSet(L, 1);
+    lua_Integer id = luaL_checkinteger(L, 2);
+    auto it = set->entries.find(id);
+    if (it == set->entries.end())
+    {
+        lua_pushboolean(L, 0);
+        return 1;
+    }
+    if (!it->second.parked)
+        --set->armed;
+    // It may already be queued, the drain skips and frees it.
+    closeHandleWait(&set->waits, std::move(it->second.wait));
+    set->entries.erase(it);
+    updateWaitSetAnchor(L, set, 1);
+    lua_pushboolean(L, 1);
+    return 1;
+}
+// set:poll() -> signaled, timedOut: IntArrays of the ids reported since the
+// last poll, without blocking.
+static int waitset_poll(lua_State* L)
+{
+    WaitSet* set = checkWaitSet(L, 1);
+    drainWaitSet(set);
+    pushWaitResults(L, set);
+    set->ready.clear();
+    updateWaitSetAnchor(L, set, 1);
+    return 2;
+}
+// set:wait([ms]) -> as poll, blocking in an alertable wait until something is
+// reported or ms elapsed. Pending scheduler tasks run first, as for
+// Process:wait, so with onSignal the callback gets the batch instead.
+static int waitset_wait(lua_State* L)
+{
+    WaitSet* set = checkWaitSet(L, 1);
+    lua_Integer ms = luaL_optinteger(L, 2, -1);
+    uint64_t deadline = TimerWheel::now() + (uint64_t)(ms < 0 ? 0 : ms);
+    while (set->ready.empty() && !handleWaitsPending(&set->waits) && set->armed)
+    {
+        uint64_t now = TimerWheel::now();
+        if (ms >= 0 && now >= deadline)
+            break;
+        SleepEx(ms < 0 ? INFINITE : (DWORD)(deadline - now), TRUE);
+    }
+    runSchedulerTasks(L, set->scheduler);
+    lua_settop(L, 1);
+    return waitset_poll(L);
+}
+// set:await() -> signaled, timedOut, from a scheduler coroutine. Returns at
+// once when something is already reported or nothing is armed.
+static int waitset_await(lua_State* L)
+{
+    WaitSet* set = checkWaitSet(L, 1);
+    drainWaitSet(set);
+    if (!set->ready.empty() || !set->armed)
+    {
+        lua_settop(L, 1);
+        return waitset_poll(L);
+    }
+    lua_settop(L, 0);
+    lua_pushinteger(L, set->completion);
+    return ll_AwaitCompletion(L);
+}
+// set:count() -> number of registered handles, parked ones included
+static int waitset_count(lua_State* L)
+{
+    lua_pushinteger(L, (lua_Integer)checkWaitSet(L, 1)->entries.size());
+    return 1;
+}
+// set:close() unregisters every handle, unreported signals are dropped.
+static int waitset_close(lua_State* L)
+{
+    WaitSet* set = checkWaitSet(L, 1);
+    if (set->closing)
+        return 0;
+    closeWaitSet(set);
+    updateWaitSetAnchor(L, set, 1);
+    return 0;
+}
+static int waitset_len(lua_State* L)
+{
+    return waitset_count(L);
+}
+static const luaL_Reg waitset_methods[] = {
+    {"add", waitset_add},
+    {"rearm", waitset_rearm},
+    {"remove", waitset_remove},
+    {"poll", waitset_poll},
+    {"wait", waitset_wait},
+    {"await", waitset_await},
+    {"count", waitset_count},
+    {"close", waitset_close},
+    {NULL, NULL}
+};
+static const luaL_Reg waitset_metamethods[] = {
+    {"__len", waitset_len},
+    {NULL, NULL}
+};
+// CreateWaitSet([options]) -> WaitSet, or nil and the error code
+// options: onSignal(set, signaled, timedOut) called with IntArrays of ids, and
+// completion, a key for AwaitCompletion resumed with the same arrays. The set
+// belongs to the calling thread, which must wait alertably (RunScheduler,
+// SleepEx(ms, true), set:wait) for reports to arrive.
+Lua_Function(CreateWaitSet)
+{
+    bool hasOptions = !lua_isnoneornil(L, 1);
+    if (hasOptions)
+        luaL_checktype(L, 1, LUA_TTABLE);
+    // Created first so it is finalized after every set on lua_close.
+    Scheduler* scheduler = getScheduler(L);
+    WaitSet* set = newLuaObject<WaitSet>(L, WAITSETNAME, waitset_methods, waitset_metamethods);
+    int self = lua_gettop(L);
+    set->scheduler = scheduler;
+    set->completion = (lua_Integer)(intptr_t)set;
+    lua_createtable(L, 0, 1);
+    if (hasOptions)
+    {
+        lua_getfield(L, 1, "completion");
+        set->completion = luaL_optinteger(L, -1, set->completion);
+        lua_pop(L, 1);
+        lua_getfield(L, 1, "onSignal");
+        lua_setfield(L, self + 1, "onSignal");
+    }
+    lua_setuservalue(L, self);
+    if (!openHandleWaits(&set->waits, threadPoolWaitBackend(), wakeWaitSet, set))
+    {
+        lua_pushnil(L);
+        lua_pushinteger(L, (lua_Integer)GetLastError());
+        return 2;
+    }
+    return 1;
+}
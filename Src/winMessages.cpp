@@ -61,8 +61,9 @@ static std::function<LRESULT(HWND, UINT, WPARAM, LPARAM)> MakeLambda(lua_State*
             unsigned long err = 0;
             bool islOk = safeCall(L, islExcept, err);
             if (islExcept) {
+                const char* name = luaConstantName("WM_", msg);
                 lua_getglobal(L, "print");
-                lua_pushfstring(L, "Exception 0x%d in WindowProc.", err);
+                lua_pushfstring(L, "Exception 0x%d in WindowProc handling %s.", err, name ? name : "a custom message");
                 lua_call(L, 1, 0);
                 return DefWindowProc(hwnd, msg, wp, lp);
             }
@@ -162,7 +163,14 @@ static void table_to_wndclassexa(lua_State* L, int index, WNDCLASSEXA* wc)
 
     lua_getfield(L, index, "hbrBackground");
     if (lua_isuserdata(L, -1))
+    {
+        // The class owns its background brush and deletes it when unregistered,
+        // a shared cached brush is copied instead.
         wc->hbrBackground = (HBRUSH)lua_touserdata(L, -1);
+        LOGBRUSH lb;
+        if (gdiCacheOwns(wc->hbrBackground) && GetObjectA(wc->hbrBackground, sizeof(lb), &lb))
+            wc->hbrBackground = CreateBrushIndirect(&lb);
+    }
     else if (lua_isinteger(L, -1)) {
         wc->hbrBackground = (HBRUSH)lua_tointeger(L, -1);
     }
@@ -396,277 +404,4 @@ Lua_Function(PostMessage)
     BOOL res = PostMessageA(hWnd, Msg, wParam, lParam);
     lua_pushboolean(L, res);
     return 1;
-}
-void register_all_wm_messages(lua_State* L) {
-    REGIMACRO(WM_NULL)
-        REGIMACRO(WM_CREATE)
-        REGIMACRO(WM_DESTROY)
-        REGIMACRO(WM_MOVE)
-        REGIMACRO(WM_SIZE)
-        REGIMACRO(WM_ACTIVATE)
-        REGIMACRO(WM_SETFOCUS)
-        REGIMACRO(WM_KILLFOCUS)
-        REGIMACRO(WM_ENABLE)
-        REGIMACRO(WM_SETREDRAW)
-        REGIMACRO(WM_SETTEXT)
-        REGIMACRO(WM_GETTEXT)
-        REGIMACRO(WM_GETTEXTLENGTH)
-        REGIMACRO(WM_PAINT)
-        REGIMACRO(WM_CLOSE)
-        REGIMACRO(WM_QUERYENDSESSION)
-        REGIMACRO(WM_QUIT)
-        REGIMACRO(WM_QUERYOPEN)
-        REGIMACRO(WM_ERASEBKGND)
-        REGIMACRO(WM_SYSCOLORCHANGE)
-        REGIMACRO(WM_ENDSESSION)
-        REGIMACRO(WM_SHOWWINDOW)
-        REGIMACRO(WM_WININICHANGE)
-        REGIMACRO(WM_SETTINGCHANGE)
-        REGIMACRO(WM_DEVMODECHANGE)
-        REGIMACRO(WM_ACTIVATEAPP)
-        REGIMACRO(WM_FONTCHANGE)
-        REGIMACRO(WM_TIMECHANGE)
-        REGIMACRO(WM_CANCELMODE)
-        REGIMACRO(WM_SETCURSOR)
-        REGIMACRO(WM_MOUSEACTIVATE)
-        REGIMACRO(WM_CHILDACTIVATE)
-        REGIMACRO(WM_QUEUESYNC)
-        REGIMACRO(WM_GETMINMAXINFO)
-        REGIMACRO(WM_PAINTICON)
-        REGIMACRO(WM_ICONERASEBKGND)
-        REGIMACRO(WM_NEXTDLGCTL)
-        REGIMACRO(WM_SPOOLERSTATUS)
-        REGIMACRO(WM_DRAWITEM)
-        REGIMACRO(WM_MEASUREITEM)
-        REGIMACRO(WM_DELETEITEM)
-        REGIMACRO(WM_VKEYTOITEM)
-        REGIMACRO(WM_CHARTOITEM)
-        REGIMACRO(WM_SETFONT)
-        REGIMACRO(WM_GETFONT)
-        REGIMACRO(WM_SETHOTKEY)
-        REGIMACRO(WM_GETHOTKEY)
-        REGIMACRO(WM_QUERYDRAGICON)
-        REGIMACRO(WM_COMPAREITEM)
-        REGIMACRO(WM_GETOBJECT)
-        REGIMACRO(WM_COMPACTING)
-        REGIMACRO(WM_COMMNOTIFY)
-        REGIMACRO(WM_WINDOWPOSCHANGING)
-        REGIMACRO(WM_WINDOWPOSCHANGED)
-        REGIMACRO(WM_POWER)
-        REGIMACRO(WM_COPYDATA)
-        REGIMACRO(WM_CANCELJOURNAL)
-        REGIMACRO(WM_NOTIFY)
-        REGIMACRO(WM_INPUTLANGCHANGEREQUEST)
-        REGIMACRO(WM_INPUTLANGCHANGE)
-        REGIMACRO(WM_TCARD)
-        REGIMACRO(WM_HELP)
-        REGIMACRO(WM_USERCHANGED)
-        REGIMACRO(WM_NOTIFYFORMAT)
-        REGIMACRO(WM_CONTEXTMENU)
-        REGIMACRO(WM_STYLECHANGING)
-        REGIMACRO(WM_STYLECHANGED)
-        REGIMACRO(WM_DISPLAYCHANGE)
-        REGIMACRO(WM_GETICON)
-        REGIMACRO(WM_SETICON)
-        REGIMACRO(WM_NCCREATE)
-        REGIMACRO(WM_NCDESTROY)
-        REGIMACRO(WM_NCCALCSIZE)
-        REGIMACRO(WM_NCHITTEST)
-        REGIMACRO(WM_NCPAINT)
-        REGIMACRO(WM_NCACTIVATE)
-        REGIMACRO(WM_GETDLGCODE)
-        REGIMACRO(WM_SYNCPAINT)
-        REGIMACRO(WM_NCMOUSEMOVE)
-        REGIMACRO(WM_NCLBUTTONDOWN)
-        REGIMACRO(WM_NCLBUTTONUP)
-        REGIMACRO(WM_NCLBUTTONDBLCLK)
-        REGIMACRO(WM_NCRBUTTONDOWN)
-        REGIMACRO(WM_NCRBUTTONUP)
-        REGIMACRO(WM_NCRBUTTONDBLCLK)
-        REGIMACRO(WM_NCMBUTTONDOWN)
-        REGIMACRO(WM_NCMBUTTONUP)
-        REGIMACRO(WM_NCMBUTTONDBLCLK)
-        REGIMACRO(WM_KEYDOWN)
-        REGIMACRO(WM_KEYUP)
-        REGIMACRO(WM_CHAR)
-        REGIMACRO(WM_DEADCHAR)
-        REGIMACRO(WM_SYSKEYDOWN)
-        REGIMACRO(WM_SYSKEYUP)
-        REGIMACRO(WM_SYSCHAR)
-        REGIMACRO(WM_SYSDEADCHAR)
-        REGIMACRO(WM_UNICHAR)
-        REGIMACRO(WM_IME_STARTCOMPOSITION)
-        REGIMACRO(WM_IME_ENDCOMPOSITION)
-        REGIMACRO(WM_IME_COMPOSITION)
-        REGIMACRO(WM_IME_KEYLAST)
-        REGIMACRO(WM_INITDIALOG)
-        REGIMACRO(WM_COMMAND)
-        REGIMACRO(WM_SYSCOMMAND)
-        REGIMACRO(WM_TIMER)
-        REGIMACRO(WM_HSCROLL)
-        REGIMACRO(WM_VSCROLL)
-        REGIMACRO(WM_INITMENU)
-        REGIMACRO(WM_INITMENUPOPUP)
-        REGIMACRO(WM_MENUSELECT)
-        REGIMACRO(WM_MENUCHAR)
-        REGIMACRO(WM_ENTERIDLE)
-        REGIMACRO(WM_MENURBUTTONUP)
-        REGIMACRO(WM_MENUDRAG)
-        REGIMACRO(WM_MENUGETOBJECT)
-        REGIMACRO(WM_UNINITMENUPOPUP)
-        REGIMACRO(WM_MENUCOMMAND)
-        REGIMACRO(WM_CHANGEUISTATE)
-        REGIMACRO(WM_UPDATEUISTATE)
-        REGIMACRO(WM_QUERYUISTATE)
-        REGIMACRO(WM_CTLCOLORMSGBOX)
-        REGIMACRO(WM_CTLCOLOREDIT)
-        REGIMACRO(WM_CTLCOLORLISTBOX)
-        REGIMACRO(WM_CTLCOLORBTN)
-        REGIMACRO(WM_CTLCOLORDLG)
-        REGIMACRO(WM_CTLCOLORSCROLLBAR)
-        REGIMACRO(WM_CTLCOLORSTATIC)
-        REGIMACRO(WM_MOUSEMOVE)
-        REGIMACRO(WM_LBUTTONDOWN)
-        REGIMACRO(WM_LBUTTONUP)
-        REGIMACRO(WM_LBUTTONDBLCLK)
-        REGIMACRO(WM_RBUTTONDOWN)
-        REGIMACRO(WM_RBUTTONUP)
-        REGIMACRO(WM_RBUTTONDBLCLK)
-        REGIMACRO(WM_MBUTTONDOWN)
-        REGIMACRO(WM_MBUTTONUP)
-        REGIMACRO(WM_MBUTTONDBLCLK)
-        REGIMACRO(WM_MOUSEWHEEL)
-        REGIMACRO(WM_XBUTTONDOWN)
-        REGIMACRO(WM_XBUTTONUP)
-        REGIMACRO(WM_PARENTNOTIFY)
-        REGIMACRO(WM_ENTERMENULOOP)
-        REGIMACRO(WM_EXITMENULOOP)
-        REGIMACRO(WM_NEXTMENU)
-        REGIMACRO(WM_SIZING)
-        REGIMACRO(WM_CAPTURECHANGED)
-        REGIMACRO(WM_MOVING)
-        REGIMACRO(WM_POWERBROADCAST)
-        REGIMACRO(WM_DEVICECHANGE)
-        REGIMACRO(WM_MDICREATE)
-        REGIMACRO(WM_MDIDESTROY)
-        REGIMACRO(WM_MDIACTIVATE)
-        REGIMACRO(WM_MDIRESTORE)
-        REGIMACRO(WM_MDINEXT)
-        REGIMACRO(WM_MDIMAXIMIZE)
-        REGIMACRO(WM_MDITILE)
-        REGIMACRO(WM_MDICASCADE)
-        REGIMACRO(WM_MDIICONARRANGE)
-        REGIMACRO(WM_MDIGETACTIVE)
-        REGIMACRO(WM_MDISETMENU)
-        REGIMACRO(WM_ENTERSIZEMOVE)
-        REGIMACRO(WM_EXITSIZEMOVE)
-        REGIMACRO(WM_DROPFILES)
-        REGIMACRO(WM_MDIREFRESHMENU)
-        REGIMACRO(WM_IME_SETCONTEXT)
-        REGIMACRO(WM_IME_NOTIFY)
-        REGIMACRO(WM_IME_CONTROL)
-        REGIMACRO(WM_IME_COMPOSITIONFULL)
-        REGIMACRO(WM_IME_SELECT)
-        REGIMACRO(WM_IME_CHAR)
-        REGIMACRO(WM_IME_REQUEST)
-        REGIMACRO(WM_IME_KEYDOWN)
-        REGIMACRO(WM_IME_KEYUP)
-        REGIMACRO(WM_MOUSEHOVER)
-        REGIMACRO(WM_MOUSELEAVE)
-        REGIMACRO(WM_CUT)
-        REGIMACRO(WM_COPY)
-        REGIMACRO(WM_PASTE)
-        REGIMACRO(WM_CLEAR)
-        REGIMACRO(WM_UNDO)
-        REGIMACRO(WM_RENDERFORMAT)
-        REGIMACRO(WM_RENDERALLFORMATS)
-        REGIMACRO(WM_DESTROYCLIPBOARD)
-        REGIMACRO(WM_DRAWCLIPBOARD)
-        REGIMACRO(WM_PAINTCLIPBOARD)
-        REGIMACRO(WM_VSCROLLCLIPBOARD)
-        REGIMACRO(WM_SIZECLIPBOARD)
-        REGIMACRO(WM_ASKCBFORMATNAME)
-        REGIMACRO(WM_CHANGECBCHAIN)
-        REGIMACRO(WM_HSCROLLCLIPBOARD)
-        REGIMACRO(WM_MOUSEFIRST)
-        REGIMACRO(WM_MOUSELAST)
-        REGIMACRO(WM_QUEUESYNC)
-        REGIMACRO(WM_GETMINMAXINFO)
-        REGIMACRO(WM_ICONERASEBKGND)
-        REGIMACRO(WM_NEXTDLGCTL)
-        REGIMACRO(WM_SPOOLERSTATUS)
-        REGIMACRO(WM_DRAWITEM)
-        REGIMACRO(WM_MEASUREITEM)
-        REGIMACRO(WM_DELETEITEM)
-        REGIMACRO(WM_VKEYTOITEM)
-        REGIMACRO(WM_CHARTOITEM)
-        REGIMACRO(WM_SETFONT)
-        REGIMACRO(WM_GETFONT)
-        REGIMACRO(WM_SETHOTKEY)
-        REGIMACRO(WM_GETHOTKEY)
-        REGIMACRO(WM_QUERYDRAGICON)
-        REGIMACRO(WM_COMPAREITEM)
-        REGIMACRO(WM_GETOBJECT)
-        REGIMACRO(WM_COMPACTING)
-        REGIMACRO(WM_COMMNOTIFY)
-        REGIMACRO(WM_WINDOWPOSCHANGING)
-        REGIMACRO(WM_WINDOWPOSCHANGED)
-        REGIMACRO(WM_POWERBROADCAST)
-        REGIMACRO(WM_COPYDATA)
-            REGIMACRO(BS_PUSHBUTTON)
-            REGIMACRO(BS_DEFPUSHBUTTON)
-            REGIMACRO(BS_CHECKBOX)
-            REGIMACRO(BS_AUTOCHECKBOX)
-            REGIMACRO(BS_RADIOBUTTON)
-            REGIMACRO(BS_3STATE)
-            REGIMACRO(BS_AUTO3STATE)
-            REGIMACRO(BS_GROUPBOX)
-            REGIMACRO(BS_USERBUTTON)
-            REGIMACRO(BS_AUTORADIOBUTTON)
-            REGIMACRO(BS_PUSHBOX)
-            REGIMACRO(BS_OWNERDRAW)
-            REGIMACRO(BS_TYPEMASK)
-            REGIMACRO(BS_LEFTTEXT)
-            REGIMACRO(BS_TEXT)
-            REGIMACRO(BS_ICON)
-            REGIMACRO(BS_BITMAP)
-            REGIMACRO(BS_LEFT)
-            REGIMACRO(BS_RIGHT)
-            REGIMACRO(BS_CENTER)
-            REGIMACRO(BS_TOP)
-            REGIMACRO(BS_BOTTOM)
-            REGIMACRO(BS_VCENTER)
-            REGIMACRO(BS_PUSHLIKE)
-            REGIMACRO(BS_MULTILINE)
-            REGIMACRO(BS_NOTIFY)
-            REGIMACRO(BS_FLAT)
-            REGIMACRO(BS_RIGHTBUTTON)
-
-            REGIMACRO(BN_CLICKED)
-            REGIMACRO(BN_PAINT)
-            REGIMACRO(BN_HILITE)
-            REGIMACRO(BN_UNHILITE)
-            REGIMACRO(BN_DISABLE)
-            REGIMACRO(BN_DOUBLECLICKED)
-            REGIMACRO(BN_PUSHED)
-            REGIMACRO(BN_UNPUSHED)
-            REGIMACRO(BN_DBLCLK)
-            REGIMACRO(BN_SETFOCUS)
-            REGIMACRO(BN_KILLFOCUS)
-
-            REGIMACRO(BM_GETCHECK)
-            REGIMACRO(BM_SETCHECK)
-            REGIMACRO(BM_GETSTATE)
-            REGIMACRO(BM_SETSTATE)
-            REGIMACRO(BM_SETSTYLE)
-            REGIMACRO(BM_CLICK)
-            REGIMACRO(BM_GETIMAGE)
-            REGIMACRO(BM_SETIMAGE)
-            REGIMACRO(BM_SETDONTCLICK)
-
-            REGIMACRO(BST_UNCHECKED)
-            REGIMACRO(BST_CHECKED)
-            REGIMACRO(BST_INDETERMINATE)
-            REGIMACRO(BST_PUSHED)
-            REGIMACRO(BST_FOCUS)
-}
+}
\ No newline at end of file
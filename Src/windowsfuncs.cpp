@@ -1,6 +1,4 @@
-void register_window_funcs(lua_State* L)
-{
-INIT_WPR()
+INIT_SUBMODULE(window)
     ADD2WPR(MessageBoxEx)
     ADD2WPR(CreateWindowEx)
     ADD2WPR(ShowWindow)
@@ -17,7 +15,6 @@ INIT_WPR()
     ADD2WPR(GetFocus)
     ADD2WPR(GetClientRect)
     ADD2WPR(InvalidateRect)
-    ADD2WPR(SendMessage)
     ADD2WPR(SetParent)
     ADD2WPR(GetWindowLong)
     ADD2WPR(SetWindowLong)
@@ -27,79 +24,46 @@ INIT_WPR()
     ADD2WPR(IsWindow)
     ADD2WPR(GetConsoleWindow)
     ADD2WPR(GetActiveWindow)
-    ADD2WPR(GetLastError)
-    ADD2WPR(MAKELANGID)
-    ADD2WPR(FormatMessage)
+    ADD2WPR(RegisterClassEx)
+    ADD2WPR(LoadCursor)
+    ADD2WPR(LoadIcon)
+    ADD2WPR(IsZoomed)
+    ADD2WPR(GetWindowPlacement)
+    ADD2WPR(SetWindowPlacement)
+    ADD2WPR(InitCommonControlsEx)
+    ADD2WPR(SetForegroundWindow)
+    ADD2WPR(GetForegroundWindow)
+    ADD2WPR(GetParent)
+    ADD2WPR(SetLayeredWindowAttributes)
+    ADD2WPR(GetLayeredWindowAttributes)
+    ADD2WPR(UpdateLayeredWindow)
+    ADD2WPR(EnableDoubleBuffer)
+    ADD2WPR(DisableDoubleBuffer)
+    ADD2WPR(GetDirtyRects)
+END_SUBMODULE()
+
+INIT_SUBMODULE(message)
+    ADD2WPR(SendMessage)
+    ADD2WPR(PostMessage)
     ADD2WPR(DefWindowProc)
     ADD2WPR(ToWindowProc)
     ADD2WPR(CallWindowProc)
-    ADD2WPR(RegisterClassEx)
-    ADD2WPR(LoadLibrary)
-    ADD2WPR(FreeLibrary)
-    ADD2WPR(GetProcAddress)
     ADD2WPR(GetMessage)
+    ADD2WPR(PeekMessage)
     ADD2WPR(TranslateMessage)
     ADD2WPR(DispatchMessage)
-    ADD2WPR(GetModuleHandleEx)
-    ADD2WPR(LoadCursor)
-    ADD2WPR(LoadIcon)
-    ADD2WPR(SleepEx)
-    ADD2WPR(PeekMessage)
     ADD2WPR(PostQuitMessage)
-    ADD2WPR(GetCurrentProcess)
-    ADD2WPR(GetCurrentProcessId)
-    ADD2WPR(GetCurrentProcessToken)
-    ADD2WPR(GetCurrentThread)
-    ADD2WPR(GetCurrentThreadId)
-    ADD2WPR(GetCurrentThreadToken)
-    ADD2WPR(GetCurrentThreadStackLimits)
-    ADD2WPR(GetCurrentThreadEffectiveToken)
-    ADD2WPR(GetCurrentDirectory)
-    ADD2WPR(GetCurrentConsoleFontEx)
-    ADD2WPR(GetCurrentActCtx)
-    ADD2WPR(GetCurrentHwProfile)
-    ADD2WPR(GetCurrentPositionEx)
-    ADD2WPR(GetCurrentObject)
-    ADD2WPR(GetDoubleClickTime)
-    ADD2WPR(Addr2Num)
-    ADD2WPR(Addr2Val)
-    ADD2WPR(Num2Addr)
     ADD2WPR(LoopMessages)
-    ADD2WPR(MessageBeep)
-    ADD2WPR(Beep)
-    ADD2WPR(PlaySound)
-    ADD2WPR(MAKEINTRESOURCE)
-    ADD2WPR(GetTickCount)
-    ADD2WPR(LOWORD)
-    ADD2WPR(HIWORD)
-    ADD2WPR(GetSystemMetrics)
-    ADD2WPR(IsZoomed)
+    ADD2WPR(SetTimer)
+    ADD2WPR(KillTimer)
+END_SUBMODULE()
+
+INIT_SUBMODULE(render)
     ADD2WPR(RGB)
     ADD2WPR(CreateSolidBrush)
     ADD2WPR(GetStockObject)
-    ADD2WPR(GetWindowPlacement)
-    ADD2WPR(SetWindowPlacement)
-    ADD2WPR(Val2Addr)
-    ADD2WPR(InitCommonControlsEx)
-    ADD2WPR(CoTaskMemAlloc)
-    ADD2WPR(CoTaskMemFree)
-    ADD2WPR(GetOpenFileName)
-    ADD2WPR(GetSaveFileName)
-    ADD2WPR(SHBrowseForFolder)
-    ADD2WPR(CommDlgExtendedError)
-    ADD2WPR(SHGetPathFromIDList)
-    ADD2WPR(MultiByteToWideChar)
-    ADD2WPR(OpenClipboard)
-    ADD2WPR(EmptyClipboard)
-    ADD2WPR(CloseClipboard)
-    ADD2WPR(SetClipboardData)
-    ADD2WPR(GlobalAlloc)
-    ADD2WPR(GlobalLock)
-    ADD2WPR(GlobalUnlock)
-    ADD2WPR(GlobalFree)
-    ADD2WPR(SHParseDisplayName)
-    ADD2WPR(SetTimer)
-    ADD2WPR(KillTimer)
+    ADD2WPR(GetCurrentPositionEx)
+    ADD2WPR(GetCurrentObject)
     ADD2WPR(FillRect)
     ADD2WPR(GetDC)
     ADD2WPR(CreateCompatibleDC)
@@ -124,17 +88,151 @@ INIT_WPR()
     ADD2WPR(DrawTextEx)
     ADD2WPR(GetSysColor)
     ADD2WPR(GetSysColorBrush)
-    ADD2WPR(PostMessage)
-    ADD2WPR(SetForegroundWindow)
-    ADD2WPR(GetForegroundWindow)
-    ADD2WPR(GetParent)
-    ADD2WPR(SetLayeredWindowAttributes)
-    ADD2WPR(GetLayeredWindowAttributes)
-    ADD2WPR(CreateProcess)
-    ADD2WPR(TerminateProcess)
-    ADD2WPR(CloseHandle)
+    ADD2WPR(CreateCommandList)
+    ADD2WPR(CachedSolidBrush)
+    ADD2WPR(CachedPen)
+    ADD2WPR(CachedFont)
+    ADD2WPR(ReleaseCachedObject)
+    ADD2WPR(SetCachedObjectLimit)
+    ADD2WPR(GetCachedObjectCounts)
+    ADD2WPR(GetGuiResources)
+    ADD2WPR(MeasureText)
+    ADD2WPR(MeasureTextBatch)
+    ADD2WPR(ClearTextMeasureCache)
+END_SUBMODULE()
+
+INIT_SUBMODULE(pixel)
+    ADD2WPR(ARGB)
+    ADD2WPR(CreatePixelBuffer)
+    ADD2WPR(CreateDIBPixelBuffer)
+    ADD2WPR(RasterKernelLevel)
+    ADD2WPR(RasterBenchmark)
+    ADD2WPR(CreateScreenCapture)
+    ADD2WPR(PixelSearchBenchmark)
+    ADD2WPR(LoadPixelBuffer)
+    ADD2WPR(DecodePixelBuffer)
+    ADD2WPR(LoadImageRows)
+    ADD2WPR(DecodeImageRows)
+    ADD2WPR(SavePixelBuffer)
+    ADD2WPR(EncodePixelBuffer)
+    ADD2WPR(ImageCodecBenchmark)
+END_SUBMODULE()
+
+INIT_SUBMODULE(memory)
+    ADD2WPR(Addr2Num)
+    ADD2WPR(Addr2Val)
+    ADD2WPR(Num2Addr)
+    ADD2WPR(Val2Addr)
     ADD2WPR(CopyAddr)
     ADD2WPR(WriteAddr)
     ADD2WPR(GetLuaStateAddr)
-END_WPR()
-}
+    ADD2WPR(CoTaskMemAlloc)
+    ADD2WPR(CoTaskMemFree)
+    ADD2WPR(GlobalAlloc)
+    ADD2WPR(GlobalLock)
+    ADD2WPR(GlobalUnlock)
+    ADD2WPR(GlobalFree)
+    ADD2WPR(MultiByteToWideChar)
+END_SUBMODULE()
+
+INIT_SUBMODULE(process)
+    ADD2WPR(GetCurrentProcess)
+    ADD2WPR(GetCurrentProcessId)
+    ADD2WPR(GetCurrentProcessToken)
+    ADD2WPR(GetCurrentThread)
+    ADD2WPR(GetCurrentThreadId)
+    ADD2WPR(GetCurrentThreadToken)
+    ADD2WPR(GetCurrentThreadStackLimits)
+    ADD2WPR(GetCurrentThreadEffectiveToken)
+    ADD2WPR(GetCurrentActCtx)
+    ADD2WPR(CreateProcess)
+    ADD2WPR(SpawnProcess)
+    ADD2WPR(CreateProcessPool)
+    ADD2WPR(CreateSnapshot)
+    ADD2WPR(DiffSnapshots)
+    ADD2WPR(TerminateProcess)
+    ADD2WPR(OpenProcess)
+    ADD2WPR(ReadProcessMemory)
+    ADD2WPR(CloseHandle)
+    ADD2WPR(LoadLibrary)
+    ADD2WPR(FreeLibrary)
+    ADD2WPR(GetProcAddress)
+    ADD2WPR(BindLibrary)
+    ADD2WPR(ParseExports)
+    ADD2WPR(ParseExportsFile)
+    ADD2WPR(GetModuleHandleEx)
+END_SUBMODULE()
+
+INIT_SUBMODULE(input)
+    ADD2WPR(GetDoubleClickTime)
+    ADD2WPR(OpenClipboard)
+    ADD2WPR(EmptyClipboard)
+    ADD2WPR(CloseClipboard)
+    ADD2WPR(SetClipboardData)
+END_SUBMODULE()
+
+INIT_SUBMODULE(shell)
+    ADD2WPR(GetCurrentDirectory)
+    ADD2WPR(GetOpenFileName)
+    ADD2WPR(GetSaveFileName)
+    ADD2WPR(CommDlgExtendedError)
+    ADD2WPR(SHBrowseForFolder)
+    ADD2WPR(SHGetPathFromIDList)
+    ADD2WPR(SHParseDisplayName)
+END_SUBMODULE()
+
+INIT_SUBMODULE(system)
+    ADD2WPR(GetLastError)
+    ADD2WPR(MAKELANGID)
+    ADD2WPR(FormatMessage)
+    ADD2WPR(MAKEINTRESOURCE)
+    ADD2WPR(LOWORD)
+    ADD2WPR(HIWORD)
+    ADD2WPR(SleepEx)
+    ADD2WPR(GetTickCount)
+    ADD2WPR(GetSystemMetrics)
+    ADD2WPR(GetCurrentConsoleFontEx)
+    ADD2WPR(GetCurrentHwProfile)
+    ADD2WPR(MessageBeep)
+    ADD2WPR(Beep)
+    ADD2WPR(PlaySound)
+    ADD2WPR(ConstantName)
+END_SUBMODULE()
+
+INIT_SUBMODULE(async)
+    ADD2WPR(SpawnCoroutine)
+    ADD2WPR(AwaitTimeout)
+    ADD2WPR(AwaitHandle)
+    ADD2WPR(AwaitMessage)
+    ADD2WPR(AwaitCompletion)
+    ADD2WPR(SignalCompletion)
+    ADD2WPR(RunScheduler)
+    ADD2WPR(StopScheduler)
+    ADD2WPR(CreateTimerWheel)
+    ADD2WPR(CreateWaitSet)
+END_SUBMODULE()
+
+INIT_SUBMODULE(profiler)
+    ADD2WPR(QueryPerformanceCounter)
+    ADD2WPR(QueryPerformanceFrequency)
+    ADD2WPR(ProfileLabel)
+    ADD2WPR(ProfileBegin)
+    ADD2WPR(ProfileEnd)
+    ADD2WPR(ProfileRecord)
+    ADD2WPR(ProfileStats)
+    ADD2WPR(ProfileReset)
+END_SUBMODULE()
+
+INIT_MODULES()
+    ADD2MODULES(window)
+    ADD2MODULES(message)
+    ADD2MODULES(render)
+    ADD2MODULES(pixel)
+    ADD2MODULES(memory)
+    ADD2MODULES(process)
+    ADD2MODULES(input)
+    ADD2MODULES(shell)
+    ADD2MODULES(system)
+    ADD2MODULES(async)
+    ADD2MODULES(profiler)
+END_MODULES()
@@ -110,8 +110,11 @@ static void makeDinamicStruct(lua_State* L, int tableIdx, size_t& size, std::vec
 }
 
 
+// One argument of a dynamic call, execFunc takes an array of nargs of them.
+using ProcArg = std::variant<void*, lua_Number>;
+
 template<typename T>
-T getArg(const std::vector<std::variant<void*, lua_Number>>& args, size_t i) {
+T getArg(const ProcArg* args, size_t i) {
     if constexpr (std::is_same_v<T, lua_Number>)
         return std::get<lua_Number>(args[i]);
     else
@@ -120,13 +123,13 @@ T getArg(const std::vector<std::variant<void*, lua_Number>>& args, size_t i) {
 
 // Call with sign
 template<typename Ret, typename... Args, size_t... I>
-Ret callFunc(FARPROC func, const std::vector<std::variant<void*, lua_Number>>& args, std::index_sequence<I...>) {
+Ret callFunc(FARPROC func, const ProcArg* args, std::index_sequence<I...>) {
     return ((Ret(*)(Args...))func)(getArg<Args>(args, I)...);
 }
 
 // Select sign
 template<typename Ret>
-Ret execFunc(lua_State* L, FARPROC func, const std::vector<std::variant<void*, lua_Number>>& args, int nargs, bool hasNumber) {
+Ret execFunc(lua_State* L, FARPROC func, const ProcArg* args, int nargs, bool hasNumber) {
     Ret result{};
     bool success = false;
     uintptr_t exceptionCode = 0;
@@ -229,10 +232,10 @@ static void separateArgs(const std::vector<std::variant<void*, lua_Number>>& arg
 {
     for (int i = 0; i < nargs; ++i) {
         if (std::holds_alternative<lua_Number>(args[i])) {
-            argsf[i] = getArg<lua_Number>(args, i);
+            argsf[i] = getArg<lua_Number>(args.data(), i);
         }
         else {
-            argsa[i] = getArg<void*>(args, i);
+            argsa[i] = getArg<void*>(args.data(), i);
         }
     }
 }
@@ -352,11 +355,11 @@ static int executeProcAddr(lua_State* L) {
         checkArgs(L, hasNumber, args, nargs);
         if (retNum)
         {
-            numResult = execFunc<lua_Number>(L, func, args, nargs, hasNumber);
+            numResult = execFunc<lua_Number>(L, func, args.data(), nargs, hasNumber);
         }
         else
         {
-            result = execFunc<void*>(L, func, args, nargs, hasNumber);
+            result = execFunc<void*>(L, func, args.data(), nargs, hasNumber);
         }
     }
 
@@ -373,6 +376,100 @@ static int executeProcAddr(lua_State* L) {
     return 1;
 }
 
+// Type names resolved once when the caller is built, see procsignature.h.
+enum ProcType : uint8_t {
+    PROC_INTEGER, PROC_NUMBER, PROC_BOOLEAN, PROC_LIGHTUSERDATA, PROC_STRING, PROC_USERDATA, PROC_VOID,
+    PROC_UNKNOWN = 0xFF
+};
+static const char* const procTypeNames[] = {
+    "integer", "number", "boolean", "lightuserdata", "string", "userdata", "void", NULL
+};
+struct ProcSignature {
+    uint8_t ret;
+    uint8_t nargs;
+    bool hasNumber;
+    uint8_t args[16];
+};
+
+// Lookup only, the normalized name must be gone before a Lua error is raised.
+static uint8_t findProcType(const char* name) {
+    const std::string type = normalize_type(name);
+    for (uint8_t i = 0; procTypeNames[i]; ++i) {
+        if (type == procTypeNames[i]) return i;
+    }
+    return PROC_UNKNOWN;
+}
+static uint8_t compileProcType(lua_State* L, int idx) {
+    const char* name = luaL_checkstring(L, idx);
+    uint8_t type = findProcType(name);
+    if (type == PROC_UNKNOWN) luaL_error(L, "Unsupported type: %s", name);
+    return type;
+}
+
+static int executeProcSignature(lua_State* L) {
+    FARPROC func = (FARPROC)lua_touserdata(L, lua_upvalueindex(1));
+    const ProcSignature* sig = (const ProcSignature*)lua_touserdata(L, lua_upvalueindex(2));
+
+    // On the stack, an argument error must not leak anything.
+    std::array<ProcArg, 16> args;
+    for (int i = 0; i < sig->nargs; ++i) {
+        switch (sig->args[i]) {
+        case PROC_INTEGER: args[i] = (void*)(intptr_t)luaL_checkinteger(L, i + 1); break;
+        case PROC_NUMBER: args[i] = luaL_checknumber(L, i + 1); break;
+        case PROC_BOOLEAN: args[i] = (void*)(intptr_t)(lua_toboolean(L, i + 1) ? 1 : 0); break;
+        case PROC_LIGHTUSERDATA: args[i] = lua_touserdata(L, i + 1); break;
+        case PROC_STRING: args[i] = (void*)luaL_checkstring(L, i + 1); break;
+        case PROC_USERDATA: args[i] = luaL_checkuserdata(L, i + 1); break;
+        }
+    }
+
+    lua_Number numResult = 0;
+    void* result = 0;
+    if (sig->ret == PROC_NUMBER) numResult = execFunc<lua_Number>(L, func, args.data(), sig->nargs, sig->hasNumber);
+    else result = execFunc<void*>(L, func, args.data(), sig->nargs, sig->hasNumber);
+
+    switch (sig->ret) {
+    case PROC_INTEGER: lua_pushinteger(L, (lua_Integer)result); break;
+    case PROC_NUMBER: lua_pushnumber(L, numResult); break;
+    case PROC_BOOLEAN: lua_pushboolean(L, (bool)result); break;
+    case PROC_LIGHTUSERDATA:
+    case PROC_USERDATA: lua_pushlightuserdata(L, result); break;
+    case PROC_STRING: lua_pushstring(L, (const char*)result); break;
+    default: return 0;
+    }
+    return 1;
+}
+
+void pushProcCaller(lua_State* L, FARPROC func, int retIdx, int argsIdx) {
+    retIdx = lua_absindex(L, retIdx);
+    argsIdx = lua_absindex(L, argsIdx);
+    ProcSignature sig = {};
+    sig.ret = lua_isnoneornil(L, retIdx) ? (uint8_t)PROC_VOID : compileProcType(L, retIdx);
+    if (!lua_isnoneornil(L, argsIdx)) {
+        luaL_checktype(L, argsIdx, LUA_TTABLE);
+        size_t nargs = lua_rawlen(L, argsIdx);
+        if (nargs > 16) luaL_error(L, "too many arguments, max is 16");
+        sig.nargs = (uint8_t)nargs;
+        for (size_t i = 0; i < nargs; ++i) {
+            lua_rawgeti(L, argsIdx, (lua_Integer)i + 1);
+            sig.args[i] = compileProcType(L, -1);
+            lua_pop(L, 1);
+            if (sig.args[i] == PROC_VOID) luaL_error(L, "void is not an argument type");
+            if (sig.args[i] == PROC_NUMBER) sig.hasNumber = true;
+        }
+    }
+    // Mixed calls are not supported by execFunc, reject them now rather than
+    // on every call.
+    for (int i = 0; sig.hasNumber && i < sig.nargs; ++i) {
+        if (sig.args[i] != PROC_NUMBER) {
+            luaL_error(L, "All arguments must be numbers when at least one argument is a number.");
+        }
+    }
+    lua_pushlightuserdata(L, (void*)func);
+    *(ProcSignature*)lua_newuserdata(L, sizeof(ProcSignature)) = sig;
+    lua_pushcclosure(L, executeProcSignature, 2);
+}
+
 
 
 #define VAL2UD(TYPE, CHECK, UD_TYPE) \
@@ -673,10 +770,12 @@ Lua_Function(CloseHandle)
     lua_pushboolean(L,CloseHandle(luaL_wingetbycheckudata(L, 1, HANDLE)));
     return 1;
 }
+// ReadProcessMemory(process, address, size) -> bytes, count. address is a
+// lightuserdata or an integer, as exports:resolve returns for another process.
 Lua_Function(ReadProcessMemory)
 {
     HANDLE hProcess = luaL_wingetbycheckudata(L, 1, HANDLE);
-    LPCVOID lpBaseAddress = lua_touserdata(L, 2);
+    LPCVOID lpBaseAddress = lua_islightuserdata(L, 2) ? lua_touserdata(L, 2) : (LPCVOID)(uintptr_t)luaL_checkinteger(L, 2);
     SIZE_T nSize = (SIZE_T)luaL_checkinteger(L, 3);
 
     std::vector<char> buffer(nSize);
@@ -820,61 +919,4 @@ Lua_Function(GlobalFree)
     else
         pushWindowStruct(L, HGLOBAL, result);
     return 1;
-}
-
-void register_winmemory(lua_State* L) // los macros, huevn
-{
-    REGIMACRO(CP_ACP)         // ANSI code page
-        REGIMACRO(CP_OEMCP)       // OEM code page
-        REGIMACRO(CP_MACCP)       // Mac code page
-        REGIMACRO(CP_THREAD_ACP)  // Threads ANSI code page
-        REGIMACRO(CP_UTF7)        // UTF-7
-        REGIMACRO(CP_UTF8)        // UTF-8
-        REGIMACRO(CP_SYMBOL)      // Symbol code page
-
-        REGIMACRO(GMEM_FIXED)
-        REGIMACRO(GMEM_MOVEABLE)
-        REGIMACRO(GMEM_NOCOMPACT)
-        REGIMACRO(GMEM_NODISCARD)
-        REGIMACRO(GMEM_ZEROINIT)
-        REGIMACRO(GMEM_MODIFY)
-        REGIMACRO(GMEM_DISCARDABLE)
-        REGIMACRO(GMEM_NOT_BANKED)
-        REGIMACRO(GMEM_NOTIFY)
-        REGIMACRO(GMEM_LOWER)
-        REGIMACRO(GMEM_VALID_FLAGS)
-        REGIMACRO(GMEM_INVALID_HANDLE)
-        REGIMACRO(GMEM_DISCARDED)
-        REGIMACRO(GMEM_LOCKCOUNT)
-
-        REGIMACRO(CF_TEXT)
-        REGIMACRO(CF_BITMAP)
-        REGIMACRO(CF_METAFILEPICT)
-        REGIMACRO(CF_SYLK)
-        REGIMACRO(CF_DIF)
-        REGIMACRO(CF_TIFF)
-        REGIMACRO(CF_OEMTEXT)
-        REGIMACRO(CF_DIB)
-        REGIMACRO(CF_PALETTE)
-        REGIMACRO(CF_PENDATA)
-        REGIMACRO(CF_RIFF)
-        REGIMACRO(CF_WAVE)
-        REGIMACRO(CF_UNICODETEXT)
-        REGIMACRO(CF_ENHMETAFILE)
-        REGIMACRO(CF_HDROP)
-        REGIMACRO(CF_LOCALE)
-        REGIMACRO(CF_DIBV5)
-        REGIMACRO(CF_OWNERDISPLAY)
-        REGIMACRO(CF_DSPTEXT)
-        REGIMACRO(CF_DSPBITMAP)
-        REGIMACRO(CF_DSPMETAFILEPICT)
-        REGIMACRO(CF_DSPENHMETAFILE)
-        // Get Window Long
-        REGIMACRO(GWLP_WNDPROC)
-        REGIMACRO(GWLP_HINSTANCE)
-        REGIMACRO(GWLP_HWNDPARENT)
-        REGIMACRO(GWL_STYLE)
-        REGIMACRO(GWL_EXSTYLE)
-        REGIMACRO(GWLP_USERDATA)
-        REGIMACRO(GWL_ID)
 }
\ No newline at end of file
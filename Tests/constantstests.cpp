@@ -0,0 +1,108 @@
+// Built the way END_CONSTANTS and CONSTANT_FAMILY build the module tables.
+static constexpr auto test_list = std::to_array<LuaConstant>({
+    { "WM_NULL", 0x0000, nullptr },
+    { "WM_CREATE", 0x0001, nullptr },
+    { "WM_DESTROY", 0x0002, nullptr },
+    { "WM_MOVE", 0x0003, nullptr },
+    { "WM_SIZE", 0x0005, nullptr },
+    { "WM_PAINT", 0x000F, nullptr },
+    { "WM_CLOSE", 0x0010, nullptr },
+    { "WM_QUIT", 0x0012, nullptr },
+    { "WM_KEYDOWN", 0x0100, nullptr },
+    { "WM_KEYFIRST", 0x0100, nullptr },
+    { "WM_KEYUP", 0x0101, nullptr },
+    { "WM_CHAR", 0x0102, nullptr },
+    { "WM_TIMER", 0x0113, nullptr },
+    { "WM_MOUSEMOVE", 0x0200, nullptr },
+    { "WM_MOUSEFIRST", 0x0200, nullptr },
+    { "WM_USER", 0x0400, nullptr },
+    { "VK_BACK", 0x08, nullptr },
+    { "VK_TAB", 0x09, nullptr },
+    { "VK_RETURN", 0x0D, nullptr },
+    { "VK_SHIFT", 0x10, nullptr },
+    { "VK_ESCAPE", 0x1B, nullptr },
+    { "VK_SPACE", 0x20, nullptr },
+    { "VK_LEFT", 0x25, nullptr },
+    { "VK_UP", 0x26, nullptr },
+    { "VK_F1", 0x70, nullptr },
+    { "CS_VREDRAW", 0x0001, nullptr },
+    { "CS_HREDRAW", 0x0002, nullptr },
+    { "CS_DBLCLKS", 0x0008, nullptr },
+    { "CS_OWNDC", 0x0020, nullptr },
+    { "ERROR_SUCCESS", 0, nullptr },
+    { "ERROR_FILE_NOT_FOUND", 2, nullptr },
+    { "ERROR_ACCESS_DENIED", 5, nullptr },
+    { "WM_PAINT", 0x000F, nullptr },
+    { "WM_NULL", 0x0000, nullptr },
+    { "HANDLE_VALUE", 0, [](lua_State*) {} },
+});
+static constexpr auto test_data = buildLuaConstants<uniqueLuaConstantCount(test_list)>(test_list);
+static constexpr LuaConstantTable test_table = test_data.table();
+static constexpr auto wm_names = buildLuaConstantNames<luaConstantFamilyCount(test_list, "WM_")>(test_list, "WM_");
+
+static const LuaConstant* lookup(std::string_view name)
+{
+    const LuaConstant& c = luaConstantCandidate(test_table, luaConstantHash(name));
+    return name == c.name ? &c : nullptr;
+}
+
+TEST(constants, duplicates_are_merged)
+{
+    static_assert(uniqueLuaConstantCount(test_list) == test_list.size() - 2);
+    CHECK(test_table.count == test_list.size() - 2);
+    for (size_t i = 1; i < test_table.count; ++i)
+        CHECK(std::string_view(test_table.entries[i - 1].name) < test_table.entries[i].name);
+}
+TEST(constants, every_name_is_found)
+{
+    for (const LuaConstant& c : test_list)
+    {
+        const LuaConstant* found = lookup(c.name);
+        CHECK(found && found->value == c.value && (found->push != nullptr) == (c.push != nullptr));
+    }
+    // Resolved at compile time as well.
+    static_assert(std::string_view(luaConstantCandidate(test_table, luaConstantHash("VK_F1")).name) == "VK_F1");
+}
+TEST(constants, slots_are_a_permutation)
+{
+    std::vector<bool> seen(test_table.count);
+    for (size_t i = 0; i < test_table.count; ++i)
+    {
+        CHECK(test_table.slots[i] < test_table.count && !seen[test_table.slots[i]]);
+        seen[test_table.slots[i]] = true;
+    }
+}
+TEST(constants, small_tables_are_built)
+{
+    // errors_constants, three names no seed placed with the old slot hash.
+    static constexpr auto list = std::to_array<LuaConstant>({
+        { "INVALID_HANDLE_VALUE", 0, [](lua_State*) {} },
+        { "INVALID_FILE_ATTRIBUTES", -1, nullptr },
+        { "INVALID_SET_FILE_POINTER", -1, nullptr },
+    });
+    static constexpr auto data = buildLuaConstants<list.size()>(list);
+    static constexpr LuaConstantTable table = data.table();
+    for (const LuaConstant& c : list)
+        CHECK(std::string_view(luaConstantCandidate(table, luaConstantHash(c.name)).name) == c.name);
+}
+TEST(constants, unknown_names_miss)
+{
+    for (const char* name : { "", "WM_", "WM_PAINTX", "wm_paint", "VK_F2", "CS_VREDRAW ", "NOT_A_CONSTANT" })
+        CHECK(lookup(name) == nullptr);
+}
+TEST(constants, family_names_by_value)
+{
+    // Aliases keep the name listed first, handles are not part of a family.
+    CHECK(wm_names.size() == 14);
+    for (size_t i = 1; i < wm_names.size(); ++i)
+        CHECK(wm_names[i - 1].value < wm_names[i].value);
+    auto name = [](lua_Integer value) -> std::string_view {
+        for (const LuaConstantName& n : wm_names)
+            if (n.value == value)
+                return n.name;
+        return {};
+    };
+    CHECK(name(0x0100) == "WM_KEYDOWN");
+    CHECK(name(0x0200) == "WM_MOUSEMOVE");
+    CHECK(name(0x000F) == "WM_PAINT");
+}
@@ -0,0 +1,146 @@
+static HANDLE fakeHandle(uintptr_t n)
+{
+    return (HANDLE)n;
+}
+static void countWake(void* param)
+{
+    ++*(int*)param;
+}
+
+TEST(handlewaits, drains_oldest_first_with_one_wake)
+{
+    MockHandleWaits backend;
+    HandleWaits w;
+    int wakes = 0;
+    CHECK(openHandleWaits(&w, &backend, countWake, &wakes));
+    std::unique_ptr<HandleWait> e[3];
+    for (uintptr_t i = 0; i < 3; ++i)
+        e[i] = openHandleWait(&w, fakeHandle(i + 1), INFINITE, i + 1);
+    CHECK(backend.fire(fakeHandle(2)));
+    CHECK(backend.fire(fakeHandle(1), true));
+    CHECK(backend.fire(fakeHandle(3)));
+    CHECK(handleWaitsPending(&w));
+    CHECK(backend.wakes.size() == 1);
+    CHECK(backend.runWakes() == 1 && wakes == 1 && !w.wakeQueued);
+    std::vector<HandleWait*> fired;
+    drainHandleWaits(&w, fired);
+    CHECK(fired.size() == 3);
+    CHECK(fired.size() == 3 && fired[0]->cookie == 2 && fired[1]->cookie == 1 && fired[2]->cookie == 3);
+    CHECK(fired.size() == 3 && !fired[0]->timedOut && fired[1]->timedOut);
+    CHECK(!handleWaitsPending(&w));
+    for (auto& entry : e)
+        closeHandleWait(&w, std::move(entry));
+    CHECK(backend.duplicates == 0);
+    closeHandleWaits(&w);
+    CHECK(backend.owners == 0);
+}
+TEST(handlewaits, drained_entries_wait_for_rearm)
+{
+    MockHandleWaits backend;
+    HandleWaits w;
+    CHECK(openHandleWaits(&w, &backend, nullptr, nullptr));
+    std::unique_ptr<HandleWait> e = openHandleWait(&w, fakeHandle(1), INFINITE, 1);
+    CHECK(backend.fire(fakeHandle(1)));
+    std::vector<HandleWait*> fired;
+    drainHandleWaits(&w, fired);
+    CHECK(fired.size() == 1);
+    CHECK(!backend.fire(fakeHandle(1)));
+    CHECK(armHandleWait(e.get()));
+    CHECK(backend.fire(fakeHandle(1)));
+    fired.clear();
+    drainHandleWaits(&w, fired);
+    CHECK(fired.size() == 1 && fired[0] == e.get());
+    closeHandleWait(&w, std::move(e));
+    closeHandleWaits(&w);
+}
+TEST(handlewaits, entries_closed_while_queued_are_skipped)
+{
+    MockHandleWaits backend;
+    HandleWaits w;
+    CHECK(openHandleWaits(&w, &backend, nullptr, nullptr));
+    std::unique_ptr<HandleWait> a = openHandleWait(&w, fakeHandle(1), INFINITE, 1);
+    std::unique_ptr<HandleWait> b = openHandleWait(&w, fakeHandle(2), INFINITE, 2);
+    CHECK(backend.fire(fakeHandle(1)));
+    CHECK(backend.fire(fakeHandle(2)));
+    closeHandleWait(&w, std::move(a));
+    CHECK(w.retired.size() == 1);
+    std::vector<HandleWait*> fired;
+    drainHandleWaits(&w, fired);
+    CHECK(fired.size() == 1 && fired[0]->cookie == 2);
+    CHECK(w.retired.empty());
+    closeHandleWait(&w, std::move(b));
+    closeHandleWaits(&w);
+}
+TEST(handlewaits, failed_duplicate_opens_nothing)
+{
+    MockHandleWaits backend;
+    HandleWaits w;
+    CHECK(openHandleWaits(&w, &backend, nullptr, nullptr));
+    backend.failDuplicate = true;
+    CHECK(!openHandleWait(&w, fakeHandle(1), INFINITE, 1));
+    CHECK(backend.armed.empty() && backend.duplicates == 0);
+    closeHandleWaits(&w);
+}
+// The owner may be finalized on another thread than the one its wake is
+// queued to: closing must not wait for it, and the wake must not touch the
+// freed owner.
+TEST(handlewaits, close_cancels_a_queued_wake)
+{
+    MockHandleWaits backend;
+    int wakes = 0;
+    auto w = std::make_unique<HandleWaits>();
+    CHECK(openHandleWaits(w.get(), &backend, countWake, &wakes));
+    std::unique_ptr<HandleWait> e = openHandleWait(w.get(), fakeHandle(1), INFINITE, 1);
+    CHECK(backend.fire(fakeHandle(1)));
+    CHECK(w->wakeQueued);
+    std::thread([&] {
+        closeHandleWait(w.get(), std::move(e));
+        closeHandleWaits(w.get());
+        w.reset();
+    }).join();
+    CHECK(backend.runWakes() == 1);
+    CHECK(wakes == 0);
+}
+TEST(handlewaits, fires_from_other_threads)
+{
+    constexpr uintptr_t COUNT = 2000;
+    MockHandleWaits backend;
+    HandleWaits w;
+    int wakes = 0;
+    CHECK(openHandleWaits(&w, &backend, countWake, &wakes));
+    std::vector<std::unique_ptr<HandleWait>> entries;
+    for (uintptr_t i = 1; i <= COUNT; ++i)
+        entries.push_back(openHandleWait(&w, fakeHandle(i), INFINITE, i));
+    std::vector<std::thread> threads;
+    for (uintptr_t t = 0; t < 4; ++t)
+    {
+        threads.emplace_back([&backend, t] {
+            for (uintptr_t i = 1 + t; i <= COUNT; i += 4)
+                backend.fire(fakeHandle(i));
+        });
+    }
+    std::vector<bool> seen(COUNT + 1);
+    size_t drained = 0;
+    std::vector<HandleWait*> fired;
+    while (drained < COUNT)
+    {
+        backend.runWakes();
+        fired.clear();
+        drainHandleWaits(&w, fired);
+        for (HandleWait* e : fired)
+        {
+            CHECK(!seen[e->cookie]);
+            seen[e->cookie] = true;
+        }
+        drained += fired.size();
+        std::this_thread::yield();
+    }
+    for (std::thread& t : threads)
+        t.join();
+    CHECK(drained == COUNT);
+    CHECK(wakes >= 1);
+    for (auto& e : entries)
+        closeHandleWait(&w, std::move(e));
+    closeHandleWaits(&w);
+    CHECK(backend.duplicates == 0 && backend.owners == 0);
+}
@@ -0,0 +1,168 @@
+struct DecodedImage
+{
+    const char* error = nullptr;
+    ImageInfo info{};
+    std::vector<uint32_t> pixels;
+    int rows = 0;
+};
+static DecodedImage decode(const std::vector<uint8_t>& data)
+{
+    DecodedImage d;
+    ImageSink sink;
+    sink.begin = [&](const ImageInfo& info) {
+        // Mutated headers may ask for up to IMAGE_MAX_PIXELS.
+        if ((int64_t)info.width * info.height > 1 << 20)
+            return false;
+        d.info = info;
+        d.pixels.assign((size_t)info.width * info.height, 0);
+        return true;
+    };
+    sink.row = [&](int y, const uint32_t* row) {
+        memcpy(d.pixels.data() + (size_t)y * d.info.width, row, (size_t)d.info.width * 4);
+        ++d.rows;
+        return true;
+    };
+    ImageReader in(data.data(), data.size());
+    d.error = imageDecode(in, sink);
+    return d;
+}
+static std::vector<uint32_t> noise(int width, int height)
+{
+    std::vector<uint32_t> pixels((size_t)width * height);
+    uint32_t seed = 0x2545F491;
+    for (size_t i = 0; i < pixels.size(); ++i)
+    {
+        seed ^= seed << 13;
+        seed ^= seed >> 17;
+        seed ^= seed << 5;
+        // Runs and repeats as well, so every QOI op is produced.
+        pixels[i] = i % 7 < 3 ? 0xFF336699 : (i % 11 == 0 ? pixels[i / 2] : seed);
+    }
+    return pixels;
+}
+
+TEST(imagecodec, round_trips)
+{
+    for (ImageFormat format : { IMAGE_BMP, IMAGE_QOI })
+    {
+        for (int size : { 1, 3, 64 })
+        {
+            std::vector<uint32_t> pixels = noise(size, size + 1);
+            PixelView view{ pixels.data(), size, size + 1, size };
+            ImageWriter out;
+            CHECK(imageEncode(out, view, format) == nullptr);
+            CHECK(imageDetectFormat(out.buffer.data(), out.buffer.size()) == format);
+            DecodedImage d = decode(out.buffer);
+            CHECK(d.error == nullptr && d.info.format == format);
+            CHECK(d.info.width == size && d.info.height == size + 1 && d.rows == size + 1);
+            CHECK(d.pixels == pixels);
+        }
+    }
+}
+TEST(imagecodec, tga_bottom_up_24bit)
+{
+    std::vector<uint8_t> tga(18);
+    tga[2] = 2;
+    tga[12] = 2;
+    tga[14] = 2;
+    tga[16] = 24;
+    // Bottom row first, B G R.
+    const uint8_t data[] = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12 };
+    tga.insert(tga.end(), std::begin(data), std::end(data));
+    CHECK(imageDetectFormat(tga.data(), tga.size()) == IMAGE_TGA);
+    DecodedImage d = decode(tga);
+    CHECK(d.error == nullptr);
+    CHECK(d.pixels == std::vector<uint32_t>({ 0xFF090807, 0xFF0C0B0A, 0xFF030201, 0xFF060504 }));
+}
+TEST(imagecodec, truncated_input_fails_cleanly)
+{
+    std::vector<uint32_t> pixels = noise(16, 16);
+    PixelView view{ pixels.data(), 16, 16, 16 };
+    for (ImageFormat format : { IMAGE_BMP, IMAGE_QOI })
+    {
+        ImageWriter out;
+        imageEncode(out, view, format);
+        for (size_t n : { (size_t)0, (size_t)10, (size_t)20, out.buffer.size() / 2, out.buffer.size() - 9 })
+        {
+            std::vector<uint8_t> part(out.buffer.begin(), out.buffer.begin() + n);
+            CHECK(decode(part).error != nullptr);
+        }
+    }
+}
+TEST(imagecodec, format_names)
+{
+    CHECK(imageFormatFromName("qoi") == IMAGE_QOI);
+    CHECK(imageFormatFromName("png") == IMAGE_UNKNOWN);
+    CHECK(strcmp(imageFormatName(IMAGE_TGA), "tga") == 0);
+    const uint8_t junk[32] = { 'P', 'K' };
+    CHECK(imageDetectFormat(junk, sizeof(junk)) == IMAGE_UNKNOWN);
+}
+TEST(imagecodec, wide_bitfield_masks)
+{
+    // BI_BITFIELDS with a 26 bit red and a 6 bit green mask.
+    std::vector<uint8_t> bmp(14 + 40 + 12 + 8);
+    auto put32 = [&](size_t at, uint32_t v) { memcpy(bmp.data() + at, &v, 4); };
+    bmp[0] = 'B';
+    bmp[1] = 'M';
+    put32(2, (uint32_t)bmp.size());
+    put32(10, 14 + 40 + 12);
+    put32(14, 40);
+    put32(18, 2);
+    put32(22, 1);
+    bmp[26] = 1;
+    bmp[28] = 32;
+    put32(30, 3);
+    put32(54, 0xFFFFFFC0);
+    put32(58, 0x0000003F);
+    put32(62, 0);
+    put32(66, 0xFFFFFFC0);
+    put32(70, 0x8000003F);
+    DecodedImage d = decode(bmp);
+    CHECK(d.error == nullptr && d.info.width == 2 && d.info.height == 1);
+    CHECK(d.pixels == std::vector<uint32_t>({ 0xFFFF0000, 0xFF80FF00 }));
+}
+// Random byte flips and truncations of valid files, biased towards the
+// headers. Decoding must fail or produce every row, never read out of
+// bounds; run under ASan/UBSan to catch the latter.
+TEST(imagecodec, mutated_input_fails_cleanly)
+{
+    std::vector<uint32_t> pixels = noise(9, 7);
+    PixelView view{ pixels.data(), 9, 7, 9 };
+    std::vector<std::vector<uint8_t>> seeds;
+    for (ImageFormat format : { IMAGE_BMP, IMAGE_QOI })
+    {
+        ImageWriter out;
+        CHECK(imageEncode(out, view, format) == nullptr);
+        seeds.push_back(out.buffer);
+    }
+    std::vector<uint8_t> tga(18 + 9 * 7 * 3, 0x5A);
+    std::fill(tga.begin(), tga.begin() + 18, 0);
+    tga[2] = 2;
+    tga[12] = 9;
+    tga[14] = 7;
+    tga[16] = 24;
+    seeds.push_back(tga);
+    uint32_t seed = 0x1234567;
+    auto next = [&] {
+        seed ^= seed << 13;
+        seed ^= seed >> 17;
+        seed ^= seed << 5;
+        return seed;
+    };
+    for (const std::vector<uint8_t>& original : seeds)
+    {
+        for (int i = 0; i < 3000; ++i)
+        {
+            std::vector<uint8_t> data = original;
+            for (uint32_t flips = next() % 4 + 1; flips--;)
+            {
+                size_t at = next() % 2 ? next() % std::min<size_t>(data.size(), 64) : next() % data.size();
+                data[at] ^= (uint8_t)(1u << (next() % 8));
+            }
+            if (next() % 4 == 0)
+                data.resize(next() % data.size());
+            DecodedImage d = decode(data);
+            CHECK(d.error != nullptr || d.rows == d.info.height);
+        }
+    }
+}
@@ -0,0 +1,28 @@
+// Runs Lua scripts against luibexwin, each on a fresh state. A script passes
+// when it returns without raising.
+//   luibexwin_luatests script.lua ...
+#include <cstdio>
+#include <lua.hpp>
+
+extern "C" int luaopen_luibexwin(lua_State* L);
+
+int main(int argc, char** argv)
+{
+    int failures = 0;
+    for (int i = 1; i < argc; ++i)
+    {
+        lua_State* L = luaL_newstate();
+        luaL_openlibs(L);
+        luaL_requiref(L, "luibexwin", luaopen_luibexwin, 0);
+        lua_pop(L, 1);
+        if (luaL_dofile(L, argv[i]) != LUA_OK)
+        {
+            fprintf(stderr, "FAIL %s: %s\n", argv[i], lua_tostring(L, -1));
+            ++failures;
+        }
+        else
+            printf("ok   %s\n", argv[i]);
+        lua_close(L);
+    }
+    return failures ? 1 : 0;
+}
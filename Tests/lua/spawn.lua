@@ -0,0 +1,42 @@
+-- SpawnProcess with an options table: the callbacks are kept next to the
+-- other options, and RunScheduler(true) returns once the child finished.
+local luibexwin = require"luibexwin"
+luibexwin.InjectGlobals()
+
+local output, exitCode = "", nil
+local proc = SpawnProcess("cmd.exe /c echo spawned& exit 3", {
+    onOutput = function(p, stream, chunk)
+        if stream == "stdout" then output = output .. chunk end
+    end,
+    onExit = function(p, code) exitCode = code end,
+})
+assert(proc, "SpawnProcess failed")
+RunScheduler(true)
+assert(exitCode == 3, "onExit did not run")
+assert(output:find("spawned"), "onOutput did not run")
+
+-- Every option at once, cwd included.
+local exited = false
+proc = SpawnProcess("cmd.exe /c cd", {
+    cwd = os.getenv("SystemRoot"),
+    capture = true,
+    onExit = function() exited = true end,
+})
+assert(proc, "SpawnProcess with cwd failed")
+RunScheduler(true)
+assert(exited, "onExit did not run with cwd set")
+assert(proc:stdout():lower():find(os.getenv("SystemRoot"):lower(), 1, true), "cwd was not applied")
+
+-- A failing callback is reported even without print, and the scheduler
+-- still delivers onExit.
+local savedPrint = print
+print = nil
+exited = false
+proc = SpawnProcess("cmd.exe /c echo x", {
+    onOutput = function() error("onOutput raised") end,
+    onExit = function() exited = true end,
+})
+assert(proc, "SpawnProcess failed")
+RunScheduler(true)
+print = savedPrint
+assert(exited, "onExit did not run after onOutput raised without print")
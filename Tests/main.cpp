@@ -0,0 +1,34 @@
+//   luibexwin_tests [suite ...]
+std::vector<TestCase>& testCases()
+{
+    static std::vector<TestCase> cases;
+    return cases;
+}
+static int failures = 0;
+void testFailed(const char* file, int line, const char* expression)
+{
+    fprintf(stderr, "%s:%d: CHECK(%s) failed\n", file, line, expression);
+    ++failures;
+}
+int main(int argc, char** argv)
+{
+    int run = 0;
+    for (const TestCase& t : testCases())
+    {
+        bool selected = argc < 2;
+        for (int i = 1; i < argc && !selected; ++i)
+            selected = strcmp(argv[i], t.suite) == 0;
+        if (!selected)
+            continue;
+        int before = failures;
+        t.run();
+        printf("%s %s.%s\n", failures == before ? "ok  " : "FAIL", t.suite, t.name);
+        ++run;
+    }
+    if (run == 0)
+    {
+        fprintf(stderr, "no tests selected\n");
+        return 2;
+    }
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,78 @@
+#pragma once
+// HandleWaitBackend fired by hand: fire(h) is what a pool thread does when h
+// is signaled, runWakes() the owner's alertable wait.
+struct MockHandleWaits : HandleWaitBackend
+{
+    // Held across fire, so disarm waits for a running callback like the pool.
+    std::recursive_mutex lock;
+    std::vector<HandleWait*> armed;
+    std::vector<std::shared_ptr<HandleWake>> wakes;
+    int owners = 0;
+    int duplicates = 0;
+    bool failDuplicate = false;
+
+    bool openOwner(HandleWaits* w) override
+    {
+        w->thread = (HANDLE)this;
+        ++owners;
+        return true;
+    }
+    void closeOwner(HandleWaits* w) override
+    {
+        w->thread = NULL;
+        --owners;
+    }
+    bool duplicate(HandleWait* e, HANDLE h) override
+    {
+        if (failDuplicate)
+            return false;
+        e->handle = h;
+        ++duplicates;
+        return true;
+    }
+    void closeDuplicate(HandleWait* e) override
+    {
+        e->handle = NULL;
+        --duplicates;
+    }
+    bool arm(HandleWait* e) override
+    {
+        std::lock_guard<std::recursive_mutex> guard(lock);
+        e->wait = (HANDLE)e;
+        armed.push_back(e);
+        return true;
+    }
+    void disarm(HandleWait* e) override
+    {
+        std::lock_guard<std::recursive_mutex> guard(lock);
+        std::erase(armed, e);
+    }
+    void queueWake(HandleWaits*, std::shared_ptr<HandleWake> wake) override
+    {
+        std::lock_guard<std::recursive_mutex> guard(lock);
+        wakes.push_back(std::move(wake));
+    }
+    // False when no armed wait watches h.
+    bool fire(HANDLE h, bool timedOut = false)
+    {
+        std::lock_guard<std::recursive_mutex> guard(lock);
+        auto it = std::find_if(armed.begin(), armed.end(), [h](HandleWait* e) { return e->handle == h; });
+        if (it == armed.end())
+            return false;
+        HandleWait* e = *it;
+        armed.erase(it);
+        handleWaitFired(e, timedOut);
+        return true;
+    }
+    size_t runWakes()
+    {
+        std::vector<std::shared_ptr<HandleWake>> queued;
+        {
+            std::lock_guard<std::recursive_mutex> guard(lock);
+            queued.swap(wakes);
+        }
+        for (const auto& wake : queued)
+            runHandleWake(wake);
+        return queued.size();
+    }
+};
@@ -0,0 +1,172 @@
+// A PE32+ image as the loader maps it: RVAs are offsets, no sections. The
+// export directory holds its tables, names and forwarder strings.
+struct MappedImage
+{
+    std::vector<uint8_t> bytes = std::vector<uint8_t>(0x1000);
+    void put16(size_t at, uint32_t v)
+    {
+        bytes[at] = (uint8_t)v;
+        bytes[at + 1] = (uint8_t)(v >> 8);
+    }
+    void put32(size_t at, uint32_t v)
+    {
+        put16(at, v & 0xFFFF);
+        put16(at + 2, v >> 16);
+    }
+    void putString(size_t at, const char* s)
+    {
+        memcpy(bytes.data() + at, s, strlen(s) + 1);
+    }
+    PeSource source() const
+    {
+        PeSource src;
+        src.read = [this](uint64_t offset, void* dst, size_t size) {
+            if (offset > bytes.size() || bytes.size() - offset < size)
+                return false;
+            memcpy(dst, bytes.data() + offset, size);
+            return true;
+        };
+        return src;
+    }
+};
+static MappedImage testImage()
+{
+    MappedImage m;
+    m.put16(0, 0x5A4D);
+    m.put32(0x3C, 0x40);
+    m.put32(0x40, 0x00004550);
+    m.put16(0x44 + 16, 240);
+    const size_t opt = 0x58;
+    m.put16(opt, 0x20B);
+    m.put32(opt + 24, 0x80000000);
+    m.put32(opt + 28, 0x1);
+    m.put32(opt + 56, (uint32_t)m.bytes.size());
+    m.put32(opt + 108, 16);
+    const uint32_t dir = 0x200, dirSize = 0x100;
+    m.put32(opt + 112, dir);
+    m.put32(opt + 116, dirSize);
+    // Ordinals 5..8, 6 is unused, 7 forwards.
+    m.put32(dir + 12, dir + 0x80);
+    m.put32(dir + 16, 5);
+    m.put32(dir + 20, 4);
+    m.put32(dir + 24, 3);
+    m.put32(dir + 28, dir + 0x28);
+    m.put32(dir + 32, dir + 0x38);
+    m.put32(dir + 36, dir + 0x44);
+    m.put32(dir + 0x28, 0x1000 - 0x20);
+    m.put32(dir + 0x2C, 0);
+    m.put32(dir + 0x30, dir + 0xB0);
+    m.put32(dir + 0x34, 0x1000 - 0x10);
+    m.put32(dir + 0x38, dir + 0x90);
+    m.put32(dir + 0x3C, dir + 0x98);
+    m.put32(dir + 0x40, dir + 0xA0);
+    m.put16(dir + 0x44, 0);
+    m.put16(dir + 0x46, 3);
+    m.put16(dir + 0x48, 2);
+    m.putString(dir + 0x80, "test.dll");
+    m.putString(dir + 0x90, "Alpha");
+    m.putString(dir + 0x98, "Beta");
+    m.putString(dir + 0xA0, "Fwd");
+    m.putString(dir + 0xB0, "KERNEL32.Sleep");
+    return m;
+}
+
+TEST(peexports, parses_mapped_image)
+{
+    MappedImage m = testImage();
+    PeExports pe;
+    CHECK(pe.parse(m.source()) == nullptr);
+    CHECK(pe.is64 && pe.imageBase == 0x180000000ull && pe.sizeOfImage == 0x1000);
+    CHECK(pe.moduleName == "test.dll");
+    CHECK(pe.exports.size() == 4 && pe.namedCount == 3 && pe.ordinalBase == 5);
+    const PeExport* alpha = pe.find("Alpha");
+    CHECK(alpha && alpha->rva == 0xFE0 && alpha->ordinal == 5);
+    const PeExport* beta = pe.find("Beta");
+    CHECK(beta && beta->rva == 0xFF0 && beta == pe.findOrdinal(8));
+    const PeExport* fwd = pe.find("Fwd");
+    CHECK(fwd && pe.string(fwd->forwarder) && strcmp(pe.string(fwd->forwarder), "KERNEL32.Sleep") == 0);
+    CHECK(pe.find("alpha") == nullptr && pe.find("Alph") == nullptr && pe.find("") == nullptr);
+    CHECK(pe.findOrdinal(6) == nullptr && pe.findOrdinal(4) == nullptr && pe.findOrdinal(9) == nullptr);
+}
+TEST(peexports, rejects_malformed_images)
+{
+    PeExports pe;
+    MappedImage m = testImage();
+    m.put16(0, 0x4D5A);
+    CHECK(pe.parse(m.source()) != nullptr);
+    m = testImage();
+    m.put32(0x40, 0x00004551);
+    CHECK(pe.parse(m.source()) != nullptr);
+    m = testImage();
+    m.put32(0x200 + 20, 1u << 24);
+    CHECK(pe.parse(m.source()) != nullptr);
+    // The directory reaching past SizeOfImage is never read.
+    m = testImage();
+    m.put32(0x58 + 116, 0x2000);
+    CHECK(pe.parse(m.source()) != nullptr);
+    CHECK(pe.find("Alpha") == nullptr);
+    m = testImage();
+    m.put32(0x58 + 116, 0xFFFFFF00);
+    CHECK(pe.parse(m.source()) != nullptr);
+}
+// On disk the directory must fit the raw data of its section.
+TEST(peexports, rejects_oversized_directory_in_file)
+{
+    FILE* file = fopen(LUIBEXWIN_TEST_FIXTURES "exports.dll", "rb");
+    CHECK(file != nullptr);
+    if (!file)
+        return;
+    MappedImage m;
+    m.bytes.resize(0x1000);
+    m.bytes.resize(fread(m.bytes.data(), 1, m.bytes.size(), file));
+    fclose(file);
+    PeSource src = m.source();
+    src.mapped = false;
+    PeExports pe;
+    CHECK(pe.parse(src) == nullptr && pe.find("Alias") != nullptr);
+    uint32_t nt = m.bytes[0x3C] | m.bytes[0x3D] << 8;
+    // PE32: the export entry follows the 96 bytes of optional header fields.
+    size_t exportSize = nt + 24 + 96 + 4;
+    m.put32(exportSize, 0x1000);
+    CHECK(pe.parse(src) != nullptr);
+    m.put32(exportSize, 0xFFFFFF00);
+    CHECK(pe.parse(src) != nullptr);
+    CHECK(pe.find("Alias") == nullptr);
+}
+TEST(peexports, no_export_directory)
+{
+    MappedImage m = testImage();
+    m.put32(0x58 + 112, 0);
+    PeExports pe;
+    CHECK(pe.parse(m.source()) == nullptr);
+    CHECK(pe.exports.empty() && pe.find("Alpha") == nullptr);
+}
+// fixtures/exports.dll is a PE32 file as it lies on disk: .text at RVA
+// 0x1000 and .edata at 0x2000, stored at file offsets 0x200 and 0x400.
+// Ordinal 1 is exported as both "Alias" and "First", "Second" names ordinal
+// 2 from a string in .text, ordinal 3 "Sleep" forwards to KERNEL32.Sleep.
+TEST(peexports, parses_file_with_aliases)
+{
+    FILE* file = fopen(LUIBEXWIN_TEST_FIXTURES "exports.dll", "rb");
+    CHECK(file != nullptr);
+    if (!file)
+        return;
+    PeExports pe;
+    const char* error = pe.parse(peFileSource(file));
+    fclose(file);
+    CHECK(error == nullptr);
+    CHECK(!pe.is64 && pe.imageBase == 0x10000000 && pe.sizeOfImage == 0x3000);
+    CHECK(pe.moduleName == "fixture.dll");
+    CHECK(pe.exports.size() == 3 && pe.namedCount == 4 && pe.names.size() == 4);
+    const PeExport* alias = pe.find("Alias");
+    CHECK(alias && alias == pe.find("First") && alias == pe.findOrdinal(1) && alias->rva == 0x1000);
+    const PeExport* second = pe.find("Second");
+    CHECK(second && second->ordinal == 2 && second->rva == 0x1010);
+    const PeExport* sleep = pe.find("Sleep");
+    CHECK(sleep && pe.string(sleep->forwarder) && strcmp(pe.string(sleep->forwarder), "KERNEL32.Sleep") == 0);
+    std::vector<std::string> names;
+    for (const PeName& n : pe.names)
+        names.push_back(pe.string(n.name));
+    CHECK(names == std::vector<std::string>({ "Alias", "First", "Second", "Sleep" }));
+    CHECK(pe.names[1].index == 0 && pe.names[3].index == 2);
+}
@@ -0,0 +1,86 @@
+// Noise kept away from the searched colors, with marks placed by the tests.
+struct SearchFrame
+{
+    std::vector<uint32_t> pixels;
+    PixelView view;
+    SearchFrame(int width, int height) : pixels((size_t)width * height)
+    {
+        view = { pixels.data(), width, height, width };
+        uint32_t seed = 0x9E3779B9;
+        for (uint32_t& p : pixels)
+        {
+            seed ^= seed << 13;
+            seed ^= seed >> 17;
+            seed ^= seed << 5;
+            p = 0xFF000000 | (seed & 0x007F7F7F);
+        }
+    }
+    void set(int x, int y, uint32_t color) { pixels[(size_t)y * view.width + x] = color; }
+};
+
+TEST(pixelsearch, first_match_in_row_order)
+{
+    SearchFrame f(300, 200);
+    f.set(250, 150, 0xFFFFFFFF);
+    f.set(10, 151, 0xFFFFFFFF);
+    f.set(120, 150, 0xFFFFFFFF);
+    PixelRect all{ 0, 0, 300, 200 };
+    for (int threads : { 1, 2, 7, 64, 1000 })
+    {
+        PixelMatch m{ -1, -1 };
+        CHECK(pixelFindColor(f.view, all, 0xFFFFFFFF, pixelTolerance(0), threads, &m));
+        CHECK(m.x == 120 && m.y == 150);
+    }
+    PixelMatch m;
+    CHECK(!pixelFindColor(f.view, { 0, 0, 300, 150 }, 0xFFFFFFFF, pixelTolerance(0), 4, &m));
+    CHECK(pixelFindColor(f.view, { 0, 0, 300, 200 }, 0xFFF0F0F0, pixelTolerance(15), 4, &m) && m.x == 120);
+    CHECK(!pixelFindColor(f.view, { 0, 0, 0, 200 }, 0xFFFFFFFF, pixelTolerance(0), 4, &m));
+}
+TEST(pixelsearch, find_all_stops_at_limit)
+{
+    SearchFrame f(40, 10);
+    for (int x = 0; x < 40; x += 4)
+        f.set(x, 3, 0xFFFFFFFF);
+    std::vector<PixelMatch> out;
+    CHECK(pixelFindAllColors(f.view, { 0, 0, 40, 10 }, 0xFFFFFFFF, pixelTolerance(0), 100, out) == 10);
+    CHECK(out.size() == 10 && out[9].x == 36 && out[9].y == 3);
+    out.clear();
+    CHECK(pixelFindAllColors(f.view, { 0, 0, 40, 10 }, 0xFFFFFFFF, pixelTolerance(0), 3, out) == 3);
+}
+TEST(pixelsearch, find_image)
+{
+    SearchFrame f(200, 120), image(8, 6);
+    for (int y = 0; y < 6; ++y)
+        for (int x = 0; x < 8; ++x)
+            image.set(x, y, 0xFF800000 | (uint32_t)(x * 16) << 8 | (uint32_t)(y * 16));
+    pixelCopyRect(f.view, 150, 100, image.view, { 0, 0, 8, 6 });
+    // A decoy that only shares the first row.
+    pixelCopyRect(f.view, 20, 30, image.view, { 0, 0, 8, 1 });
+    for (int threads : { 1, 3, 16 })
+    {
+        PixelMatch m{ -1, -1 };
+        CHECK(pixelFindImage(f.view, { 0, 0, 200, 120 }, image.view, pixelTolerance(0), threads, &m));
+        CHECK(m.x == 150 && m.y == 100);
+    }
+    PixelMatch m;
+    CHECK(!pixelFindImage(f.view, { 0, 0, 157, 120 }, image.view, pixelTolerance(0), 4, &m));
+}
+TEST(pixelsearch, concurrent_searches_share_the_pool)
+{
+    SearchFrame f(256, 256);
+    f.set(200, 250, 0xFFFFFFFF);
+    std::atomic<int> wrong{ 0 };
+    std::vector<std::thread> callers;
+    for (int t = 0; t < 4; ++t)
+        callers.emplace_back([&] {
+            for (int i = 0; i < 50; ++i)
+            {
+                PixelMatch m{ -1, -1 };
+                if (!pixelFindColor(f.view, { 0, 0, 256, 256 }, 0xFFFFFFFF, pixelTolerance(0), 8, &m) || m.x != 200 || m.y != 250)
+                    ++wrong;
+            }
+        });
+    for (std::thread& t : callers)
+        t.join();
+    CHECK(wrong == 0);
+}
@@ -0,0 +1,92 @@
+// The headless half of pixel buffers: what the Lua methods do once their
+// arguments are converted, without a DIB or a Lua state.
+struct Canvas
+{
+    std::vector<uint32_t> pixels;
+    PixelView view;
+    Canvas(int width, int height, uint32_t fill = 0) : pixels((size_t)width * height, fill)
+    {
+        view = { pixels.data(), width, height, width };
+    }
+    size_t count(uint32_t color) const { return (size_t)std::count(pixels.begin(), pixels.end(), color); }
+};
+
+TEST(pixelview, clip_rect_without_overflow)
+{
+    Canvas c(100, 50);
+    PixelRect r{ INT_MIN, INT_MIN, INT_MAX, INT_MAX };
+    CHECK(!pixelClipRect(c.view, r));
+    r = { INT_MAX - 10, 0, INT_MAX, 10 };
+    CHECK(!pixelClipRect(c.view, r));
+    r = { 90, 40, INT_MAX, INT_MAX };
+    CHECK(pixelClipRect(c.view, r) && r.x == 90 && r.y == 40 && r.w == 10 && r.h == 10);
+    r = { -INT_MAX / 2 - 5, -3, INT_MAX, 60 };
+    CHECK(pixelClipRect(c.view, r) && r.x == 0 && r.y == 0 && r.w == 100 && r.h == 50);
+    r = { 10, 10, -5, 5 };
+    CHECK(!pixelClipRect(c.view, r));
+}
+TEST(pixelview, script_rects_saturate)
+{
+    // What pb:fillRect(-2e9, -2e9, 4e9, 4e9, c) and friends pass on.
+    PixelRect r = pixelRect(-2000000000, -2000000000, 4000000000, 4000000000);
+    CHECK(r.x == -PIXEL_COORD_LIMIT && r.w == 2 * PIXEL_COORD_LIMIT);
+    Canvas c(64, 32);
+    pixelFillRect(c.view, r, 0xFFFFFFFF);
+    CHECK(c.count(0xFFFFFFFF) == c.pixels.size());
+    r = pixelRect(INT64_MAX, 0, INT64_MAX, 10);
+    CHECK(r.x == PIXEL_COORD_LIMIT && r.w == 0);
+    // Ends at -1, left of any view.
+    r = pixelRect(INT64_MIN, INT64_MIN, INT64_MAX, INT64_MAX);
+    CHECK(r.x == -PIXEL_COORD_LIMIT && r.x + r.w <= 0 && !pixelClipRect(c.view, r));
+    // Truncating 2^32 + 3 to int would have made this a 3 pixel wide rect.
+    r = pixelRect(0, 0, ((int64_t)1 << 32) + 3, 1);
+    CHECK(r.w == PIXEL_COORD_LIMIT);
+    CHECK(pixelCoord(-((int64_t)1 << 40)) == -PIXEL_COORD_LIMIT && pixelCoord(7) == 7);
+}
+TEST(pixelview, clip_copy_extremes)
+{
+    Canvas src(16, 16, 0xFF00FF00), dst(16, 16);
+    int dx = INT_MAX, dy = 0;
+    PixelRect sr{ 0, 0, 16, 16 };
+    CHECK(!pixelClipCopy(dst.view, dx, dy, src.view, sr));
+    dx = INT_MIN + 1;
+    dy = 0;
+    sr = { 0, 0, INT_MAX, 16 };
+    CHECK(!pixelClipCopy(dst.view, dx, dy, src.view, sr));
+    dx = 0;
+    dy = 0;
+    sr = { INT_MIN, INT_MIN, INT_MAX, INT_MAX };
+    CHECK(!pixelClipCopy(dst.view, dx, dy, src.view, sr));
+    // A source rect starting left of src shifts the destination right.
+    dx = 0;
+    dy = 0;
+    sr = { -4, 0, INT_MAX, 2 };
+    CHECK(pixelClipCopy(dst.view, dx, dy, src.view, sr));
+    CHECK(dx == 4 && sr.x == 0 && sr.w == 12 && sr.h == 2);
+    pixelCopyRect(dst.view, pixelCoord(-((int64_t)1 << 33)), 0, src.view, { 0, 0, 16, 16 });
+    CHECK(dst.count(0) == dst.pixels.size());
+    pixelCopyRect(dst.view, 0, 0, src.view, pixelRect(-8, -8, (int64_t)1 << 40, (int64_t)1 << 40));
+    CHECK(dst.count(0xFF00FF00) == 8 * 8 && dst.pixels[8 * 16 + 8] == 0xFF00FF00);
+}
+TEST(pixelview, operations_accept_any_rect)
+{
+    Canvas c(20, 20, 0xFF102030);
+    const PixelRect rects[] = {
+        { INT_MIN, INT_MIN, INT_MAX, INT_MAX },
+        { INT_MAX, INT_MAX, INT_MAX, INT_MAX },
+        { -PIXEL_COORD_LIMIT, -PIXEL_COORD_LIMIT, 2 * PIXEL_COORD_LIMIT, 2 * PIXEL_COORD_LIMIT },
+        { 5, 5, 0, 0 },
+        { 19, 19, -100, -100 },
+    };
+    for (const PixelRect& r : rects)
+    {
+        pixelBlendRect(c.view, r, 0x80FFFFFF);
+        pixelSwizzleRect(c.view, r);
+        pixelPremultiplyRect(c.view, r);
+        pixelScaleRect(c.view, r, c.view, { 0, 0, 20, 20 }, false);
+        pixelScaleRect(c.view, { 0, 0, 20, 20 }, c.view, r, true);
+    }
+    Canvas big(20, 20);
+    pixelScaleRect(big.view, { -PIXEL_COORD_LIMIT, 0, 2 * PIXEL_COORD_LIMIT, 20 }, c.view, { 0, 0, 20, 20 }, true);
+    CHECK(big.count(0) == 0);
+}
@@ -0,0 +1,171 @@
+struct TestImage
+{
+    std::vector<uint32_t> pixels;
+    PixelView view;
+    TestImage(int width, int height, uint32_t seed = 0, uint32_t fill = 0) : pixels((size_t)width * height, fill)
+    {
+        view = { pixels.data(), width, height, width };
+        for (uint32_t& p : pixels)
+        {
+            if (!seed)
+                break;
+            seed ^= seed << 13;
+            seed ^= seed >> 17;
+            seed ^= seed << 5;
+            p = seed;
+        }
+    }
+    uint32_t at(int x, int y) const { return view.row(y)[x]; }
+};
+// Every level the build and CPU support computes what the scalar kernels do.
+template<typename Run>
+static void checkLevelsAgree(Run run)
+{
+    RasterLevel active = rasterActiveLevel();
+    rasterSetLevel(RASTER_SCALAR);
+    std::vector<uint32_t> expected = run();
+    for (int level = RASTER_SCALAR + 1; level <= rasterSupportedLevel(); ++level)
+    {
+        rasterSetLevel((RasterLevel)level);
+        CHECK(run() == expected);
+    }
+    rasterSetLevel(active);
+}
+
+TEST(raster, fill_is_clipped)
+{
+    TestImage img(8, 6);
+    pixelFillRect(img.view, { -3, 4, 5, 10 }, 0xFF112233);
+    for (int y = 0; y < 6; ++y)
+        for (int x = 0; x < 8; ++x)
+            CHECK(img.at(x, y) == (x < 2 && y >= 4 ? 0xFF112233u : 0u));
+    pixelFillRect(img.view, { 8, 0, 4, 4 }, 0xFFFFFFFF);
+    pixelFillRect(img.view, { 0, 0, -1, 4 }, 0xFFFFFFFF);
+    CHECK(std::count(img.pixels.begin(), img.pixels.end(), 0xFFFFFFFFu) == 0);
+}
+TEST(raster, blend_over_opaque)
+{
+    TestImage img(4, 4, 0, 0xFF0000FF);
+    pixelBlendRect(img.view, { 1, 1, 2, 2 }, 0x80FF0000);
+    CHECK(img.at(1, 1) == 0xFF80007F);
+    CHECK(img.at(0, 0) == 0xFF0000FF);
+    // Transparent colors leave the buffer alone, opaque ones fill.
+    pixelBlendRect(img.view, { 0, 0, 4, 4 }, 0x00FFFFFF);
+    CHECK(img.at(0, 0) == 0xFF0000FF);
+    pixelBlendRect(img.view, { 0, 0, 4, 4 }, 0xFF00FF00);
+    CHECK(img.at(2, 2) == 0xFF00FF00);
+}
+TEST(raster, copy_handles_overlap)
+{
+    TestImage img(16, 16, 7);
+    std::vector<uint32_t> before = img.pixels;
+    pixelCopyRect(img.view, 3, 2, img.view, { 0, 0, 10, 10 });
+    for (int y = 0; y < 10; ++y)
+        for (int x = 0; x < 10; ++x)
+            CHECK(img.at(x + 3, y + 2) == before[(size_t)y * 16 + x]);
+    // Negative destinations move the source origin instead.
+    TestImage dst(4, 4);
+    pixelCopyRect(dst.view, -2, -1, img.view, { 0, 0, 4, 4 });
+    CHECK(dst.at(0, 0) == img.at(2, 1) && dst.at(1, 2) == img.at(3, 3) && dst.at(2, 0) == 0);
+}
+TEST(raster, color_key_and_swizzle)
+{
+    TestImage src(4, 1), dst(4, 1, 0, 0xFF000000);
+    src.pixels = { 0x00FF00FF, 0xFF123456, 0x80FF00FF, 0xFFABCDEF };
+    src.view.pixels = src.pixels.data();
+    pixelColorKeyRect(dst.view, 0, 0, src.view, { 0, 0, 4, 1 }, 0xFFFF00FF);
+    CHECK(dst.pixels == std::vector<uint32_t>({ 0xFF000000, 0xFF123456, 0xFF000000, 0xFFABCDEF }));
+    pixelSwizzleRect(dst.view, { 0, 0, 4, 1 });
+    CHECK(dst.at(1, 0) == 0xFF563412);
+}
+TEST(raster, premultiply_rounds)
+{
+    TestImage img(3, 1);
+    img.pixels = { 0x80FFFFFF, 0x00FFFFFF, 0xFF102030 };
+    img.view.pixels = img.pixels.data();
+    pixelPremultiplyRect(img.view, { 0, 0, 3, 1 });
+    CHECK(img.pixels == std::vector<uint32_t>({ 0x80808080, 0x00000000, 0xFF102030 }));
+}
+TEST(raster, nearest_scale_doubles)
+{
+    TestImage src(2, 2), dst(4, 4);
+    src.pixels = { 1, 2, 3, 4 };
+    src.view.pixels = src.pixels.data();
+    pixelScaleRect(dst.view, { 0, 0, 4, 4 }, src.view, { 0, 0, 2, 2 }, false);
+    CHECK(dst.pixels == std::vector<uint32_t>({ 1, 1, 2, 2, 1, 1, 2, 2, 3, 3, 4, 4, 3, 3, 4, 4 }));
+}
+// Source columns past 32767 do not fit 16.16 in 32 bits.
+TEST(raster, scale_wide_source)
+{
+    TestImage src(40000, 2, 0, 0xFFFF0000);
+    for (int y = 0; y < 2; ++y)
+        for (int x = 32768; x < 40000; ++x)
+            src.view.row(y)[x] = 0xFF000000 | (uint32_t)x;
+    TestImage dst(100, 2);
+    pixelScaleRect(dst.view, { 0, 0, 100, 2 }, src.view, { 33000, 0, 4000, 2 }, false);
+    for (int i = 0; i < 100; ++i)
+        CHECK(dst.at(i, 0) == (0xFF000000 | (uint32_t)(33000 + i * 40 + 20)));
+    checkLevelsAgree([&] { TestImage d(100, 2); pixelScaleRect(d.view, { 0, 0, 100, 2 }, src.view, { 33000, 0, 4000, 2 }, true); return d.pixels; });
+    TestImage row(100, 2);
+    pixelScaleRect(row.view, { 0, 0, 100, 2 }, src.view, { 33000, 0, 4000, 2 }, true);
+    for (int i = 0; i < 100; ++i)
+        CHECK((row.at(i, 1) >> 24) == 0xFF && (row.at(i, 1) & 0xFF0000) == 0);
+}
+TEST(raster, line_endpoints)
+{
+    TestImage img(10, 10);
+    pixelDrawLine(img.view, 1, 1, 8, 5, 0xFFFFFFFF);
+    CHECK(img.at(1, 1) == 0xFFFFFFFF && img.at(8, 5) == 0xFFFFFFFF);
+    CHECK(std::count(img.pixels.begin(), img.pixels.end(), 0xFFFFFFFFu) == 8);
+    TestImage outside(10, 10);
+    pixelDrawLine(outside.view, -5, -5, -1, 20, 0xFFFFFFFF);
+    CHECK(std::count(outside.pixels.begin(), outside.pixels.end(), 0u) == 100);
+}
+TEST(raster, diff_tiles)
+{
+    TestImage a(40, 20, 3), b(40, 20, 3);
+    std::vector<uint8_t> mask(3 * 2);
+    CHECK(pixelDiffTiles(a.view, b.view, 16, mask.data()) == 0);
+    b.pixels[(size_t)17 * 40 + 33] ^= 1;
+    CHECK(pixelDiffTiles(a.view, b.view, 16, mask.data()) == 1);
+    CHECK(mask == std::vector<uint8_t>({ 0, 0, 0, 0, 0, 1 }));
+}
+TEST(raster, levels_agree)
+{
+    TestImage src(37, 13, 11);
+    auto fresh = [] { return TestImage(37, 13, 5); };
+    checkLevelsAgree([&] { TestImage d = fresh(); pixelBlendRect(d.view, { 1, 1, 35, 11 }, 0x7F20C040); return d.pixels; });
+    checkLevelsAgree([&] { TestImage d = fresh(); pixelCompositeRect(d.view, 0, 0, src.view, { 0, 0, 37, 13 }); return d.pixels; });
+    checkLevelsAgree([&] { TestImage d = fresh(); pixelSwizzleRect(d.view, { 0, 0, 37, 13 }); return d.pixels; });
+    checkLevelsAgree([&] { TestImage d = fresh(); pixelPremultiplyRect(d.view, { 0, 0, 37, 13 }); return d.pixels; });
+    checkLevelsAgree([&] { TestImage d(80, 30); pixelScaleRect(d.view, { 0, 0, 80, 30 }, src.view, { 0, 0, 37, 13 }, true); return d.pixels; });
+    checkLevelsAgree([&] {
+        const RasterKernels& k = rasterKernels();
+        std::vector<uint32_t> hits;
+        for (uint32_t tol : { 0u, 0xFF101010u, 0xFF808080u })
+            hits.push_back((uint32_t)k.findColor(src.pixels.data(), 37 * 13, 0xFF808080, tol));
+        return hits;
+    });
+}
+TEST(raster, line_is_clipped_first)
+{
+    // pb:line(-2e9, 5, 2e9, 5, c) used to walk four billion pixels.
+    TestImage img(10, 10);
+    pixelDrawLine(img.view, -2000000000, 5, 2000000000, 5, 0xFFFFFFFF);
+    for (int x = 0; x < 10; ++x)
+        CHECK(img.at(x, 5) == 0xFFFFFFFF);
+    CHECK(std::count(img.pixels.begin(), img.pixels.end(), 0xFFFFFFFFu) == 10);
+    TestImage diagonal(10, 10);
+    pixelDrawLine(diagonal.view, INT64_MIN + 1, INT64_MIN + 1, INT64_MAX, INT64_MAX, 0xFFFFFFFF);
+    for (int i = 0; i < 10; ++i)
+        CHECK(diagonal.at(i, i) == 0xFFFFFFFF);
+    CHECK(std::count(diagonal.pixels.begin(), diagonal.pixels.end(), 0xFFFFFFFFu) == 10);
+    // Clipped ends land on the line: (-4, -2)..(16, 8) crosses (0, 0) and (8, 4).
+    TestImage slope(9, 9);
+    pixelDrawLine(slope.view, -4, -2, 16, 8, 0xFFFFFFFF);
+    CHECK(slope.at(0, 0) == 0xFFFFFFFF && slope.at(8, 4) == 0xFFFFFFFF);
+    CHECK(std::count(slope.pixels.begin(), slope.pixels.end(), 0xFFFFFFFFu) == 9);
+    TestImage miss(10, 10);
+    pixelDrawLine(miss.view, -100, 50, 50, -101, 0xFFFFFFFF);
+    CHECK(std::count(miss.pixels.begin(), miss.pixels.end(), 0u) == 100);
+}
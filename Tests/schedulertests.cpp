@@ -0,0 +1,136 @@
+// SchedulerWaits on a manual clock and the mock handle backend.
+static uint64_t manualNow = 1000;
+static uint64_t manualClock()
+{
+    return manualNow;
+}
+struct SchedulerFixture
+{
+    MockHandleWaits backend;
+    TimerWheel timers{ manualClock };
+    HandleWaits handles;
+    SchedulerWaits waits{ timers, handles, &backend };
+};
+static std::vector<int> refsOf(const std::vector<SchedulerWake>& wakes)
+{
+    std::vector<int> refs;
+    for (const SchedulerWake& w : wakes)
+        refs.push_back(w.ref);
+    return refs;
+}
+
+TEST(scheduler, timeouts_wake_in_deadline_order)
+{
+    SchedulerFixture f;
+    f.waits.addTimeout(1, 30);
+    f.waits.addTimeout(2, 10);
+    f.waits.addTimeout(3, -5);
+    std::vector<SchedulerWake> wakes;
+    f.waits.takeExpired(wakes);
+    CHECK(refsOf(wakes) == std::vector<int>{ 3 });
+    manualNow += 10;
+    wakes.clear();
+    f.waits.takeExpired(wakes);
+    CHECK(refsOf(wakes) == std::vector<int>{ 2 });
+    CHECK(!wakes[0].handle);
+    manualNow += 20;
+    wakes.clear();
+    f.waits.takeExpired(wakes);
+    CHECK(refsOf(wakes) == std::vector<int>{ 1 });
+    CHECK(f.waits.empty() && f.timers.size() == 0);
+}
+TEST(scheduler, removing_cancels_the_deadline)
+{
+    SchedulerFixture f;
+    f.waits.addTimeout(1, 10);
+    f.waits.remove(1);
+    CHECK(f.waits.empty() && f.timers.size() == 0);
+    manualNow += 20;
+    std::vector<SchedulerWake> wakes;
+    f.waits.takeExpired(wakes);
+    CHECK(wakes.empty());
+}
+TEST(scheduler, handle_waiters_share_one_registration)
+{
+    SchedulerFixture f;
+    HANDLE h = (HANDLE)0x10;
+    CHECK(f.waits.addHandle(1, h, -1));
+    CHECK(f.waits.addHandle(2, h, -1));
+    CHECK(f.backend.duplicates == 1 && f.backend.armed.size() == 1);
+    CHECK(f.backend.fire(h));
+    std::vector<SchedulerWake> wakes;
+    f.waits.takeFiredHandles(wakes);
+    CHECK(refsOf(wakes) == (std::vector<int>{ 1, 2 }));
+    for (const SchedulerWake& w : wakes)
+        CHECK(w.handle && w.signaled);
+    CHECK(f.waits.empty() && f.backend.duplicates == 0);
+}
+TEST(scheduler, handle_deadline_wakes_only_its_waiter)
+{
+    SchedulerFixture f;
+    HANDLE h = (HANDLE)0x10;
+    CHECK(f.waits.addHandle(1, h, 50));
+    CHECK(f.waits.addHandle(2, h, -1));
+    manualNow += 50;
+    std::vector<SchedulerWake> wakes;
+    f.waits.takeExpired(wakes);
+    CHECK(wakes.size() == 1 && wakes[0].ref == 1 && wakes[0].handle && !wakes[0].signaled);
+    CHECK(f.backend.duplicates == 1);
+    f.waits.remove(2);
+    CHECK(f.waits.empty() && f.backend.duplicates == 0);
+    CHECK(!f.backend.fire(h));
+}
+TEST(scheduler, handle_that_cannot_be_waited_on_adds_nothing)
+{
+    SchedulerFixture f;
+    f.backend.failDuplicate = true;
+    CHECK(!f.waits.addHandle(1, (HANDLE)0x10, 100));
+    CHECK(f.waits.empty() && f.timers.size() == 0);
+}
+TEST(scheduler, messages_match_window_and_range)
+{
+    SchedulerFixture f;
+    void* a = (void*)0xA;
+    void* b = (void*)0xB;
+    f.waits.addMessage(1, a, 0, 0);
+    f.waits.addMessage(2, b, 0x100, 0x102);
+    f.waits.addMessage(3, nullptr, 0x200, 0x200);
+    std::vector<int> woken;
+    f.waits.takeMessageWaiters(b, 0x103, woken);
+    CHECK(woken.empty());
+    f.waits.takeMessageWaiters(b, 0x101, woken);
+    CHECK(woken == std::vector<int>{ 2 });
+    woken.clear();
+    f.waits.takeMessageWaiters(a, 0x200, woken);
+    CHECK(woken == (std::vector<int>{ 1, 3 }));
+    CHECK(f.waits.empty());
+}
+TEST(scheduler, completions_wake_each_waiter_once)
+{
+    SchedulerFixture f;
+    f.waits.addCompletion(1, 7);
+    f.waits.addCompletion(2, 7);
+    f.waits.addCompletion(3, 8);
+    std::vector<int> woken;
+    f.waits.takeCompletionWaiters(7, woken);
+    CHECK(woken == (std::vector<int>{ 1, 2 }));
+    woken.clear();
+    f.waits.takeCompletionWaiters(7, woken);
+    CHECK(woken.empty());
+    CHECK(f.waits.size() == 1);
+    f.waits.remove(3);
+    CHECK(f.waits.empty());
+}
+TEST(scheduler, destruction_closes_registrations)
+{
+    MockHandleWaits backend;
+    {
+        TimerWheel timers{ manualClock };
+        HandleWaits handles;
+        SchedulerWaits waits{ timers, handles, &backend };
+        CHECK(waits.addHandle(1, (HANDLE)0x10, -1));
+        CHECK(waits.addHandle(2, (HANDLE)0x20, 10));
+        CHECK(backend.owners == 1 && backend.duplicates == 2);
+    }
+    CHECK(backend.owners == 0 && backend.duplicates == 0 && backend.armed.empty());
+}
@@ -0,0 +1,24 @@
+#pragma once
+// Test registry of luibexwin_tests. TEST(suite, name) bodies run when the
+// suite is named on the command line, or always without arguments; CHECK
+// records a failure and carries on.
+struct TestCase
+{
+    const char* suite;
+    const char* name;
+    void (*run)();
+};
+std::vector<TestCase>& testCases();
+struct TestRegistration
+{
+    TestRegistration(const char* suite, const char* name, void (*run)())
+    {
+        testCases().push_back({ suite, name, run });
+    }
+};
+void testFailed(const char* file, int line, const char* expression);
+#define TEST(suite, name) \
+    static void suite##_##name(); \
+    static TestRegistration suite##_##name##_registration(#suite, #name, suite##_##name); \
+    static void suite##_##name()
+#define CHECK(condition) ((condition) ? (void)0 : testFailed(__FILE__, __LINE__, #condition))
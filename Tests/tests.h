@@ -0,0 +1,49 @@
+#pragma once
+// Precompiled header of luibexwin_tests, the counterpart of luibexwin.h for
+// the parts that build without Lua or Win32.
+#include <vector>
+#include <unordered_map>
+#include <array>
+#include <algorithm>
+#include <memory>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <functional>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <chrono>
+#include <bit>
+#include <climits>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <cstring>
+// cpuid and the SSE2/AVX2 kernels of rasterkernels.cpp.
+#ifdef _MSC_VER
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+// constants.h only names these.
+struct lua_State;
+typedef long long lua_Integer;
+// Handles are opaque to handlewaits.h and schedulerwaits.h, the tests give
+// them a mock backend.
+typedef void* HANDLE;
+typedef unsigned long DWORD;
+#define INFINITE 0xFFFFFFFF
+#include "constants.h"
+#include "timerwheel.h"
+#include "handlewaits.h"
+#include "schedulerwaits.h"
+#include "mockhandlewaits.h"
+#include "pixelview.h"
+#include "rasterkernels.h"
+#include "pixelsearch.h"
+#include "imagecodec.h"
+#include "peexports.h"
+#include "testing.h"
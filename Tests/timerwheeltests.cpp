@@ -0,0 +1,90 @@
+// add() reads the clock itself, so each expiry is only known to lie between
+// the clock read before and after the call.
+struct Added
+{
+    uint64_t id;
+    uint64_t earliest;
+    uint64_t latest;
+};
+static Added addTimer(TimerWheel& wheel, uint64_t delay, uint64_t period = 0, int64_t cookie = 0)
+{
+    uint64_t before = TimerWheel::now();
+    uint64_t id = wheel.add(delay, period, cookie);
+    return { id, before + delay, TimerWheel::now() + delay };
+}
+
+TEST(timerwheel, fires_once_at_expiry)
+{
+    TimerWheel wheel;
+    Added t = addTimer(wheel, 25, 0, 42);
+    std::vector<TimerWheel::Expired> fired;
+    CHECK(wheel.advance(t.earliest - 1, fired) == 0);
+    CHECK(wheel.advance(t.latest, fired) == 1);
+    CHECK(fired.size() == 1 && fired[0].id == t.id && fired[0].cookie == 42);
+    CHECK(wheel.size() == 0);
+    CHECK(wheel.advance(t.latest + 1000, fired) == 0);
+}
+TEST(timerwheel, cascades_from_higher_levels)
+{
+    for (uint64_t delay : { 63ull, 64ull, 4095ull, 4096ull, 300000ull, 20000000ull })
+    {
+        TimerWheel wheel;
+        Added t = addTimer(wheel, delay);
+        std::vector<TimerWheel::Expired> fired;
+        CHECK(wheel.nextExpiry() <= t.latest);
+        CHECK(wheel.advance(t.earliest - 1, fired) == 0);
+        CHECK(wheel.advance(t.latest, fired) == 1);
+    }
+}
+TEST(timerwheel, fires_in_expiry_order)
+{
+    TimerWheel wheel;
+    const uint64_t delays[] = { 700, 5, 90, 5000, 64, 1, 4100, 65 };
+    uint64_t last = 0;
+    for (int64_t i = 0; i < 8; ++i)
+        last = std::max(last, addTimer(wheel, delays[i], 0, i).latest);
+    std::vector<TimerWheel::Expired> fired;
+    CHECK(wheel.advance(last, fired) == 8);
+    for (size_t i = 1; i < fired.size(); ++i)
+        CHECK(delays[fired[i - 1].cookie] <= delays[fired[i].cookie]);
+}
+TEST(timerwheel, cancel_and_stale_ids)
+{
+    TimerWheel wheel;
+    Added a = addTimer(wheel, 10);
+    CHECK(wheel.cancel(a.id));
+    CHECK(!wheel.cancel(a.id));
+    // The node is reused with a new generation.
+    Added b = addTimer(wheel, 10);
+    CHECK((uint32_t)b.id == (uint32_t)a.id && b.id != a.id);
+    CHECK(!wheel.cancel(a.id));
+    std::vector<TimerWheel::Expired> fired;
+    CHECK(wheel.advance(b.latest, fired) == 1 && fired[0].id == b.id);
+    CHECK(!wheel.cancel(b.id));
+    CHECK(!wheel.cancel(12345));
+}
+TEST(timerwheel, periodic_timers_repeat)
+{
+    TimerWheel wheel;
+    Added t = addTimer(wheel, 10, 10);
+    std::vector<TimerWheel::Expired> fired;
+    wheel.advance(t.earliest + 95, fired);
+    CHECK(fired.size() >= 9 && fired.size() <= 10);
+    CHECK(wheel.size() == 1);
+    CHECK(wheel.cancel(t.id));
+    fired.clear();
+    CHECK(wheel.advance(t.latest + 1000, fired) == 0);
+}
+TEST(timerwheel, next_expiry)
+{
+    TimerWheel wheel;
+    CHECK(wheel.nextExpiry() == UINT64_MAX);
+    Added near = addTimer(wheel, 30);
+    addTimer(wheel, 100000);
+    uint64_t next = wheel.nextExpiry();
+    CHECK(next >= near.earliest && next <= near.latest);
+    std::vector<TimerWheel::Expired> fired;
+    wheel.advance(near.latest, fired);
+    // Past level 0 the next expiry is where the timer cascades, never later.
+    CHECK(wheel.nextExpiry() > near.latest && wheel.nextExpiry() <= near.latest + 100000);
+}
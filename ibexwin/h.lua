@@ -1,4 +1,5 @@
-require"luibexwin"
+local luibexwin = require"luibexwin"
+luibexwin.InjectGlobals()
 function CreateWindow(...)
     return CreateWindowEx(nil, ...)
 end
@@ -9,4 +10,5 @@ function GetModuleHandle(mod)
     return hmod
 end
 Sleep = SleepEx
-DrawText = DrawTextEx
\ No newline at end of file
+DrawText = DrawTextEx
+return luibexwin
\ No newline at end of file